@@ -1,11 +1,14 @@
 #include "mainwindow.h"
+#include "sceneview.h"
 #include "ui_mainwindow.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , sceneView(new SceneView(this))
 {
     ui->setupUi(this);
+    setCentralWidget(sceneView);
 }
 
 MainWindow::~MainWindow()
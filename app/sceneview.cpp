@@ -0,0 +1,421 @@
+#include "sceneview.h"
+
+#include "WallLevelOfDetail.h"
+
+#include <QColor>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPen>
+#include <QPolygonF>
+#include <QRegion>
+#include <QResizeEvent>
+#include <QVector>
+#include <QWheelEvent>
+#include <QtGlobal>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+namespace {
+
+constexpr int kMarkerRadius = 6;
+/** Above this many lines antialiasing costs more than it adds to a dense plan. */
+constexpr int kAntialiasLineLimit = 20000;
+constexpr double kMinimumPixelsPerMeter = 1e-3;
+constexpr double kMaximumPixelsPerMeter = 1e4;
+
+QPointF eventPosition(const QMouseEvent *event)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return event->position();
+#else
+    return event->localPos();
+#endif
+}
+
+QPointF eventPosition(const QWheelEvent *event)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    return event->position();
+#else
+    return event->posF();
+#endif
+}
+
+/**
+ * Maps 0 (weak) to 1 (strong) from blue through green and yellow to red.
+ */
+QRgb heatmapColor(double fraction)
+{
+    const double hue = (1.0 - std::clamp(fraction, 0.0, 1.0)) * (240.0 / 360.0);
+    const QColor color = QColor::fromHsvF(hue, 1.0, 1.0, 0.65);
+    return qPremultiply(color.rgba());
+}
+
+} // namespace
+
+SceneView::SceneView(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setMinimumSize(200, 150);
+}
+
+void SceneView::setWalls(std::vector<rfmodel::engine::WallSegment> walls)
+{
+    walls_ = std::move(walls);
+    wallLayerDirty_ = true;
+    if (!fitted_) {
+        fitToScene();
+    }
+    update();
+}
+
+void SceneView::setHeatmap(const rfmodel::engine::CoverageRaster &raster, double minimumDb,
+                           double maximumDb)
+{
+    const rfmodel::engine::RasterGeometry &geometry = raster.Geometry();
+    const double span = maximumDb > minimumDb ? maximumDb - minimumDb : 1.0;
+    // Image line r holds raster row r; the Y-flipping view transform puts row 0 at the bottom.
+    heatmapImage_ = QImage(static_cast<int>(geometry.columns), static_cast<int>(geometry.rows),
+                           QImage::Format_ARGB32_Premultiplied);
+    for (std::size_t row = 0; row < geometry.rows; ++row) {
+        auto *line = reinterpret_cast<QRgb *>(heatmapImage_.scanLine(static_cast<int>(row)));
+        for (std::size_t column = 0; column < geometry.columns; ++column) {
+            const double value = raster.At(column, row);
+            line[column] = std::isnan(value) ? 0u : heatmapColor((value - minimumDb) / span);
+        }
+    }
+    heatmapBoundsMeters_ =
+        QRectF(geometry.originX, geometry.originY, geometry.Width(), geometry.Height());
+    heatmapLayerDirty_ = true;
+    if (!fitted_) {
+        fitToScene();
+    }
+    update();
+}
+
+void SceneView::clearHeatmap()
+{
+    heatmapImage_ = QImage();
+    heatmapBoundsMeters_ = QRectF();
+    heatmapLayerDirty_ = true;
+    update();
+}
+
+void SceneView::setTransmitters(std::vector<QPointF> positionsMeters)
+{
+    QRegion dirty;
+    for (const QPointF &position : transmitters_) {
+        dirty += markerRect(position);
+    }
+    transmitters_ = std::move(positionsMeters);
+    for (const QPointF &position : transmitters_) {
+        dirty += markerRect(position);
+    }
+    update(dirty);
+}
+
+void SceneView::setReceivers(std::vector<QPointF> positionsMeters)
+{
+    QRegion dirty;
+    for (const QPointF &position : receivers_) {
+        dirty += markerRect(position);
+    }
+    receivers_ = std::move(positionsMeters);
+    for (const QPointF &position : receivers_) {
+        dirty += markerRect(position);
+    }
+    if (draggedReceiver_ >= static_cast<int>(receivers_.size())) {
+        draggedReceiver_ = -1;
+    }
+    update(dirty);
+}
+
+void SceneView::setReceiverPosition(int index, const QPointF &positionMeters)
+{
+    if (index < 0 || index >= static_cast<int>(receivers_.size())) {
+        return;
+    }
+    QRegion dirty(markerRect(receivers_[index]));
+    receivers_[index] = positionMeters;
+    dirty += markerRect(positionMeters);
+    update(dirty);
+}
+
+void SceneView::fitToScene()
+{
+    if (width() <= 0 || height() <= 0) {
+        return;
+    }
+    double minX = std::numeric_limits<double>::infinity();
+    double minY = minX;
+    double maxX = -minX;
+    double maxY = -minX;
+    const auto include = [&](double x, double y) {
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    };
+    for (const rfmodel::engine::WallSegment &wall : walls_) {
+        include(wall.start.x, wall.start.y);
+        include(wall.end.x, wall.end.y);
+    }
+    if (!heatmapBoundsMeters_.isNull()) {
+        include(heatmapBoundsMeters_.left(), heatmapBoundsMeters_.top());
+        include(heatmapBoundsMeters_.right(), heatmapBoundsMeters_.bottom());
+    }
+    if (minX > maxX) {
+        return;
+    }
+    const double spanX = std::max(maxX - minX, 1.0);
+    const double spanY = std::max(maxY - minY, 1.0);
+    centerMeters_ = QPointF(0.5 * (minX + maxX), 0.5 * (minY + maxY));
+    pixelsPerMeter_ = std::clamp(0.9 * std::min(width() / spanX, height() / spanY),
+                                 kMinimumPixelsPerMeter, kMaximumPixelsPerMeter);
+    fitted_ = true;
+    invalidateLayers();
+    update();
+}
+
+void SceneView::paintEvent(QPaintEvent *event)
+{
+    if ((wallLayerDirty_ || heatmapLayerDirty_) && layerCenterMeters_ != centerMeters_) {
+        // Both layers must share one view; a partial rebuild mid-pan would misalign them.
+        invalidateLayers();
+    }
+    if (heatmapLayerDirty_) {
+        rebuildHeatmapLayer();
+    }
+    if (wallLayerDirty_) {
+        rebuildWallLayer();
+    }
+
+    QPainter painter(this);
+    const QRect dirty = event->rect();
+    painter.setClipRect(dirty);
+    painter.fillRect(dirty, palette().base());
+
+    // Blits of the cached layers; offset only while a pan is in progress.
+    const QPointF offset = toScreen(layerCenterMeters_) - toScreen(centerMeters_);
+    painter.drawPixmap(offset, heatmapLayer_);
+    painter.drawPixmap(offset, wallLayer_);
+
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setPen(QPen(palette().text().color(), 1.0));
+    painter.setBrush(QColor(220, 40, 40));
+    for (const QPointF &position : transmitters_) {
+        if (!markerRect(position).intersects(dirty)) {
+            continue;
+        }
+        const QPointF center = toScreen(position);
+        const QPolygonF triangle{center + QPointF(0.0, -kMarkerRadius),
+                                 center + QPointF(kMarkerRadius, kMarkerRadius),
+                                 center + QPointF(-kMarkerRadius, kMarkerRadius)};
+        painter.drawPolygon(triangle);
+    }
+    for (std::size_t index = 0; index < receivers_.size(); ++index) {
+        if (!markerRect(receivers_[index]).intersects(dirty)) {
+            continue;
+        }
+        painter.setBrush(static_cast<int>(index) == draggedReceiver_ ? QColor(255, 200, 0)
+                                                                     : QColor(40, 120, 220));
+        painter.drawEllipse(toScreen(receivers_[index]), kMarkerRadius, kMarkerRadius);
+    }
+}
+
+void SceneView::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    if (!fitted_) {
+        fitToScene();
+    }
+    invalidateLayers();
+}
+
+void SceneView::mousePressEvent(QMouseEvent *event)
+{
+    const QPointF position = eventPosition(event);
+    if (event->button() == Qt::LeftButton) {
+        draggedReceiver_ = receiverAt(position);
+        if (draggedReceiver_ >= 0) {
+            setReceiverPosition(draggedReceiver_, receivers_[draggedReceiver_]);
+            return;
+        }
+    }
+    if (event->button() == Qt::LeftButton || event->button() == Qt::MiddleButton) {
+        panning_ = true;
+        panAnchorScreen_ = position;
+        panAnchorCenter_ = centerMeters_;
+        setCursor(Qt::ClosedHandCursor);
+    }
+}
+
+void SceneView::mouseMoveEvent(QMouseEvent *event)
+{
+    const QPointF position = eventPosition(event);
+    if (draggedReceiver_ >= 0) {
+        const QPointF meters = toMeters(position);
+        setReceiverPosition(draggedReceiver_, meters);
+        emit receiverMoved(draggedReceiver_, meters);
+        return;
+    }
+    if (panning_) {
+        const QPointF delta = position - panAnchorScreen_;
+        centerMeters_ = panAnchorCenter_ +
+                        QPointF(-delta.x() / pixelsPerMeter_, delta.y() / pixelsPerMeter_);
+        update();
+    }
+}
+
+void SceneView::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (draggedReceiver_ >= 0) {
+        const int index = draggedReceiver_;
+        draggedReceiver_ = -1;
+        setReceiverPosition(index, receivers_[index]);
+        emit receiverReleased(index, receivers_[index]);
+        return;
+    }
+    if (panning_) {
+        panning_ = false;
+        unsetCursor();
+        if (layerCenterMeters_ != centerMeters_) {
+            invalidateLayers();
+            update();
+        }
+    }
+    QWidget::mouseReleaseEvent(event);
+}
+
+void SceneView::wheelEvent(QWheelEvent *event)
+{
+    const QPointF anchor = eventPosition(event);
+    const QPointF before = toMeters(anchor);
+    const double factor = std::pow(2.0, event->angleDelta().y() / 240.0);
+    pixelsPerMeter_ =
+        std::clamp(pixelsPerMeter_ * factor, kMinimumPixelsPerMeter, kMaximumPixelsPerMeter);
+    centerMeters_ += before - toMeters(anchor);
+    if (panning_) {
+        panAnchorScreen_ = anchor;
+        panAnchorCenter_ = centerMeters_;
+    }
+    invalidateLayers();
+    update();
+    event->accept();
+}
+
+QTransform SceneView::viewTransform(const QPointF &centerMeters) const
+{
+    QTransform transform;
+    transform.translate(0.5 * width(), 0.5 * height());
+    transform.scale(pixelsPerMeter_, -pixelsPerMeter_);
+    transform.translate(-centerMeters.x(), -centerMeters.y());
+    return transform;
+}
+
+QPointF SceneView::toScreen(const QPointF &meters) const
+{
+    return viewTransform(centerMeters_).map(meters);
+}
+
+QPointF SceneView::toMeters(const QPointF &screen) const
+{
+    return viewTransform(centerMeters_).inverted().map(screen);
+}
+
+QRect SceneView::markerRect(const QPointF &meters) const
+{
+    const QPoint center = toScreen(meters).toPoint();
+    // Pen width and antialiasing bleed past the nominal radius.
+    const int extent = kMarkerRadius + 2;
+    return QRect(center.x() - extent, center.y() - extent, 2 * extent + 1, 2 * extent + 1);
+}
+
+int SceneView::receiverAt(const QPointF &screen) const
+{
+    int nearest = -1;
+    double nearestDistance = (kMarkerRadius + 2) * (kMarkerRadius + 2);
+    for (std::size_t index = 0; index < receivers_.size(); ++index) {
+        const QPointF delta = toScreen(receivers_[index]) - screen;
+        const double distance = QPointF::dotProduct(delta, delta);
+        if (distance <= nearestDistance) {
+            nearest = static_cast<int>(index);
+            nearestDistance = distance;
+        }
+    }
+    return nearest;
+}
+
+void SceneView::invalidateLayers()
+{
+    wallLayerDirty_ = true;
+    heatmapLayerDirty_ = true;
+}
+
+QPixmap SceneView::makeLayerPixmap() const
+{
+    const qreal ratio = devicePixelRatioF();
+    QPixmap pixmap(size() * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+    return pixmap;
+}
+
+void SceneView::rebuildHeatmapLayer()
+{
+    heatmapLayer_ = makeLayerPixmap();
+    heatmapLayerDirty_ = false;
+    layerCenterMeters_ = centerMeters_;
+    if (heatmapImage_.isNull()) {
+        return;
+    }
+    QPainter painter(&heatmapLayer_);
+    painter.setTransform(viewTransform(centerMeters_));
+    painter.drawImage(heatmapBoundsMeters_, heatmapImage_);
+}
+
+void SceneView::rebuildWallLayer()
+{
+    wallLayer_ = makeLayerPixmap();
+    wallLayerDirty_ = false;
+    layerCenterMeters_ = centerMeters_;
+    drawnWallLines_ = 0;
+    if (walls_.empty()) {
+        return;
+    }
+
+    // Work in device pixels so snapping matches what the pixmap can actually show.
+    const qreal ratio = wallLayer_.devicePixelRatio();
+    const QTransform transform = viewTransform(centerMeters_) * QTransform::fromScale(ratio, ratio);
+    const rfmodel::engine::ScreenTransform screen{transform.m11(), transform.m12(),
+                                                  transform.m21(), transform.m22(),
+                                                  transform.dx(),  transform.dy()};
+    const rfmodel::engine::SnappedWalls snapped = rfmodel::engine::SnapWallsToPixels(
+        walls_, screen, wallLayer_.width(), wallLayer_.height());
+    QVector<QLine> lines;
+    lines.reserve(static_cast<int>(snapped.lines.size()));
+    for (const auto &[a, b] : snapped.lines) {
+        lines.append(QLine(a.x, a.y, b.x, b.y));
+    }
+    QVector<QPoint> points;
+    points.reserve(static_cast<int>(snapped.points.size()));
+    for (const rfmodel::engine::PixelPoint &point : snapped.points) {
+        points.append(QPoint(point.x, point.y));
+    }
+    drawnWallLines_ = static_cast<int>(lines.size());
+
+    QPainter painter(&wallLayer_);
+    painter.setTransform(QTransform::fromScale(1.0 / ratio, 1.0 / ratio));
+    painter.setRenderHint(QPainter::Antialiasing, lines.size() <= kAntialiasLineLimit);
+    // A width of `ratio` device pixels is one logical pixel under the 1/ratio scale.
+    painter.setPen(QPen(palette().text().color(), std::max<qreal>(1.0, ratio), Qt::SolidLine,
+                        Qt::RoundCap));
+    painter.drawLines(lines);
+    painter.drawPoints(points.constData(), points.size());
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoverageRaster.h"
+#include "WallGeometry.h"
+
+#include <QImage>
+#include <QPixmap>
+#include <QPointF>
+#include <QRect>
+#include <QTransform>
+#include <QWidget>
+
+#include <vector>
+
+/**
+ * @brief Plan view of walls, a coverage heatmap, transmitters and draggable receivers.
+ *
+ * Walls and the heatmap change rarely, so each is rasterized once into an offscreen pixmap
+ * for the current view and blitted afterwards; a layer is only rebuilt when its content,
+ * the zoom or the widget size changes. Receiver drags and marker updates repaint just the
+ * rectangles the markers covered before and after. While panning, the cached layers are
+ * blitted at an offset and rebuilt once the pan ends.
+ *
+ * Rebuilding the wall layer snaps endpoints to device pixels and drops walls whose snapped
+ * form was already drawn, so a zoomed-out floorplan costs about one line per occupied pixel
+ * span instead of one per wall. Walls that collapse into a single pixel are drawn as points.
+ */
+class SceneView : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SceneView(QWidget *parent = nullptr);
+
+    /**
+     * @brief Replaces the wall footprints and fits the view to them when nothing was shown.
+     */
+    void setWalls(std::vector<rfmodel::engine::WallSegment> walls);
+
+    /**
+     * @brief Replaces the heatmap; values are mapped linearly from minimumDb to maximumDb.
+     *
+     * NaN cells stay transparent.
+     */
+    void setHeatmap(const rfmodel::engine::CoverageRaster &raster, double minimumDb,
+                    double maximumDb);
+    void clearHeatmap();
+
+    void setTransmitters(std::vector<QPointF> positionsMeters);
+    void setReceivers(std::vector<QPointF> positionsMeters);
+
+    /**
+     * @brief Moves one receiver, repainting only the area around its old and new marker.
+     */
+    void setReceiverPosition(int index, const QPointF &positionMeters);
+
+    [[nodiscard]] const std::vector<QPointF> &receivers() const { return receivers_; }
+
+    /**
+     * @brief Zooms and centers the view on the walls and the heatmap.
+     */
+    void fitToScene();
+
+    /**
+     * @brief Returns how many line primitives the last wall layer rebuild drew.
+     */
+    [[nodiscard]] int drawnWallLines() const { return drawnWallLines_; }
+
+signals:
+    /** Emitted for every mouse move while a receiver is dragged. */
+    void receiverMoved(int index, const QPointF &positionMeters);
+
+    /** Emitted once when a receiver drag ends. */
+    void receiverReleased(int index, const QPointF &positionMeters);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+
+private:
+    /** Maps plan-view meters (Y up) to widget pixels (Y down) around the given center. */
+    [[nodiscard]] QTransform viewTransform(const QPointF &centerMeters) const;
+    [[nodiscard]] QPointF toScreen(const QPointF &meters) const;
+    [[nodiscard]] QPointF toMeters(const QPointF &screen) const;
+    [[nodiscard]] QRect markerRect(const QPointF &meters) const;
+    [[nodiscard]] int receiverAt(const QPointF &screen) const;
+
+    void invalidateLayers();
+    void rebuildWallLayer();
+    void rebuildHeatmapLayer();
+    [[nodiscard]] QPixmap makeLayerPixmap() const;
+
+    std::vector<rfmodel::engine::WallSegment> walls_;
+    QImage                                    heatmapImage_;
+    QRectF                                    heatmapBoundsMeters_;
+    std::vector<QPointF>                      transmitters_;
+    std::vector<QPointF>                      receivers_;
+
+    QPointF centerMeters_{0.0, 0.0};
+    double  pixelsPerMeter_{10.0};
+    bool    fitted_{false};
+
+    QPixmap wallLayer_;
+    QPixmap heatmapLayer_;
+    bool    wallLayerDirty_{true};
+    bool    heatmapLayerDirty_{true};
+    /** View center the cached layers were rendered for; differs from centerMeters_ mid-pan. */
+    QPointF layerCenterMeters_{0.0, 0.0};
+    int     drawnWallLines_{0};
+
+    int     draggedReceiver_{-1};
+    bool    panning_{false};
+    QPointF panAnchorScreen_;
+    QPointF panAnchorCenter_;
+};
@@ -0,0 +1,89 @@
+// Measures the geometry half of SceneView's wall-layer rebuild for a 100k-wall floorplan.
+//
+// The plan is a 1 km x 1 km campus of 5 m rooms whose walls are split at doors, 100k walls
+// in total. For a 1920 x 1080 layer at several zoom levels the walls are mapped, clipped,
+// snapped to pixels and deduplicated with SnapWallsToPixels(), exactly as the view does
+// before handing the primitives to QPainter. Painting itself needs a Qt build and is not
+// part of this harness; the "lines" column is what the painter would receive. Timings are
+// the best of several runs on one thread, compared against a 60 fps frame budget.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "WallGeometry.h"
+#include "WallLevelOfDetail.h"
+
+namespace {
+
+using rfmodel::engine::MakeWallSegment;
+using rfmodel::engine::ScreenTransform;
+using rfmodel::engine::SnapWallsToPixels;
+using rfmodel::engine::WallSegment;
+using rfmodel::math::Vec2d;
+
+constexpr std::size_t kWalls = 100000;
+constexpr int         kWidth = 1920;
+constexpr int         kHeight = 1080;
+constexpr int         kTimingRuns = 7;
+constexpr double      kFrameBudgetMs = 1000.0 / 60.0;
+
+std::vector<WallSegment> makeCampus() {
+    // Each room contributes its south and west wall, each split into two pieces at a door.
+    constexpr double kRoom = 5.0;
+    constexpr double kDoor = 1.0;
+    std::vector<WallSegment> walls;
+    walls.reserve(kWalls);
+    for (std::size_t room = 0; walls.size() < kWalls; ++room) {
+        const double x = kRoom * static_cast<double>(room % 158);
+        const double y = kRoom * static_cast<double>(room / 158);
+        const double door = 1.0 + static_cast<double>(room % 3);
+        walls.push_back(MakeWallSegment(Vec2d{x, y}, Vec2d{x + door, y}));
+        walls.push_back(MakeWallSegment(Vec2d{x + door + kDoor, y}, Vec2d{x + kRoom, y}));
+        walls.push_back(MakeWallSegment(Vec2d{x, y}, Vec2d{x, y + door}));
+        walls.push_back(MakeWallSegment(Vec2d{x, y + door + kDoor}, Vec2d{x, y + kRoom}));
+    }
+    walls.resize(kWalls);
+    return walls;
+}
+
+}  // namespace
+
+int main() {
+    const std::vector<WallSegment> walls = makeCampus();
+    double maxX = 0.0;
+    double maxY = 0.0;
+    for (const WallSegment &wall : walls) {
+        maxX = std::max({maxX, wall.start.x, wall.end.x});
+        maxY = std::max({maxY, wall.start.y, wall.end.y});
+    }
+    const double fit = std::min(kWidth / maxX, kHeight / maxY);
+
+    std::printf("%zu walls, %d x %d layer, frame budget %.1f ms\n", walls.size(), kWidth, kHeight,
+                kFrameBudgetMs);
+    std::printf("%10s %12s %10s %10s %12s %10s\n", "zoom", "px/m", "lines", "points",
+                "duplicates", "ms");
+    for (const double zoom : {1.0, 4.0, 16.0, 64.0}) {
+        // Centered on the campus, Y up, like SceneView::viewTransform().
+        ScreenTransform transform;
+        transform.m11 = fit * zoom;
+        transform.m22 = -fit * zoom;
+        transform.dx = kWidth / 2.0 - transform.m11 * maxX / 2.0;
+        transform.dy = kHeight / 2.0 - transform.m22 * maxY / 2.0;
+
+        double best = 1e300;
+        rfmodel::engine::SnappedWalls snapped;
+        for (int run = 0; run < kTimingRuns; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            snapped = SnapWallsToPixels(walls, transform, kWidth, kHeight);
+            const std::chrono::duration<double, std::milli> elapsed =
+                std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+        }
+        std::printf("%10.0f %12.3f %10zu %10zu %12zu %10.2f\n", zoom, transform.m11,
+                    snapped.lines.size(), snapped.points.size(), snapped.duplicates, best);
+    }
+    return 0;
+}
@@ -0,0 +1,286 @@
+#pragma once
+
+#include "CoverageRaster.h"
+
+#include "rfmodel/math/Constants.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Received signal metrics evaluated at a single scene position.
+ */
+struct CoverageSample {
+    double powerDbm{0.0};
+    double phaseRadians{0.0};
+};
+
+/**
+ * @brief Tuning knobs controlling where the adaptive sampler refines the coverage map.
+ */
+struct AdaptiveCoverageOptions {
+    /** Edge length of the coarsest quadtree cells in meters. */
+    double baseCellSizeMeters{4.0};
+    /** Maximum number of subdivisions applied to a base cell. */
+    std::size_t maxDepth{5};
+    /** Largest received power change across a cell, in dB, that is left to interpolation. */
+    double powerToleranceDb{1.0};
+    /**
+     * Largest phase change across a cell, in radians, that is left to interpolation. Off by
+     * default: the carrier phase of a real field wraps once per wavelength, so any finite
+     * tolerance refines every cell to the maximum depth. Only set it for evaluators whose
+     * phase varies slowly, such as a phase relative to a reference path.
+     */
+    double phaseToleranceRadians{std::numeric_limits<double>::infinity()};
+};
+
+/**
+ * @brief Output of an adaptive coverage run resampled onto the requested raster.
+ */
+struct AdaptiveCoverageResult {
+    CoverageRaster powerDbm;
+    CoverageRaster phaseRadians;
+    /** Number of times the evaluator was invoked. */
+    std::size_t evaluations{0};
+    /** Number of quadtree leaves used for interpolation. */
+    std::size_t leafCells{0};
+    /** Evaluations direct per-cell evaluation of the output raster would have needed. */
+    std::size_t uniformEvaluations{0};
+};
+
+/**
+ * @brief Samples coverage on a quadtree that only refines where the signal varies quickly.
+ *
+ * Each base cell is evaluated at its corners and center. Cells whose power or phase
+ * varies by more than the configured tolerances are split into four children until the
+ * maximum depth is reached; smooth cells are bilinearly interpolated. Samples sit on a
+ * shared lattice so neighbouring cells never evaluate the same position twice.
+ */
+class AdaptiveCoverageSampler {
+public:
+    using Evaluator = std::function<CoverageSample(double xMeters, double yMeters)>;
+
+    explicit AdaptiveCoverageSampler(AdaptiveCoverageOptions options = {})
+        : options_(options)
+    {
+        options_.maxDepth = std::min<std::size_t>(options_.maxDepth, kMaxDepth);
+    }
+
+    /**
+     * @brief Returns the options used to drive refinement.
+     */
+    [[nodiscard]] const AdaptiveCoverageOptions &Options() const { return options_; }
+
+    /**
+     * @brief Samples the evaluator over the output extent and resamples onto its raster.
+     */
+    [[nodiscard]] AdaptiveCoverageResult Sample(const RasterGeometry &output,
+                                                const Evaluator &evaluate) const
+    {
+        AdaptiveCoverageResult result;
+        result.powerDbm = CoverageRaster(output);
+        result.phaseRadians = CoverageRaster(output);
+        if (output.CellCount() == 0 || !evaluate) {
+            return result;
+        }
+
+        Lattice lattice(output, options_, evaluate);
+        std::vector<Node> nodes;
+        BuildTree(lattice, nodes);
+
+        for (std::size_t row = 0; row < output.rows; ++row) {
+            for (std::size_t column = 0; column < output.columns; ++column) {
+                const CoverageSample sample = Interpolate(
+                    lattice, nodes, output.CellCenterX(column), output.CellCenterY(row));
+                result.powerDbm.Set(column, row, sample.powerDbm);
+                result.phaseRadians.Set(column, row, sample.phaseRadians);
+            }
+        }
+
+        result.evaluations = lattice.Evaluations();
+        result.leafCells = static_cast<std::size_t>(
+            std::count_if(nodes.begin(), nodes.end(), [](const Node &node) { return node.IsLeaf(); }));
+        result.uniformEvaluations = output.CellCount();
+        return result;
+    }
+
+private:
+    static constexpr std::size_t kMaxDepth = 16;
+
+    struct Lattice {
+        Lattice(const RasterGeometry &output, const AdaptiveCoverageOptions &options,
+                const Evaluator &evaluator)
+            : originX(output.originX), originY(output.originY), evaluate(evaluator)
+        {
+            const double baseSize = std::max(options.baseCellSizeMeters, 1e-6);
+            baseColumns = std::max<std::size_t>(
+                1, static_cast<std::size_t>(std::ceil(output.Width() / baseSize)));
+            baseRows = std::max<std::size_t>(
+                1, static_cast<std::size_t>(std::ceil(output.Height() / baseSize)));
+            scale = std::size_t{1} << options.maxDepth;
+            stepMeters = baseSize / static_cast<double>(scale);
+        }
+
+        const CoverageSample &At(std::uint32_t i, std::uint32_t j)
+        {
+            const std::uint64_t key = (static_cast<std::uint64_t>(i) << 32U) | j;
+            auto found = samples.find(key);
+            if (found == samples.end()) {
+                const CoverageSample sample = evaluate(originX + static_cast<double>(i) * stepMeters,
+                                                       originY + static_cast<double>(j) * stepMeters);
+                found = samples.emplace(key, sample).first;
+            }
+            return found->second;
+        }
+
+        [[nodiscard]] std::size_t Evaluations() const { return samples.size(); }
+
+        double           originX;
+        double           originY;
+        double           stepMeters{1.0};
+        std::size_t      baseColumns{1};
+        std::size_t      baseRows{1};
+        std::size_t      scale{1};
+        const Evaluator &evaluate;
+        std::unordered_map<std::uint64_t, CoverageSample> samples;
+    };
+
+    struct Node {
+        std::uint32_t i{0};
+        std::uint32_t j{0};
+        std::uint32_t size{1};
+        std::int64_t  firstChild{-1};
+        // Lower-left, lower-right, upper-left, upper-right.
+        std::array<CoverageSample, 4> corners{};
+
+        [[nodiscard]] bool IsLeaf() const { return firstChild < 0; }
+    };
+
+    static double PowerDifference(double a, double b)
+    {
+        if (a == b) {
+            return 0.0;
+        }
+        return std::abs(a - b);
+    }
+
+    [[nodiscard]] bool NeedsRefinement(const Node &node, const CoverageSample &center) const
+    {
+        for (const CoverageSample &corner : node.corners) {
+            const double powerDelta = PowerDifference(corner.powerDbm, center.powerDbm);
+            if (!(powerDelta <= options_.powerToleranceDb)) {
+                return true;
+            }
+            const double phaseDelta =
+                std::abs(math::wrapPhase(corner.phaseRadians - center.phaseRadians));
+            if (phaseDelta > options_.phaseToleranceRadians) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void BuildTree(Lattice &lattice, std::vector<Node> &nodes) const
+    {
+        const auto scale = static_cast<std::uint32_t>(lattice.scale);
+        for (std::size_t by = 0; by < lattice.baseRows; ++by) {
+            for (std::size_t bx = 0; bx < lattice.baseColumns; ++bx) {
+                Node root;
+                root.i = static_cast<std::uint32_t>(bx) * scale;
+                root.j = static_cast<std::uint32_t>(by) * scale;
+                root.size = scale;
+                nodes.push_back(root);
+            }
+        }
+
+        std::vector<std::size_t> pending(nodes.size());
+        for (std::size_t index = 0; index < pending.size(); ++index) {
+            pending[index] = pending.size() - 1 - index;
+        }
+
+        while (!pending.empty()) {
+            const std::size_t index = pending.back();
+            pending.pop_back();
+
+            Node node = nodes[index];
+            node.corners = {lattice.At(node.i, node.j), lattice.At(node.i + node.size, node.j),
+                            lattice.At(node.i, node.j + node.size),
+                            lattice.At(node.i + node.size, node.j + node.size)};
+
+            if (node.size > 1) {
+                const std::uint32_t half = node.size / 2;
+                const CoverageSample center = lattice.At(node.i + half, node.j + half);
+                if (NeedsRefinement(node, center)) {
+                    node.firstChild = static_cast<std::int64_t>(nodes.size());
+                    const std::array<std::pair<std::uint32_t, std::uint32_t>, 4> offsets = {
+                        std::make_pair(0U, 0U), std::make_pair(half, 0U), std::make_pair(0U, half),
+                        std::make_pair(half, half)};
+                    for (const auto &[di, dj] : offsets) {
+                        Node child;
+                        child.i = node.i + di;
+                        child.j = node.j + dj;
+                        child.size = half;
+                        nodes.push_back(child);
+                    }
+                    for (std::size_t child = 4; child > 0; --child) {
+                        pending.push_back(static_cast<std::size_t>(node.firstChild) + child - 1);
+                    }
+                }
+            }
+            nodes[index] = node;
+        }
+    }
+
+    static CoverageSample Interpolate(const Lattice &lattice, const std::vector<Node> &nodes,
+                                      double xMeters, double yMeters)
+    {
+        const double u = std::max(0.0, (xMeters - lattice.originX) / lattice.stepMeters);
+        const double v = std::max(0.0, (yMeters - lattice.originY) / lattice.stepMeters);
+        const auto scale = static_cast<double>(lattice.scale);
+        const std::size_t bx =
+            std::min(static_cast<std::size_t>(u / scale), lattice.baseColumns - 1);
+        const std::size_t by = std::min(static_cast<std::size_t>(v / scale), lattice.baseRows - 1);
+
+        const Node *node = &nodes[by * lattice.baseColumns + bx];
+        while (!node->IsLeaf()) {
+            const double half = static_cast<double>(node->size / 2);
+            const std::size_t quadrant = (u >= node->i + half ? 1U : 0U) +
+                                         (v >= node->j + half ? 2U : 0U);
+            node = &nodes[static_cast<std::size_t>(node->firstChild) + quadrant];
+        }
+
+        const double size = static_cast<double>(node->size);
+        const double fx = std::clamp((u - node->i) / size, 0.0, 1.0);
+        const double fy = std::clamp((v - node->j) / size, 0.0, 1.0);
+        const std::array<double, 4> weights = {(1.0 - fx) * (1.0 - fy), fx * (1.0 - fy),
+                                               (1.0 - fx) * fy, fx * fy};
+
+        double power = 0.0;
+        double phasorReal = 0.0;
+        double phasorImag = 0.0;
+        for (std::size_t corner = 0; corner < weights.size(); ++corner) {
+            if (weights[corner] == 0.0) {
+                continue;
+            }
+            const CoverageSample &sample = node->corners[corner];
+            power += weights[corner] * sample.powerDbm;
+            phasorReal += weights[corner] * std::cos(sample.phaseRadians);
+            phasorImag += weights[corner] * std::sin(sample.phaseRadians);
+        }
+        return CoverageSample{power, std::atan2(phasorImag, phasorReal)};
+    }
+
+    AdaptiveCoverageOptions options_;
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "IArrayReceiver.h"
+#include "PropagationPath.h"
+
+#include "rfmodel/math/Complex.h"
+#include "rfmodel/math/Math.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Rotates a vector from an object's local frame into world space.
+ *
+ * The orientation is roll/pitch/yaw in radians applied as R = Rz(yaw) * Ry(pitch) * Rx(roll),
+ * so a zero orientation keeps local +X aligned with world +X.
+ */
+inline math::Vec3d RotateToWorld(const math::Vec3d &local,
+                                 const std::array<double, 3> &orientationRadians)
+{
+    const double cr = std::cos(orientationRadians[0]);
+    const double sr = std::sin(orientationRadians[0]);
+    const double cp = std::cos(orientationRadians[1]);
+    const double sp = std::sin(orientationRadians[1]);
+    const double cy = std::cos(orientationRadians[2]);
+    const double sy = std::sin(orientationRadians[2]);
+
+    return math::Vec3d{
+        cy * cp * local.x + (cy * sp * sr - sy * cr) * local.y + (cy * sp * cr + sy * sr) * local.z,
+        sy * cp * local.x + (sy * sp * sr + cy * cr) * local.y + (sy * sp * cr - cy * sr) * local.z,
+        -sp * local.x + cp * sr * local.y + cp * cr * local.z,
+    };
+}
+
+/**
+ * @brief Element layout of an antenna array in the owning receiver's local frame.
+ *
+ * Arrays face local +X (broadside). Linear arrays extend along local +Y and planar arrays
+ * span the local Y-Z plane. Offsets are centered on the receiver position, in meters.
+ */
+class AntennaArray {
+public:
+    AntennaArray() = default;
+
+    explicit AntennaArray(std::vector<math::Vec3d> elementOffsets)
+        : offsets_(std::move(elementOffsets))
+    {
+    }
+
+    /**
+     * @brief Builds a uniform linear array (ULA) with the given element spacing in meters.
+     */
+    static AntennaArray UniformLinear(std::size_t elements, double spacingMeters)
+    {
+        return UniformPlanar(1, elements, spacingMeters);
+    }
+
+    /**
+     * @brief Builds a uniform planar array (UPA) with rows along Z and columns along Y.
+     */
+    static AntennaArray UniformPlanar(std::size_t rows, std::size_t columns, double spacingMeters)
+    {
+        std::vector<math::Vec3d> offsets;
+        offsets.reserve(rows * columns);
+        const double rowCenter = 0.5 * static_cast<double>(rows > 0 ? rows - 1 : 0);
+        const double columnCenter = 0.5 * static_cast<double>(columns > 0 ? columns - 1 : 0);
+        for (std::size_t row = 0; row < rows; ++row) {
+            for (std::size_t column = 0; column < columns; ++column) {
+                const double y = (static_cast<double>(column) - columnCenter) * spacingMeters;
+                const double z = (static_cast<double>(row) - rowCenter) * spacingMeters;
+                offsets.emplace_back(0.0, y, z);
+            }
+        }
+        return AntennaArray(std::move(offsets));
+    }
+
+    /**
+     * @brief Returns the number of elements in the array.
+     */
+    [[nodiscard]] std::size_t ElementCount() const { return offsets_.size(); }
+
+    /**
+     * @brief Returns element offsets in the receiver's local frame in meters.
+     */
+    [[nodiscard]] const std::vector<math::Vec3d> &ElementOffsets() const { return offsets_; }
+
+    /**
+     * @brief Returns element offsets rotated into world space for the given orientation.
+     */
+    [[nodiscard]] std::vector<math::Vec3d>
+    WorldOffsets(const std::array<double, 3> &orientationRadians) const
+    {
+        std::vector<math::Vec3d> world;
+        world.reserve(offsets_.size());
+        for (const math::Vec3d &offset : offsets_) {
+            world.push_back(RotateToWorld(offset, orientationRadians));
+        }
+        return world;
+    }
+
+private:
+    std::vector<math::Vec3d> offsets_;
+};
+
+/**
+ * @brief Captures the element layout exposed by an array receiver.
+ */
+inline AntennaArray MakeAntennaArray(const IArrayReceiver &receiver)
+{
+    std::vector<math::Vec3d> offsets;
+    for (const std::array<double, 3> &offset : receiver.ElementOffsets()) {
+        offsets.emplace_back(offset[0], offset[1], offset[2]);
+    }
+    return AntennaArray(std::move(offsets));
+}
+
+/**
+ * @brief Computes the complex response of every array element to a set of paths.
+ *
+ * Each path is treated as a plane wave across the array aperture arriving from
+ * PropagationPath::ArrivalDirection(); an element displaced toward the source sees a
+ * shorter path and therefore a phase advance.
+ *
+ * @param worldOffsets Element offsets relative to the receiver position in world space.
+ * @param wavenumber Carrier wavenumber 2 pi / lambda in radians per meter.
+ */
+inline std::vector<math::Complex> ComputeElementResponses(
+    const std::vector<PropagationPath> &paths, const std::vector<math::Vec3d> &worldOffsets,
+    double wavenumber)
+{
+    std::vector<math::Complex> responses(worldOffsets.size());
+    for (const PropagationPath &path : paths) {
+        const math::Vec3d direction = path.ArrivalDirection();
+        for (std::size_t element = 0; element < worldOffsets.size(); ++element) {
+            const double advance = wavenumber * worldOffsets[element].dot(direction);
+            responses[element] += path.gain * math::Complex::fromPolar(1.0, advance);
+        }
+    }
+    return responses;
+}
+
+} // namespace rfmodel::engine
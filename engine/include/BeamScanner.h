@@ -0,0 +1,206 @@
+#pragma once
+
+#include "rfmodel/math/Complex.h"
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Per-element complex responses for a batch of evaluation points.
+ *
+ * Stored as split real/imaginary planes, element-major, so that for a fixed element the
+ * responses of consecutive points are contiguous.
+ */
+template <typename Scalar = double>
+class ElementResponseBatch {
+public:
+    ElementResponseBatch(std::size_t elements, std::size_t points)
+        : elements_(elements), points_(points), real_(elements * points), imag_(elements * points)
+    {
+    }
+
+    [[nodiscard]] std::size_t ElementCount() const { return elements_; }
+    [[nodiscard]] std::size_t PointCount() const { return points_; }
+
+    /**
+     * @brief Stores the response of one element at one point.
+     */
+    void Set(std::size_t element, std::size_t point, const math::Complex &response)
+    {
+        real_[element * points_ + point] = static_cast<Scalar>(response.real);
+        imag_[element * points_ + point] = static_cast<Scalar>(response.imag);
+    }
+
+    /**
+     * @brief Stores the responses of all elements at one point.
+     */
+    void SetPoint(std::size_t point, const std::vector<math::Complex> &responses)
+    {
+        const std::size_t count = std::min(elements_, responses.size());
+        for (std::size_t element = 0; element < count; ++element) {
+            Set(element, point, responses[element]);
+        }
+    }
+
+    [[nodiscard]] const Scalar *Real(std::size_t element) const
+    {
+        return &real_[element * points_];
+    }
+
+    [[nodiscard]] const Scalar *Imag(std::size_t element) const
+    {
+        return &imag_[element * points_];
+    }
+
+private:
+    std::size_t         elements_;
+    std::size_t         points_;
+    std::vector<Scalar> real_;
+    std::vector<Scalar> imag_;
+};
+
+/**
+ * @brief Evaluates many steered beams over many points as one matrix product.
+ *
+ * The steering matrix A (beams x elements) is precomputed for a set of world azimuths at a
+ * fixed elevation; scanning forms Y = A^H X for the element-response matrix X
+ * (elements x points) and returns |Y|^2. Steering weights are unit-norm, so a beam pointed
+ * at a single plane wave reports the element power times the element count (array gain).
+ * The innermost loop runs over points and vectorizes; Scalar = float doubles its width.
+ */
+template <typename Scalar = double>
+class BeamScanner {
+    static_assert(std::is_floating_point<Scalar>::value,
+                  "BeamScanner requires a floating-point type");
+
+public:
+    /**
+     * @param worldOffsets Element offsets relative to the receiver in world space, meters.
+     * @param wavenumber Carrier wavenumber 2 pi / lambda in radians per meter.
+     * @param azimuthsRadians Beam azimuths measured from +X toward +Y.
+     * @param elevationRadians Beam elevation above the XY plane.
+     */
+    BeamScanner(const std::vector<math::Vec3d> &worldOffsets, double wavenumber,
+                std::vector<double> azimuthsRadians, double elevationRadians = 0.0)
+        : elements_(worldOffsets.size()), azimuths_(std::move(azimuthsRadians))
+    {
+        const double norm =
+            elements_ > 0 ? 1.0 / std::sqrt(static_cast<double>(elements_)) : 0.0;
+        const double cosElevation = std::cos(elevationRadians);
+        steeringReal_.reserve(azimuths_.size() * elements_);
+        steeringImag_.reserve(azimuths_.size() * elements_);
+        for (const double azimuth : azimuths_) {
+            const math::Vec3d direction{cosElevation * std::cos(azimuth),
+                                        cosElevation * std::sin(azimuth),
+                                        std::sin(elevationRadians)};
+            for (const math::Vec3d &offset : worldOffsets) {
+                const double phase = wavenumber * offset.dot(direction);
+                // Stored conjugated so that scanning is a plain multiply-accumulate.
+                steeringReal_.push_back(static_cast<Scalar>(norm * std::cos(phase)));
+                steeringImag_.push_back(static_cast<Scalar>(-norm * std::sin(phase)));
+            }
+        }
+    }
+
+    /**
+     * @brief Builds evenly spaced azimuths covering the full circle.
+     */
+    static std::vector<double> EvenAzimuths(std::size_t beams)
+    {
+        std::vector<double> azimuths(beams);
+        for (std::size_t beam = 0; beam < beams; ++beam) {
+            azimuths[beam] = -math::kPi + math::kTwoPi * static_cast<double>(beam) /
+                                              static_cast<double>(beams);
+        }
+        return azimuths;
+    }
+
+    [[nodiscard]] std::size_t BeamCount() const { return azimuths_.size(); }
+    [[nodiscard]] std::size_t ElementCount() const { return elements_; }
+    [[nodiscard]] const std::vector<double> &Azimuths() const { return azimuths_; }
+
+    /**
+     * @brief Computes beam power for every (beam, point) pair, stored beam-major.
+     */
+    void Scan(const ElementResponseBatch<Scalar> &responses, std::vector<Scalar> &beamPower) const
+    {
+        const std::size_t points = responses.PointCount();
+        beamPower.assign(BeamCount() * points, Scalar{0});
+        std::vector<Scalar> real(points);
+        std::vector<Scalar> imag(points);
+
+        for (std::size_t beam = 0; beam < BeamCount(); ++beam) {
+            std::fill(real.begin(), real.end(), Scalar{0});
+            std::fill(imag.begin(), imag.end(), Scalar{0});
+            for (std::size_t element = 0; element < elements_; ++element) {
+                const Scalar wr = steeringReal_[beam * elements_ + element];
+                const Scalar wi = steeringImag_[beam * elements_ + element];
+                const Scalar *xr = responses.Real(element);
+                const Scalar *xi = responses.Imag(element);
+                for (std::size_t point = 0; point < points; ++point) {
+                    real[point] += wr * xr[point] - wi * xi[point];
+                    imag[point] += wr * xi[point] + wi * xr[point];
+                }
+            }
+            Scalar *output = &beamPower[beam * points];
+            for (std::size_t point = 0; point < points; ++point) {
+                output[point] = real[point] * real[point] + imag[point] * imag[point];
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the angle-of-arrival spectrum (beam power per azimuth) for one point.
+     */
+    [[nodiscard]] std::vector<Scalar> Spectrum(const std::vector<math::Complex> &responses) const
+    {
+        ElementResponseBatch<Scalar> batch(elements_, 1);
+        batch.SetPoint(0, responses);
+        std::vector<Scalar> power;
+        Scan(batch, power);
+        return power;
+    }
+
+    /**
+     * @brief Reduces scan output to the best beam power per point for beamformed coverage.
+     *
+     * @param bestBeam Optional output receiving the index of the strongest beam per point.
+     */
+    static std::vector<Scalar> BestBeamPower(const std::vector<Scalar> &beamPower,
+                                             std::size_t points,
+                                             std::vector<std::size_t> *bestBeam = nullptr)
+    {
+        std::vector<Scalar> best(points, Scalar{0});
+        if (bestBeam != nullptr) {
+            bestBeam->assign(points, 0);
+        }
+        const std::size_t beams = points > 0 ? beamPower.size() / points : 0;
+        for (std::size_t beam = 0; beam < beams; ++beam) {
+            const Scalar *row = &beamPower[beam * points];
+            for (std::size_t point = 0; point < points; ++point) {
+                if (row[point] > best[point]) {
+                    best[point] = row[point];
+                    if (bestBeam != nullptr) {
+                        (*bestBeam)[point] = beam;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+private:
+    std::size_t         elements_;
+    std::vector<double> azimuths_;
+    std::vector<Scalar> steeringReal_;
+    std::vector<Scalar> steeringImag_;
+};
+
+} // namespace rfmodel::engine
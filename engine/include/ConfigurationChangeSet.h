@@ -0,0 +1,175 @@
+#pragma once
+
+#include "SceneSnapshot.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief How an object differs between two configurations.
+ */
+enum class ObjectChangeKind {
+    Added,
+    Removed,
+    Modified,
+};
+
+/**
+ * @brief A single configuration field that was added, removed, or given a new value.
+ */
+struct FieldChange {
+    std::string                field;
+    std::optional<std::string> before;
+    std::optional<std::string> after;
+};
+
+/**
+ * @brief Object-level entry of a configuration change set.
+ *
+ * For added and removed objects every field is listed; for modified objects only the
+ * fields whose values differ.
+ */
+struct ConfigurationObjectChange {
+    std::string              id;
+    std::string              type;
+    ObjectChangeKind         kind{ObjectChangeKind::Modified};
+    std::vector<FieldChange> fields;
+    SceneObjectStatePtr      before;
+    SceneObjectStatePtr      after;
+
+    /**
+     * @brief Returns true when the named field is part of this change.
+     */
+    [[nodiscard]] bool HasField(const std::string &field) const
+    {
+        return std::any_of(fields.begin(), fields.end(),
+                           [&field](const FieldChange &change) { return change.field == field; });
+    }
+
+    /**
+     * @brief Returns true when the object occupied or now occupies part of the region.
+     */
+    [[nodiscard]] bool Affects(const SceneBounds &region) const
+    {
+        return (before && before->bounds.Intersects(region)) ||
+               (after && after->bounds.Intersects(region));
+    }
+};
+
+/**
+ * @brief Structured difference between the live scene and a newly loaded configuration.
+ *
+ * Delivered to ISimulationSystem::OnConfigurationChanged() so systems can invalidate only
+ * the caches and acceleration structures touched by the reload.
+ */
+struct ConfigurationChangeSet {
+    std::string                            sourceIdentifier;
+    std::vector<ConfigurationObjectChange> objects;
+
+    [[nodiscard]] bool Empty() const { return objects.empty(); }
+
+    /**
+     * @brief Returns the change for the given object, or nullptr when it is unchanged.
+     */
+    [[nodiscard]] const ConfigurationObjectChange *Find(const std::string &objectId) const
+    {
+        const auto found =
+            std::find_if(objects.begin(), objects.end(),
+                         [&objectId](const ConfigurationObjectChange &change) {
+                             return change.id == objectId;
+                         });
+        return found == objects.end() ? nullptr : &*found;
+    }
+
+    /**
+     * @brief Returns true when any object of the given type changed.
+     */
+    [[nodiscard]] bool TouchesType(const std::string &type) const
+    {
+        return std::any_of(objects.begin(), objects.end(),
+                           [&type](const ConfigurationObjectChange &change) {
+                               return change.type == type;
+                           });
+    }
+
+    /**
+     * @brief Returns true when any changed object overlaps the region.
+     */
+    [[nodiscard]] bool Affects(const SceneBounds &region) const
+    {
+        return std::any_of(objects.begin(), objects.end(),
+                           [&region](const ConfigurationObjectChange &change) {
+                               return change.Affects(region);
+                           });
+    }
+};
+
+/**
+ * @brief Compares two snapshots object by object and field by field.
+ *
+ * Objects whose states are distinct but carry identical type, fields, and bounds are not
+ * reported, so freshly parsed documents diff cleanly against the live scene.
+ */
+inline ConfigurationChangeSet MakeConfigurationChangeSet(const SceneSnapshot &from,
+                                                         const SceneSnapshot &to,
+                                                         std::string sourceIdentifier = {})
+{
+    ConfigurationChangeSet changeSet;
+    changeSet.sourceIdentifier = std::move(sourceIdentifier);
+
+    for (const SceneObjectChange &change : SceneSnapshot::Diff(from, to)) {
+        ConfigurationObjectChange entry;
+        entry.id = change.id;
+        entry.before = change.before;
+        entry.after = change.after;
+
+        if (!change.before) {
+            entry.kind = ObjectChangeKind::Added;
+            entry.type = change.after->type;
+            for (const auto &[field, value] : change.after->fields) {
+                entry.fields.push_back(FieldChange{field, std::nullopt, value});
+            }
+        } else if (!change.after) {
+            entry.kind = ObjectChangeKind::Removed;
+            entry.type = change.before->type;
+            for (const auto &[field, value] : change.before->fields) {
+                entry.fields.push_back(FieldChange{field, value, std::nullopt});
+            }
+        } else {
+            entry.kind = ObjectChangeKind::Modified;
+            entry.type = change.after->type;
+            const auto &beforeFields = change.before->fields;
+            const auto &afterFields = change.after->fields;
+            for (const auto &[field, value] : beforeFields) {
+                const auto found = afterFields.find(field);
+                if (found == afterFields.end()) {
+                    entry.fields.push_back(FieldChange{field, value, std::nullopt});
+                } else if (found->second != value) {
+                    entry.fields.push_back(FieldChange{field, value, found->second});
+                }
+            }
+            for (const auto &[field, value] : afterFields) {
+                if (beforeFields.count(field) == 0) {
+                    entry.fields.push_back(FieldChange{field, std::nullopt, value});
+                }
+            }
+            const bool sameBounds = change.before->bounds.minX == change.after->bounds.minX &&
+                                    change.before->bounds.minY == change.after->bounds.minY &&
+                                    change.before->bounds.maxX == change.after->bounds.maxX &&
+                                    change.before->bounds.maxY == change.after->bounds.maxY;
+            if (entry.fields.empty() && change.before->type == change.after->type &&
+                sameBounds) {
+                continue;
+            }
+        }
+        changeSet.objects.push_back(std::move(entry));
+    }
+    return changeSet;
+}
+
+} // namespace rfmodel::engine
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "SceneSnapshot.h"
+
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Result of parsing a scene configuration document.
+ *
+ * The snapshot is only meaningful when errors is empty.
+ */
+struct ConfigurationParseResult {
+    SceneSnapshot            snapshot;
+    std::vector<std::string> errors;
+
+    [[nodiscard]] bool Ok() const { return errors.empty(); }
+};
+
+namespace detail {
+
+inline std::string TrimConfigurationText(const std::string &text)
+{
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return {};
+    }
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+// Returns the line up to its comment. '#' and ';' only start a comment at the beginning of
+// the line or after whitespace, never inside double quotes, and never as the first
+// character of a value, so "#ff8800", "a;b" and "x # y" in quotes survive.
+inline std::string StripConfigurationComment(const std::string &line)
+{
+    bool quoted = false;
+    bool inValue = false;
+    bool valueStarted = false;
+    for (std::size_t index = 0; index < line.size(); ++index) {
+        const char character = line[index];
+        const bool blank = character == ' ' || character == '\t';
+        const bool afterBlank = index == 0 || line[index - 1] == ' ' || line[index - 1] == '\t';
+        if (character == '"') {
+            quoted = !quoted;
+        } else if ((character == '#' || character == ';') && !quoted && afterBlank &&
+                   (!inValue || valueStarted)) {
+            return line.substr(0, index);
+        } else if (character == '=' && !inValue) {
+            inValue = true;
+            continue;
+        }
+        valueStarted = valueStarted || (inValue && !blank);
+    }
+    return line;
+}
+
+} // namespace detail
+
+/**
+ * @brief Parses the line-oriented scene configuration format into a snapshot.
+ *
+ * Each object starts with a "[object-id]" header followed by "field = value" lines; '#'
+ * and ';' start comments at the beginning of a line or after whitespace that follows some
+ * text, outside double quotes, so "color = #ff8800" keeps its value. Quotes are kept in
+ * the value. The reserved "type" field sets SceneObjectState::type and the
+ * optional "bounds" field ("minX minY maxX maxY" in meters) sets its bounds; objects
+ * without bounds are treated as affecting the whole scene. Both remain visible as
+ * ordinary fields so field-level diffs report them.
+ */
+inline ConfigurationParseResult ParseSceneConfiguration(const std::string &document)
+{
+    ConfigurationParseResult result;
+    std::istringstream stream(document);
+    std::string line;
+    std::size_t lineNumber = 0;
+    SceneObjectState current;
+    bool haveObject = false;
+
+    const auto error = [&](const std::string &message) {
+        result.errors.push_back("line " + std::to_string(lineNumber) + ": " + message);
+    };
+    const auto flush = [&]() {
+        if (!haveObject) {
+            return;
+        }
+        if (result.snapshot.Find(current.id)) {
+            error("duplicate object '" + current.id + "'");
+        }
+        result.snapshot.SetObject(current);
+    };
+
+    while (std::getline(stream, line)) {
+        ++lineNumber;
+        const std::string text =
+            detail::TrimConfigurationText(detail::StripConfigurationComment(line));
+        if (text.empty()) {
+            continue;
+        }
+
+        if (text.front() == '[') {
+            if (text.back() != ']' || text.size() < 3) {
+                error("malformed object header");
+                continue;
+            }
+            flush();
+            current = SceneObjectState{};
+            current.id = detail::TrimConfigurationText(text.substr(1, text.size() - 2));
+            current.bounds = SceneBounds::Everywhere();
+            haveObject = true;
+            continue;
+        }
+
+        const auto equals = text.find('=');
+        if (equals == std::string::npos) {
+            error("expected 'field = value'");
+            continue;
+        }
+        if (!haveObject) {
+            error("field outside of an object section");
+            continue;
+        }
+        const std::string field = detail::TrimConfigurationText(text.substr(0, equals));
+        const std::string value = detail::TrimConfigurationText(text.substr(equals + 1));
+        if (field.empty()) {
+            error("empty field name");
+            continue;
+        }
+        current.fields[field] = value;
+
+        if (field == "type") {
+            current.type = value;
+        } else if (field == "bounds") {
+            std::istringstream numbers(value);
+            SceneBounds bounds;
+            if (!(numbers >> bounds.minX >> bounds.minY >> bounds.maxX >> bounds.maxY)) {
+                error("bounds expects four numbers");
+                continue;
+            }
+            current.bounds = bounds;
+        }
+    }
+    flush();
+    return result;
+}
+
+/**
+ * @brief Reads and parses a scene configuration file.
+ */
+inline ConfigurationParseResult LoadSceneConfiguration(const std::string &path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        ConfigurationParseResult result;
+        result.errors.push_back("cannot open configuration '" + path + "'");
+        return result;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    return ParseSceneConfiguration(contents.str());
+}
+
+} // namespace rfmodel::engine
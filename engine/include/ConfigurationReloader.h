@@ -0,0 +1,116 @@
+#pragma once
+
+#include "ConfigurationChangeSet.h"
+#include "ConfigurationDocument.h"
+#include "ISimulationSystem.h"
+#include "SceneSnapshot.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Outcome of a configuration reload.
+ */
+struct ConfigurationReloadResult {
+    /** True when the new configuration was parsed and became the live configuration. */
+    bool                     applied{false};
+    std::vector<std::string> errors;
+    ConfigurationChangeSet   changes;
+};
+
+/**
+ * @brief Parses new configurations, diffs them against the live scene, and notifies systems.
+ *
+ * Only changed objects are written into the next live snapshot, which is branched from the
+ * previous one; unchanged object states stay shared, so results cached against the old
+ * snapshot (see SnapshotResultCache) remain valid wherever the reload did not reach.
+ * Documents that fail to parse leave the live configuration untouched.
+ */
+class ConfigurationReloader {
+public:
+    explicit ConfigurationReloader(SceneSnapshot live = {}) : live_(std::move(live)) {}
+
+    /**
+     * @brief Registers a system to receive change sets.
+     */
+    void AddSystem(std::shared_ptr<ISimulationSystem> system)
+    {
+        if (system) {
+            systems_.push_back(std::move(system));
+        }
+    }
+
+    /**
+     * @brief Unregisters a previously added system.
+     */
+    void RemoveSystem(const std::shared_ptr<ISimulationSystem> &system)
+    {
+        systems_.erase(std::remove(systems_.begin(), systems_.end(), system), systems_.end());
+    }
+
+    /**
+     * @brief Returns the live configuration snapshot.
+     */
+    [[nodiscard]] const SceneSnapshot &Live() const { return live_; }
+
+    /**
+     * @brief Applies a configuration document held in memory.
+     */
+    ConfigurationReloadResult Reload(const std::string &sourceIdentifier,
+                                     const std::string &document)
+    {
+        return Apply(sourceIdentifier, ParseSceneConfiguration(document));
+    }
+
+    /**
+     * @brief Reads and applies a configuration file.
+     */
+    ConfigurationReloadResult ReloadFile(const std::string &path)
+    {
+        return Apply(path, LoadSceneConfiguration(path));
+    }
+
+private:
+    ConfigurationReloadResult Apply(const std::string &sourceIdentifier,
+                                    ConfigurationParseResult parsed)
+    {
+        ConfigurationReloadResult result;
+        if (!parsed.Ok()) {
+            result.errors = std::move(parsed.errors);
+            return result;
+        }
+
+        result.changes = MakeConfigurationChangeSet(live_, parsed.snapshot, sourceIdentifier);
+        result.applied = true;
+        if (result.changes.Empty()) {
+            return result;
+        }
+
+        SceneSnapshot next = live_.Branch();
+        for (const ConfigurationObjectChange &change : result.changes.objects) {
+            if (change.after) {
+                next.SetObject(*change.after);
+            } else {
+                next.RemoveObject(change.id);
+            }
+        }
+        live_ = std::move(next);
+
+        for (const auto &system : systems_) {
+            if (!system->OnConfigurationChanged(result.changes)) {
+                system->OnConfigurationReload(sourceIdentifier);
+            }
+        }
+        return result;
+    }
+
+    SceneSnapshot                                   live_;
+    std::vector<std::shared_ptr<ISimulationSystem>> systems_;
+};
+
+} // namespace rfmodel::engine
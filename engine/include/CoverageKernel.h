@@ -0,0 +1,192 @@
+#pragma once
+
+#include "AdaptiveCoverageSampler.h"
+#include "CoverageRaster.h"
+#include "ScalarPrecision.h"
+#include "TransmitterState.h"
+
+#include "rfmodel/math/Constants.h"
+#include "rfmodel/math/Decibel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Free-space coverage kernel templated on the scalar type used for the hot loops.
+ *
+ * Each transmitter contributes a free-space (Friis) field phasor and contributions are
+ * summed coherently, so the kernel yields both received power and carrier phase.
+ * Transmitter data is held as structure-of-arrays and rasters are evaluated a row at a
+ * time so the inner loop over columns vectorizes; with Scalar = float every vector
+ * register carries twice as many lanes as the double instantiation.
+ */
+template <typename Scalar>
+class CoverageKernel {
+    static_assert(std::is_floating_point<Scalar>::value,
+                  "CoverageKernel requires a floating-point type");
+
+public:
+    using Raster = BasicCoverageRaster<Scalar>;
+
+    explicit CoverageKernel(const std::vector<TransmitterState> &transmitters,
+                            double receiverHeightMeters = 0.0)
+        : receiverHeight_(static_cast<Scalar>(receiverHeightMeters))
+    {
+        for (const TransmitterState &transmitter : transmitters) {
+            const double wavelength = transmitter.WavelengthMeters();
+            const double referenceGain = wavelength / (4.0 * math::kPi);
+            x_.push_back(static_cast<Scalar>(transmitter.positionMeters[0]));
+            y_.push_back(static_cast<Scalar>(transmitter.positionMeters[1]));
+            z_.push_back(static_cast<Scalar>(transmitter.positionMeters[2]));
+            wavenumber_.push_back(static_cast<Scalar>(math::kTwoPi / wavelength));
+            // Field amplitude at 1 m in sqrt(mW); power at distance d is (amplitude / d)^2.
+            amplitude_.push_back(static_cast<Scalar>(
+                math::decibelsToAmplitude(transmitter.powerDbm) * referenceGain));
+            // Clamp to the distance where free-space gain reaches unity.
+            minimumDistance_.push_back(static_cast<Scalar>(referenceGain));
+        }
+    }
+
+    /**
+     * @brief Returns the number of transmitters folded into the kernel.
+     */
+    [[nodiscard]] std::size_t TransmitterCount() const { return x_.size(); }
+
+    /**
+     * @brief Evaluates received power in dBm, and optionally phase, at every cell center.
+     */
+    void Evaluate(const RasterGeometry &geometry, Raster &powerDbm,
+                  Raster *phaseRadians = nullptr) const
+    {
+        powerDbm = Raster(geometry);
+        if (phaseRadians != nullptr) {
+            *phaseRadians = Raster(geometry);
+        }
+
+        const std::size_t columns = geometry.columns;
+        std::vector<Scalar> xs(columns);
+        std::vector<Scalar> real(columns);
+        std::vector<Scalar> imag(columns);
+        for (std::size_t column = 0; column < columns; ++column) {
+            xs[column] = static_cast<Scalar>(geometry.CellCenterX(column));
+        }
+
+        for (std::size_t row = 0; row < geometry.rows; ++row) {
+            const auto y = static_cast<Scalar>(geometry.CellCenterY(row));
+            AccumulateRow(xs.data(), y, columns, real.data(), imag.data());
+
+            Scalar *powerRow = powerDbm.Values().data() + row * columns;
+            for (std::size_t column = 0; column < columns; ++column) {
+                powerRow[column] = ToDbm(real[column] * real[column] + imag[column] * imag[column]);
+            }
+            if (phaseRadians != nullptr) {
+                Scalar *phaseRow = phaseRadians->Values().data() + row * columns;
+                for (std::size_t column = 0; column < columns; ++column) {
+                    phaseRow[column] = std::atan2(imag[column], real[column]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluates received power and phase at a single position.
+     */
+    [[nodiscard]] CoverageSample EvaluatePoint(double xMeters, double yMeters) const
+    {
+        const auto x = static_cast<Scalar>(xMeters);
+        Scalar real{0};
+        Scalar imag{0};
+        AccumulateRow(&x, static_cast<Scalar>(yMeters), 1, &real, &imag);
+        return CoverageSample{static_cast<double>(ToDbm(real * real + imag * imag)),
+                              static_cast<double>(std::atan2(imag, real))};
+    }
+
+private:
+    void AccumulateRow(const Scalar *xs, Scalar y, std::size_t count, Scalar *real,
+                       Scalar *imag) const
+    {
+        std::fill(real, real + count, Scalar{0});
+        std::fill(imag, imag + count, Scalar{0});
+        for (std::size_t t = 0; t < x_.size(); ++t) {
+            const Scalar dy = y - y_[t];
+            const Scalar dz = receiverHeight_ - z_[t];
+            const Scalar dyz = dy * dy + dz * dz;
+            const Scalar tx = x_[t];
+            const Scalar k = wavenumber_[t];
+            const Scalar amplitude = amplitude_[t];
+            const Scalar minimumDistance = minimumDistance_[t];
+            for (std::size_t i = 0; i < count; ++i) {
+                const Scalar dx = xs[i] - tx;
+                const Scalar distance = std::max(std::sqrt(dx * dx + dyz), minimumDistance);
+                const Scalar magnitude = amplitude / distance;
+                const Scalar phase = k * distance;
+                real[i] += magnitude * std::cos(phase);
+                imag[i] -= magnitude * std::sin(phase);
+            }
+        }
+    }
+
+    static Scalar ToDbm(Scalar powerMilliwatts)
+    {
+        const Scalar floor = std::numeric_limits<Scalar>::min();
+        return Scalar{10} * std::log10(std::max(powerMilliwatts, floor));
+    }
+
+    std::vector<Scalar> x_;
+    std::vector<Scalar> y_;
+    std::vector<Scalar> z_;
+    std::vector<Scalar> wavenumber_;
+    std::vector<Scalar> amplitude_;
+    std::vector<Scalar> minimumDistance_;
+    Scalar              receiverHeight_;
+};
+
+/**
+ * @brief Evaluates a received power raster at the requested precision.
+ *
+ * The kernel runs at the selected precision; the result is widened to double for display
+ * and export code that is not precision aware.
+ */
+inline CoverageRaster EvaluateCoveragePowerDbm(ScalarPrecision precision,
+                                               const std::vector<TransmitterState> &transmitters,
+                                               const RasterGeometry &geometry,
+                                               double receiverHeightMeters = 0.0)
+{
+    return DispatchPrecision(precision, [&](auto tag) {
+        using Scalar = typename decltype(tag)::type;
+        const CoverageKernel<Scalar> kernel(transmitters, receiverHeightMeters);
+        BasicCoverageRaster<Scalar> power;
+        kernel.Evaluate(geometry, power);
+
+        CoverageRaster widened(geometry);
+        std::transform(power.Values().begin(), power.Values().end(), widened.Values().begin(),
+                       [](Scalar value) { return static_cast<double>(value); });
+        return widened;
+    });
+}
+
+/**
+ * @brief Wraps a kernel of the requested precision as an adaptive sampler evaluator.
+ */
+inline AdaptiveCoverageSampler::Evaluator MakeCoverageEvaluator(
+    ScalarPrecision precision, const std::vector<TransmitterState> &transmitters,
+    double receiverHeightMeters = 0.0)
+{
+    return DispatchPrecision(precision, [&](auto tag) -> AdaptiveCoverageSampler::Evaluator {
+        using Scalar = typename decltype(tag)::type;
+        auto kernel =
+            std::make_shared<const CoverageKernel<Scalar>>(transmitters, receiverHeightMeters);
+        return [kernel](double xMeters, double yMeters) {
+            return kernel->EvaluatePoint(xMeters, yMeters);
+        };
+    });
+}
+
+} // namespace rfmodel::engine
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Describes the placement and resolution of a regular coverage raster.
+ *
+ * The origin is the lower-left corner of the raster in scene meters. Rows grow along +Y
+ * and columns along +X, matching the canvas conventions in docs/UnitsAndConventions.md.
+ */
+struct RasterGeometry {
+    double originX{0.0};
+    double originY{0.0};
+    double cellSizeMeters{1.0};
+    std::size_t columns{0};
+    std::size_t rows{0};
+
+    /**
+     * @brief Returns the X coordinate of the given column's cell center in meters.
+     */
+    [[nodiscard]] double CellCenterX(std::size_t column) const
+    {
+        return originX + (static_cast<double>(column) + 0.5) * cellSizeMeters;
+    }
+
+    /**
+     * @brief Returns the Y coordinate of the given row's cell center in meters.
+     */
+    [[nodiscard]] double CellCenterY(std::size_t row) const
+    {
+        return originY + (static_cast<double>(row) + 0.5) * cellSizeMeters;
+    }
+
+    /**
+     * @brief Returns the raster extent along X in meters.
+     */
+    [[nodiscard]] double Width() const { return static_cast<double>(columns) * cellSizeMeters; }
+
+    /**
+     * @brief Returns the raster extent along Y in meters.
+     */
+    [[nodiscard]] double Height() const { return static_cast<double>(rows) * cellSizeMeters; }
+
+    /**
+     * @brief Returns the number of cells in the raster.
+     */
+    [[nodiscard]] std::size_t CellCount() const { return columns * rows; }
+};
+
+/**
+ * @brief Row-major grid of scalar samples used for heatmap display and export.
+ *
+ * The sample type follows the precision of the kernel that produced the raster so the
+ * single-precision path also halves raster memory traffic.
+ */
+template <typename Scalar>
+class BasicCoverageRaster {
+public:
+    using value_type = Scalar;
+
+    BasicCoverageRaster() = default;
+
+    explicit BasicCoverageRaster(const RasterGeometry &geometry, Scalar fillValue = Scalar{0})
+        : geometry_(geometry), values_(geometry.CellCount(), fillValue)
+    {
+    }
+
+    /**
+     * @brief Returns the placement and resolution of the raster.
+     */
+    [[nodiscard]] const RasterGeometry &Geometry() const { return geometry_; }
+
+    /**
+     * @brief Returns the sample stored at the given cell.
+     */
+    [[nodiscard]] Scalar At(std::size_t column, std::size_t row) const
+    {
+        return values_[row * geometry_.columns + column];
+    }
+
+    /**
+     * @brief Overwrites the sample stored at the given cell.
+     */
+    void Set(std::size_t column, std::size_t row, Scalar value)
+    {
+        values_[row * geometry_.columns + column] = value;
+    }
+
+    /**
+     * @brief Provides contiguous row-major access to the samples.
+     */
+    [[nodiscard]] const std::vector<Scalar> &Values() const { return values_; }
+
+    /**
+     * @brief Provides mutable contiguous row-major access to the samples.
+     */
+    [[nodiscard]] std::vector<Scalar> &Values() { return values_; }
+
+private:
+    RasterGeometry      geometry_{};
+    std::vector<Scalar> values_;
+};
+
+using CoverageRaster = BasicCoverageRaster<double>;
+using CoverageRasterf = BasicCoverageRaster<float>;
+
+} // namespace rfmodel::engine
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief A diffracting wall endpoint; walls meeting at a corner share one edge.
+ */
+struct DiffractionEdge {
+    math::Vec2d              position;
+    std::vector<std::size_t> walls;
+};
+
+/**
+ * @brief Returns true when no wall other than the listed ones crosses the segment a-b.
+ */
+inline bool IsSegmentClear(const WallIndex &index, const math::Vec2d &a, const math::Vec2d &b,
+                           const std::vector<std::size_t> &ignoredWalls)
+{
+    for (const WallHit &hit : index.Crossings(a, b)) {
+        if (std::find(ignoredWalls.begin(), ignoredWalls.end(), hit.wallIndex) ==
+            ignoredWalls.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Precomputed visibility of every diffracting edge for a static floorplan.
+ *
+ * For each edge the cache stores which cells of the wall grid it may see, plus the inverse
+ * map from cell to edges. Path searches look up the receiver's cell to get the few edges
+ * worth testing exactly, so the sets are conservative: a cell is only left out when a
+ * single wall line hides the whole cell from the edge, i.e. every segment from the edge to
+ * the cell crosses the line inside one run of collinear walls (the test of
+ * PotentiallyVisibleSet). A cell seen through a gap narrower than a cell stays visible.
+ *
+ * Building costs edges x cells x wall lines and is meant to run once per floorplan.
+ */
+class EdgeVisibilityCache {
+public:
+    explicit EdgeVisibilityCache(const WallIndex &index) : index_(index)
+    {
+        CollectEdges();
+        const std::vector<WallLine> lines = CollectWallLines(index);
+        const std::size_t cells = index.CellCount();
+        words_ = (cells + 63) / 64;
+        cellBits_.assign(edges_.size() * words_, 0);
+        edgesByCell_.assign(cells, {});
+        std::vector<int> sides(lines.size());
+
+        const double size = index.CellSize();
+        for (std::size_t cell = 0; cell < cells; ++cell) {
+            const math::Vec2d origin = index.CellOrigin(cell);
+            const math::Vec2d corners[4] = {origin, origin + math::Vec2d{size, 0.0},
+                                            origin + math::Vec2d{size, size},
+                                            origin + math::Vec2d{0.0, size}};
+            for (std::size_t line = 0; line < lines.size(); ++line) {
+                sides[line] = lines[line].Side(corners, 4);
+            }
+            for (std::size_t edge = 0; edge < edges_.size(); ++edge) {
+                // Lines through the edge itself, including its own walls, never hide a cell.
+                const math::Vec2d ends[2] = {edges_[edge].position, edges_[edge].position};
+                bool hidden = false;
+                for (std::size_t line = 0; line < lines.size() && !hidden; ++line) {
+                    hidden = sides[line] != 0 && lines[line].Side(ends, 2) == -sides[line] &&
+                             lines[line].Blocks(corners, ends);
+                }
+                if (!hidden) {
+                    cellBits_[edge * words_ + cell / 64] |= std::uint64_t{1} << (cell % 64);
+                    edgesByCell_[cell].push_back(edge);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] const WallIndex &Index() const { return index_; }
+    [[nodiscard]] const std::vector<DiffractionEdge> &Edges() const { return edges_; }
+
+    /**
+     * @brief Returns true when the edge may see some point of the given grid cell.
+     */
+    [[nodiscard]] bool SeesCell(std::size_t edge, std::size_t cell) const
+    {
+        return (cellBits_[edge * words_ + cell / 64] >> (cell % 64)) & 1U;
+    }
+
+    /**
+     * @brief Returns the edges that may see some point of the given grid cell.
+     */
+    [[nodiscard]] const std::vector<std::size_t> &EdgesSeeingCell(std::size_t cell) const
+    {
+        return edgesByCell_[cell];
+    }
+
+private:
+    void CollectEdges()
+    {
+        constexpr double kMergeDistance = 1e-6;
+        for (std::size_t wall = 0; wall < index_.WallCount(); ++wall) {
+            for (const math::Vec2d &point : {index_.Wall(wall).start, index_.Wall(wall).end}) {
+                auto existing = std::find_if(edges_.begin(), edges_.end(),
+                                             [&](const DiffractionEdge &edge) {
+                                                 return (edge.position - point).length() <
+                                                        kMergeDistance;
+                                             });
+                if (existing == edges_.end()) {
+                    edges_.push_back(DiffractionEdge{point, {wall}});
+                } else {
+                    existing->walls.push_back(wall);
+                }
+            }
+        }
+    }
+
+    const WallIndex                      &index_;
+    std::vector<DiffractionEdge>          edges_;
+    std::size_t                           words_{0};
+    std::vector<std::uint64_t>            cellBits_;
+    std::vector<std::vector<std::size_t>> edgesByCell_;
+};
+
+/**
+ * @brief Work counters reported by DiffractionSolver::Solve().
+ */
+struct DiffractionStatistics {
+    /** Edges that may see the receiver's cell and belong to a wall blocking the direct path. */
+    std::size_t candidates{0};
+    /** Candidates skipped because even a 6 dB edge loss leaves them below sensitivity. */
+    std::size_t pruned{0};
+    /** Candidates rejected by the exact visibility test. */
+    std::size_t occluded{0};
+    std::size_t paths{0};
+};
+
+/**
+ * @brief Finds single knife-edge diffraction paths into the shadow of walls.
+ *
+ * Only edges of walls that block the direct transmitter-receiver line are considered, so
+ * diffraction fills shadows without duplicating lit-region paths. Both legs must be
+ * unobstructed. The diffraction loss itself is applied by PathEvaluator from the path
+ * geometry (KnifeEdgeLossDb()).
+ */
+class DiffractionSolver {
+public:
+    DiffractionSolver(const EdgeVisibilityCache &cache, PropagationSettings settings)
+        : cache_(cache), settings_(settings)
+    {
+    }
+
+    /**
+     * @param budget Optional; edges that cannot reach sensitivity are skipped before any
+     *               visibility test.
+     */
+    [[nodiscard]] std::vector<PropagationPath> Solve(const math::Vec3d &transmitter,
+                                                     const math::Vec3d &receiver,
+                                                     const LinkBudget *budget = nullptr,
+                                                     DiffractionStatistics *statistics = nullptr)
+        const
+    {
+        DiffractionStatistics counters;
+        std::vector<PropagationPath> paths;
+        const WallIndex &index = cache_.Index();
+        const math::Vec2d from{transmitter.x, transmitter.y};
+        const math::Vec2d to{receiver.x, receiver.y};
+        const double rise = receiver.z - transmitter.z;
+
+        std::vector<std::size_t> blocking;
+        for (const WallHit &hit : index.Crossings(from, to)) {
+            blocking.push_back(hit.wallIndex);
+        }
+
+        // No shadow, nothing to diffract into. Receivers outside the wall grid fall back to
+        // testing every edge.
+        std::vector<std::size_t> candidates;
+        if (!blocking.empty()) {
+            if (const auto cell = index.CellAt(to)) {
+                candidates = cache_.EdgesSeeingCell(*cell);
+            } else {
+                candidates.resize(cache_.Edges().size());
+                for (std::size_t edge = 0; edge < candidates.size(); ++edge) {
+                    candidates[edge] = edge;
+                }
+            }
+        }
+
+        for (const std::size_t edgeIndex : candidates) {
+            const DiffractionEdge &edge = cache_.Edges()[edgeIndex];
+            const auto blocker = std::find_first_of(edge.walls.begin(), edge.walls.end(),
+                                                    blocking.begin(), blocking.end());
+            if (blocker == edge.walls.end()) {
+                continue;
+            }
+            ++counters.candidates;
+
+            const double first = (edge.position - from).length();
+            const double second = (to - edge.position).length();
+            const double planLength = first + second;
+            const double length = std::sqrt(planLength * planLength + rise * rise);
+            if (length > settings_.maxPathLengthMeters ||
+                (budget != nullptr &&
+                 !budget->CanReach(length, KnifeEdgeLossDb(0.0), settings_.pruningMarginDb))) {
+                ++counters.pruned;
+                continue;
+            }
+            if (!IsSegmentClear(index, from, edge.position, edge.walls) ||
+                !IsSegmentClear(index, edge.position, to, edge.walls)) {
+                ++counters.occluded;
+                continue;
+            }
+
+            PropagationPath path;
+            path.lengthMeters = length;
+            path.vertices = {transmitter,
+                             math::Vec3d{edge.position.x, edge.position.y,
+                                         transmitter.z + rise * first / planLength},
+                             receiver};
+            path.interactions.push_back(
+                PathInteraction{InteractionType::Diffraction, *blocker, 0.0});
+            paths.push_back(std::move(path));
+        }
+        counters.paths = paths.size();
+        if (statistics != nullptr) {
+            *statistics = counters;
+        }
+        return paths;
+    }
+
+private:
+    const EdgeVisibilityCache &cache_;
+    PropagationSettings        settings_;
+};
+
+} // namespace rfmodel::engine
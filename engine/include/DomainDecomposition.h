@@ -0,0 +1,520 @@
+#pragma once
+
+#include "IReceiver.h"
+#include "ISimulationObject.h"
+#include "ITransmitter.h"
+#include "ImageMethodSolver.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "WallGeometry.h"
+#include "WorkerPool.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Axis-aligned plan-view box, closed at the minimum and open at the maximum.
+ *
+ * Regions on the outside of a decomposition extend to infinity, so the regions tile the
+ * whole plane and every point belongs to exactly one of them.
+ */
+struct DomainBounds {
+    double minX{-std::numeric_limits<double>::infinity()};
+    double minY{-std::numeric_limits<double>::infinity()};
+    double maxX{std::numeric_limits<double>::infinity()};
+    double maxY{std::numeric_limits<double>::infinity()};
+
+    [[nodiscard]] bool Contains(const math::Vec2d &point) const
+    {
+        return point.x >= minX && point.x < maxX && point.y >= minY && point.y < maxY;
+    }
+
+    [[nodiscard]] DomainBounds Expanded(double margin) const
+    {
+        return DomainBounds{minX - margin, minY - margin, maxX + margin, maxY + margin};
+    }
+
+    /**
+     * @brief Clips a + t * (b - a) to the closed box; returns the t range or nullopt.
+     */
+    [[nodiscard]] std::optional<std::pair<double, double>> Clip(const math::Vec2d &a,
+                                                                const math::Vec2d &b,
+                                                                double tMin = 0.0,
+                                                                double tMax = 1.0) const
+    {
+        const double start[2] = {a.x, a.y};
+        const double step[2] = {b.x - a.x, b.y - a.y};
+        const double lower[2] = {minX, minY};
+        const double upper[2] = {maxX, maxY};
+        for (int axis = 0; axis < 2; ++axis) {
+            if (step[axis] == 0.0) {
+                if (start[axis] < lower[axis] || start[axis] > upper[axis]) {
+                    return std::nullopt;
+                }
+                continue;
+            }
+            double t0 = (lower[axis] - start[axis]) / step[axis];
+            double t1 = (upper[axis] - start[axis]) / step[axis];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            tMin = std::max(tMin, t0);
+            tMax = std::min(tMax, t1);
+        }
+        if (tMin > tMax) {
+            return std::nullopt;
+        }
+        return std::make_pair(tMin, tMax);
+    }
+};
+
+/**
+ * @brief Tuning for DomainDecomposition.
+ */
+struct DomainDecompositionOptions {
+    /** Number of regions; zero uses one per pool thread. */
+    std::size_t regions{0};
+    /**
+     * Walls within this distance of a region are copied into it, and an object only
+     * migrates once it is this far outside its region. Must be positive: it also absorbs
+     * rounding of crossing points that land exactly on a region boundary.
+     */
+    double haloMeters{1.0};
+    /** Grid pitch of each region's wall index; zero picks one from the mean wall length. */
+    double cellSizeMeters{0.0};
+};
+
+/**
+ * @brief Work and traffic counters of a DomainDecomposition.
+ */
+struct DomainStatistics {
+    /** Segment and ray queries answered. */
+    std::size_t queries{0};
+    /** Queries that spanned more than one region and were split between them. */
+    std::size_t splitQueries{0};
+    /** Queries run against a region's local wall index. */
+    std::size_t regionQueries{0};
+    /** Objects handed from one region to another by StepObjects(). */
+    std::size_t migrations{0};
+};
+
+/**
+ * @brief Spatial partition of a large scene into regions stepped and traced in parallel.
+ *
+ * The plan is split by recursive bisection at the median wall midpoint, always splitting the
+ * region with the most walls, so regions carry similar wall counts. Each region keeps its own
+ * copy of the walls that reach into it or its halo, together with a WallIndex over them, and
+ * owns the simulation objects located inside it; regions build their structures and step
+ * their objects concurrently on a WorkerPool.
+ *
+ * Wall queries follow the interface of WallIndex, so TraceReflectionPath() runs unchanged on
+ * a decomposition. A segment that stays inside one region is answered by that region alone;
+ * one that crosses regions is split: each region whose halo it touches tests the full
+ * segment against its own walls and contributes only the crossings whose point lies inside
+ * its bounds. Intersections are computed from the same global coordinates as in a single
+ * WallIndex, so results are bit-identical to a monolithic run.
+ *
+ * Objects migrate to another region when they move further than the halo outside their
+ * own, which keeps objects on a boundary from bouncing between regions. Because regions step
+ * their objects concurrently, objects must not modify each other in Step(). The wall vector
+ * must outlive the decomposition.
+ *
+ * Decomposition spreads work, not memory: region wall lists are copies on top of the global
+ * wall vector, halo walls are held by several regions, and Solve() builds the full image
+ * tree on the calling thread. A scene must therefore still fit in memory as a whole.
+ */
+class DomainDecomposition {
+public:
+    /** Returns an object's plan-view position, or nullopt for objects without one. */
+    using ObjectLocator = std::function<std::optional<math::Vec2d>(const ISimulationObject &)>;
+
+    DomainDecomposition(const std::vector<WallSegment> &walls, WorkerPool &pool,
+                        DomainDecompositionOptions options = {})
+        : walls_(walls), pool_(pool), options_(options)
+    {
+        options_.haloMeters = std::max(options_.haloMeters, 1e-6);
+        const std::size_t target = std::max<std::size_t>(
+            1, options_.regions == 0 ? pool_.Size() : options_.regions);
+        for (const DomainBounds &bounds : Partition(target)) {
+            regions_.push_back(std::make_unique<Region>());
+            regions_.back()->bounds = bounds;
+        }
+        pool_.ParallelFor(regions_.size(), [this](std::size_t region) { BuildRegion(region); });
+    }
+
+    DomainDecomposition(const DomainDecomposition &) = delete;
+    DomainDecomposition &operator=(const DomainDecomposition &) = delete;
+
+    /**
+     * @brief Default locator: transmitters and receivers report their position.
+     */
+    static std::optional<math::Vec2d> LocateObject(const ISimulationObject &object)
+    {
+        if (const auto *transmitter = dynamic_cast<const ITransmitter *>(&object)) {
+            const auto position = transmitter->Position();
+            return math::Vec2d{position[0], position[1]};
+        }
+        if (const auto *receiver = dynamic_cast<const IReceiver *>(&object)) {
+            const auto position = receiver->Position();
+            return math::Vec2d{position[0], position[1]};
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::size_t RegionCount() const { return regions_.size(); }
+    [[nodiscard]] const DomainBounds &RegionBounds(std::size_t region) const
+    {
+        return regions_[region]->bounds;
+    }
+
+    /**
+     * @brief Returns the number of walls the region holds, including those in its halo.
+     */
+    [[nodiscard]] std::size_t RegionWallCount(std::size_t region) const
+    {
+        return regions_[region]->walls.size();
+    }
+
+    /**
+     * @brief Returns the region containing a plan-view point.
+     */
+    [[nodiscard]] std::size_t RegionAt(const math::Vec2d &point) const
+    {
+        for (std::size_t region = 0; region < regions_.size(); ++region) {
+            if (regions_[region]->bounds.Contains(point)) {
+                return region;
+            }
+        }
+        return 0;
+    }
+
+    [[nodiscard]] std::size_t WallCount() const { return walls_.size(); }
+    [[nodiscard]] const WallSegment &Wall(std::size_t index) const { return walls_[index]; }
+
+    /**
+     * @brief Lists the walls crossed by the segment from a to b, as WallIndex::Crossings().
+     */
+    [[nodiscard]] std::vector<WallHit> Crossings(const math::Vec2d &a, const math::Vec2d &b,
+                                                 std::size_t ignoreA = WallIndex::kNoWall,
+                                                 std::size_t ignoreB = WallIndex::kNoWall) const
+    {
+        std::vector<WallHit> hits;
+        const math::Vec2d direction = b - a;
+        std::size_t touched = 0;
+        for (const auto &region : regions_) {
+            if (!region->reach.Clip(a, b)) {
+                continue;
+            }
+            ++touched;
+            for (WallHit hit : region->index.Crossings(a, b, region->Local(ignoreA),
+                                                       region->Local(ignoreB))) {
+                if (region->bounds.Contains(a + direction * hit.t)) {
+                    hit.wallIndex = region->globalIds[hit.wallIndex];
+                    hits.push_back(hit);
+                }
+            }
+        }
+        Count(touched);
+        std::sort(hits.begin(), hits.end(), [](const WallHit &lhs, const WallHit &rhs) {
+            return lhs.t != rhs.t ? lhs.t < rhs.t : lhs.wallIndex < rhs.wallIndex;
+        });
+        return hits;
+    }
+
+    /**
+     * @brief Returns the nearest wall hit by origin + t * direction, as WallIndex::FirstHit().
+     */
+    [[nodiscard]] WallHit FirstHit(const math::Vec2d &origin, const math::Vec2d &direction,
+                                   double tMin, double tMax,
+                                   std::size_t ignoreWall = WallIndex::kNoWall) const
+    {
+        // Regions whose reach the ray enters, nearest entry first. A region only accepts hits
+        // inside its own bounds, which lie beyond that entry, so the walk can stop once the
+        // best hit precedes the next entry.
+        std::vector<std::pair<double, const Region *>> along;
+        for (const auto &region : regions_) {
+            if (const auto range = region->reach.Clip(origin, origin + direction, tMin, tMax)) {
+                along.emplace_back(range->first, region.get());
+            }
+        }
+        std::sort(along.begin(), along.end(),
+                  [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+        Count(along.size());
+
+        WallHit best;
+        for (const auto &[entry, region] : along) {
+            if (best.t <= entry) {
+                break;
+            }
+            WallHit hit = region->index.FirstHit(origin, direction, tMin, tMax,
+                                                 region->Local(ignoreWall));
+            if (hit.Valid() && hit.t < best.t &&
+                region->bounds.Contains(origin + direction * hit.t)) {
+                hit.wallIndex = region->globalIds[hit.wallIndex];
+                best = hit;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Hands each object to the region containing it.
+     *
+     * Objects the locator cannot place stay with region 0 and never migrate.
+     */
+    void AssignObjects(const std::vector<ISimulationObject *> &objects,
+                       ObjectLocator locator = LocateObject)
+    {
+        locator_ = std::move(locator);
+        for (const auto &region : regions_) {
+            region->objects.clear();
+        }
+        for (ISimulationObject *object : objects) {
+            const std::optional<math::Vec2d> position = locator_(*object);
+            regions_[position ? RegionAt(*position) : 0]->objects.push_back(object);
+        }
+    }
+
+    [[nodiscard]] const std::vector<ISimulationObject *> &RegionObjects(std::size_t region) const
+    {
+        return regions_[region]->objects;
+    }
+
+    /**
+     * @brief Steps every object on its region's worker, then migrates objects that left
+     * their region's halo. Returns the number of migrations.
+     */
+    std::size_t StepObjects(double deltaTimeSeconds)
+    {
+        pool_.ParallelFor(regions_.size(), [&](std::size_t region) {
+            for (ISimulationObject *object : regions_[region]->objects) {
+                object->Step(deltaTimeSeconds);
+            }
+        });
+
+        std::vector<std::pair<std::size_t, ISimulationObject *>> leaving;
+        for (std::size_t region = 0; region < regions_.size(); ++region) {
+            const DomainBounds &halo = regions_[region]->reach;
+            auto &objects = regions_[region]->objects;
+            const auto stays = [&](ISimulationObject *object) {
+                const std::optional<math::Vec2d> position = locator_(*object);
+                if (!position || halo.Contains(*position)) {
+                    return true;
+                }
+                leaving.emplace_back(RegionAt(*position), object);
+                return false;
+            };
+            objects.erase(std::stable_partition(objects.begin(), objects.end(), stays),
+                          objects.end());
+        }
+        for (const auto &[region, object] : leaving) {
+            regions_[region]->objects.push_back(object);
+        }
+        migrations_ += leaving.size();
+        return leaving.size();
+    }
+
+    /**
+     * @brief Finds image-method paths from one transmitter to each receiver.
+     *
+     * The image tree is built once over all walls on the calling thread, with
+     * BuildImageTree(); each region then traces the receivers inside it on its own worker.
+     * Paths and their order match ImageMethodSolver::Solve() on a WallIndex over the same
+     * walls. Diffraction and budget pruning are not applied.
+     */
+    [[nodiscard]] std::vector<std::vector<PropagationPath>> Solve(
+        const math::Vec3d &transmitter, const std::vector<math::Vec3d> &receivers,
+        const PropagationSettings &settings, const PathEvaluator *evaluator = nullptr) const
+    {
+        const ImageTree tree = BuildImageTree(*this, transmitter, settings);
+        std::vector<std::vector<std::size_t>> owned(regions_.size());
+        for (std::size_t receiver = 0; receiver < receivers.size(); ++receiver) {
+            owned[RegionAt(math::Vec2d{receivers[receiver].x, receivers[receiver].y})]
+                .push_back(receiver);
+        }
+
+        std::vector<std::vector<PropagationPath>> paths(receivers.size());
+        pool_.ParallelFor(regions_.size(), [&](std::size_t region) {
+            std::vector<std::size_t> walls;
+            std::vector<math::Vec2d> images;
+            std::vector<std::size_t> stack;
+            for (const std::size_t receiver : owned[region]) {
+                // Same preorder walk as ImageMethodSolver::Trace(), so paths come out in the
+                // same order.
+                stack.assign(tree.nodes.empty() ? 0 : 1, 0);
+                while (!stack.empty()) {
+                    const std::size_t node = stack.back();
+                    stack.pop_back();
+                    tree.Sequence(node, walls, images);
+                    if (auto path = TraceReflectionPath(*this, transmitter, receivers[receiver],
+                                                        walls, images, settings)) {
+                        if (evaluator != nullptr) {
+                            evaluator->Apply(*path);
+                        }
+                        paths[receiver].push_back(std::move(*path));
+                    }
+                    const ImageTree::Node &current = tree.nodes[node];
+                    for (std::size_t child = current.firstChild + current.childCount;
+                         child-- > current.firstChild;) {
+                        stack.push_back(child);
+                    }
+                }
+            }
+        });
+        return paths;
+    }
+
+    [[nodiscard]] DomainStatistics Statistics() const
+    {
+        DomainStatistics statistics;
+        statistics.queries = queries_.load();
+        statistics.splitQueries = splitQueries_.load();
+        statistics.regionQueries = regionQueries_.load();
+        statistics.migrations = migrations_;
+        return statistics;
+    }
+
+private:
+    struct Region {
+        DomainBounds                     bounds;
+        /** Bounds grown by the halo; queries touching it consult the region. */
+        DomainBounds                     reach;
+        /** Copies of the walls reaching into the halo, in ascending global order. */
+        std::vector<WallSegment>         walls;
+        std::vector<std::size_t>         globalIds;
+        WallIndex                        index;
+        std::vector<ISimulationObject *> objects;
+
+        /** Maps a global wall to its local index, or kNoWall when the region lacks it. */
+        [[nodiscard]] std::size_t Local(std::size_t global) const
+        {
+            const auto found = std::lower_bound(globalIds.begin(), globalIds.end(), global);
+            return found != globalIds.end() && *found == global
+                       ? static_cast<std::size_t>(found - globalIds.begin())
+                       : WallIndex::kNoWall;
+        }
+    };
+
+    /**
+     * @brief Splits the plane into the requested number of regions.
+     */
+    [[nodiscard]] std::vector<DomainBounds> Partition(std::size_t target) const
+    {
+        struct Cell {
+            DomainBounds             bounds;
+            std::vector<std::size_t> walls;
+            bool                     splittable{true};
+        };
+        std::vector<Cell> cells(1);
+        cells[0].walls.resize(walls_.size());
+        for (std::size_t wall = 0; wall < walls_.size(); ++wall) {
+            cells[0].walls[wall] = wall;
+        }
+        const auto midpoint = [this](std::size_t wall) { return walls_[wall].PointAt(0.5); };
+
+        while (cells.size() < target) {
+            std::size_t largest = cells.size();
+            for (std::size_t cell = 0; cell < cells.size(); ++cell) {
+                if (cells[cell].splittable && cells[cell].walls.size() > 1 &&
+                    (largest == cells.size() ||
+                     cells[cell].walls.size() > cells[largest].walls.size())) {
+                    largest = cell;
+                }
+            }
+            if (largest == cells.size()) {
+                break;
+            }
+            Cell &cell = cells[largest];
+            double low[2] = {std::numeric_limits<double>::infinity(),
+                             std::numeric_limits<double>::infinity()};
+            double high[2] = {-low[0], -low[1]};
+            for (const std::size_t wall : cell.walls) {
+                const math::Vec2d point = midpoint(wall);
+                low[0] = std::min(low[0], point.x);
+                low[1] = std::min(low[1], point.y);
+                high[0] = std::max(high[0], point.x);
+                high[1] = std::max(high[1], point.y);
+            }
+            const int axis = high[0] - low[0] >= high[1] - low[1] ? 0 : 1;
+            const auto coordinate = [&](std::size_t wall) {
+                const math::Vec2d point = midpoint(wall);
+                return axis == 0 ? point.x : point.y;
+            };
+            auto middle = cell.walls.begin() + static_cast<std::ptrdiff_t>(cell.walls.size() / 2);
+            std::nth_element(cell.walls.begin(), middle, cell.walls.end(),
+                             [&](std::size_t lhs, std::size_t rhs) {
+                                 return coordinate(lhs) < coordinate(rhs);
+                             });
+            const double split = coordinate(*middle);
+            if (!(split > (axis == 0 ? low[0] : low[1]))) {
+                cell.splittable = false;
+                continue;
+            }
+            Cell upper;
+            upper.bounds = cell.bounds;
+            (axis == 0 ? upper.bounds.minX : upper.bounds.minY) = split;
+            (axis == 0 ? cell.bounds.maxX : cell.bounds.maxY) = split;
+            const auto below = std::partition(cell.walls.begin(), cell.walls.end(),
+                                              [&](std::size_t wall) {
+                                                  return coordinate(wall) < split;
+                                              });
+            upper.walls.assign(below, cell.walls.end());
+            cell.walls.erase(below, cell.walls.end());
+            cells.push_back(std::move(upper));
+        }
+
+        std::vector<DomainBounds> bounds;
+        bounds.reserve(cells.size());
+        for (const Cell &cell : cells) {
+            bounds.push_back(cell.bounds);
+        }
+        return bounds;
+    }
+
+    void BuildRegion(std::size_t index)
+    {
+        Region &region = *regions_[index];
+        region.reach = region.bounds.Expanded(options_.haloMeters);
+        for (std::size_t wall = 0; wall < walls_.size(); ++wall) {
+            if (region.reach.Clip(walls_[wall].start, walls_[wall].end)) {
+                region.walls.push_back(walls_[wall]);
+                region.globalIds.push_back(wall);
+            }
+        }
+        region.index = WallIndex(region.walls, options_.cellSizeMeters);
+    }
+
+    void Count(std::size_t regions) const
+    {
+        ++queries_;
+        regionQueries_ += regions;
+        if (regions > 1) {
+            ++splitQueries_;
+        }
+    }
+
+    const std::vector<WallSegment>      &walls_;
+    WorkerPool                          &pool_;
+    DomainDecompositionOptions           options_;
+    /** Held by pointer so each region's WallIndex can keep referring to its wall vector. */
+    std::vector<std::unique_ptr<Region>> regions_;
+    ObjectLocator                        locator_{LocateObject};
+    std::size_t                          migrations_{0};
+    mutable std::atomic<std::size_t>     queries_{0};
+    mutable std::atomic<std::size_t>     splitQueries_{0};
+    mutable std::atomic<std::size_t>     regionQueries_{0};
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "IWall.h"
+
+#include "rfmodel/math/Complex.h"
+#include "rfmodel/math/Constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rfmodel::engine {
+
+// Vacuum permittivity in farads per meter.
+constexpr double kVacuumPermittivity = 8.8541878128e-12;
+
+/**
+ * @brief Electrical and geometric properties that determine a wall's Fresnel response.
+ */
+struct WallMaterial {
+    double relativePermittivity{1.0};
+    double conductivity{0.0};
+    double thicknessMeters{0.0};
+
+    [[nodiscard]] bool operator==(const WallMaterial &other) const
+    {
+        return relativePermittivity == other.relativePermittivity &&
+               conductivity == other.conductivity && thicknessMeters == other.thicknessMeters;
+    }
+
+    [[nodiscard]] bool operator!=(const WallMaterial &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Captures the material properties exposed by a wall.
+ */
+inline WallMaterial MakeWallMaterial(const IWall &wall)
+{
+    return WallMaterial{wall.RelativePermittivity(), wall.Conductivity(), wall.Thickness()};
+}
+
+/**
+ * @brief Polarization of the incident field relative to the plane of incidence.
+ *
+ * For the 2D scene with vertical walls and vertically polarized antennas the electric
+ * field is perpendicular to the plane of incidence, i.e. TransverseElectric.
+ */
+enum class Polarization {
+    TransverseElectric,
+    TransverseMagnetic,
+};
+
+/**
+ * @brief Complex reflection and transmission coefficients of a wall for one incidence angle.
+ */
+struct FresnelCoefficients {
+    math::Complex reflectionTe;
+    math::Complex reflectionTm;
+    math::Complex transmissionTe;
+    math::Complex transmissionTm;
+
+    [[nodiscard]] math::Complex Reflection(Polarization polarization) const
+    {
+        return polarization == Polarization::TransverseElectric ? reflectionTe : reflectionTm;
+    }
+
+    [[nodiscard]] math::Complex Transmission(Polarization polarization) const
+    {
+        return polarization == Polarization::TransverseElectric ? transmissionTe : transmissionTm;
+    }
+};
+
+/**
+ * @brief Returns the complex relative permittivity eta = eps_r - j sigma / (omega eps_0).
+ */
+inline math::Complex ComplexPermittivity(const WallMaterial &material, double frequencyHz)
+{
+    const double omega = math::kTwoPi * frequencyHz;
+    return math::Complex{material.relativePermittivity,
+                         -material.conductivity / (omega * kVacuumPermittivity)};
+}
+
+/**
+ * @brief Computes slab reflection and transmission coefficients following ITU-R P.2040.
+ *
+ * The wall is modelled as a homogeneous dielectric slab in free space, including the
+ * multiple internal reflections. A zero thickness yields a transparent wall.
+ *
+ * @param incidenceRadians Angle between the incoming ray and the wall normal, in [0, pi/2].
+ */
+inline FresnelCoefficients ComputeFresnelCoefficients(const WallMaterial &material,
+                                                      double frequencyHz, double incidenceRadians)
+{
+    using math::Complex;
+
+    const double theta = std::clamp(incidenceRadians, 0.0, math::kHalfPi);
+    const double cosTheta = std::cos(theta);
+    const double sinTheta = std::sin(theta);
+    const Complex eta = ComplexPermittivity(material, frequencyHz);
+    const Complex root = math::sqrt(eta - Complex{sinTheta * sinTheta, 0.0});
+
+    const Complex gammaTe = (Complex{cosTheta, 0.0} - root) / (Complex{cosTheta, 0.0} + root);
+    const Complex gammaTm = (eta * cosTheta - root) / (eta * cosTheta + root);
+
+    // Phase thickness q = (2 pi d / lambda) sqrt(eta - sin^2 theta).
+    const double wavenumber = math::kTwoPi * frequencyHz / math::kSpeedOfLight;
+    const Complex q = root * (wavenumber * std::max(material.thicknessMeters, 0.0));
+    const Complex minusJ{0.0, -1.0};
+    const Complex singlePass = math::exp(minusJ * q);
+    const Complex doublePass = singlePass * singlePass;
+
+    const auto slab = [&](const Complex &gamma, Complex &reflection, Complex &transmission) {
+        const Complex gammaSquared = gamma * gamma;
+        const Complex denominator = Complex{1.0, 0.0} - gammaSquared * doublePass;
+        if (denominator.magnitudeSquared() <= std::numeric_limits<double>::epsilon()) {
+            // Grazing incidence on a lossless slab: the interface reflects everything.
+            reflection = gamma;
+            transmission = Complex{};
+            return;
+        }
+        reflection = gamma * (Complex{1.0, 0.0} - doublePass) / denominator;
+        transmission = (Complex{1.0, 0.0} - gammaSquared) * singlePass / denominator;
+    };
+
+    FresnelCoefficients coefficients;
+    slab(gammaTe, coefficients.reflectionTe, coefficients.transmissionTe);
+    slab(gammaTm, coefficients.reflectionTm, coefficients.transmissionTm);
+    return coefficients;
+}
+
+} // namespace rfmodel::engine
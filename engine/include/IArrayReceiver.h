@@ -0,0 +1,29 @@
+#pragma once
+
+#include "IReceiver.h"
+
+#include <array>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Receiver made of multiple antenna elements sharing one position and orientation.
+ *
+ * Element offsets are expressed in the receiver's local frame, so rotating the receiver via
+ * SetOrientation() rotates the whole array. Use AntennaArray to build standard layouts.
+ */
+class IArrayReceiver : public IReceiver {
+public:
+    /**
+     * @brief Returns the element offsets from the receiver position in local meters.
+     */
+    [[nodiscard]] virtual std::vector<std::array<double, 3>> ElementOffsets() const = 0;
+
+    /**
+     * @brief Replaces the element layout using offsets in local meters.
+     */
+    virtual void SetElementOffsets(const std::vector<std::array<double, 3>> &offsetsMeters) = 0;
+};
+
+} // namespace rfmodel::engine
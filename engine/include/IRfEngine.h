@@ -1,5 +1,8 @@
 #pragma once
 
+#include "ProbeResult.h"
+
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -55,6 +58,22 @@ public:
      */
     virtual void StepSimulation(double deltaTimeSeconds) = 0;
 
+    /**
+     * @brief Evaluates the active scene's transmitters at one receiver position.
+     *
+     * Meant to be called every frame while a receiver is dragged, so implementations answer
+     * from cached per-transmitter image trees within a fixed latency budget (see PointProbe)
+     * rather than stepping the simulation, and flag results cut short by the budget. The
+     * default suits engines without probing: it returns no links, flagged incomplete.
+     */
+    [[nodiscard]] virtual ProbeResult Probe(const std::array<double, 3> &positionMeters) const
+    {
+        static_cast<void>(positionMeters);
+        ProbeResult result;
+        result.complete = false;
+        return result;
+    }
+
     /**
      * @brief Resets the engine to a known baseline state, clearing transient data.
      */
@@ -6,6 +6,19 @@
 
 namespace rfmodel::engine {
 
+/**
+ * @brief Strategy used to advance simulation time.
+ */
+enum class SteppingMode {
+    /** Every object and system is stepped at the fixed TimeStep(). */
+    FixedStep,
+    /**
+     * Time jumps between the instants objects and systems declare through NextEventTime();
+     * idle objects are skipped until their next event.
+     */
+    EventDriven,
+};
+
 /**
  * @brief Provides metadata and timing for a simulation run.
  */
@@ -49,6 +62,33 @@ public:
      * @brief Sets an upper bound on discrete simulation steps.
      */
     virtual void SetMaxIterations(std::size_t iterations) = 0;
+
+    /**
+     * @brief Returns how simulation time is advanced; fixed steps unless overridden.
+     */
+    [[nodiscard]] virtual SteppingMode Stepping() const { return SteppingMode::FixedStep; }
+
+    /**
+     * @brief Selects how simulation time is advanced.
+     *
+     * The default ignores the request; configurations that support event-driven stepping
+     * override it together with Stepping().
+     */
+    virtual void SetStepping(SteppingMode mode) { static_cast<void>(mode); }
+
+    /**
+     * @brief Returns the shortest step taken in event-driven mode; zero unless overridden.
+     *
+     * Events closer together than this are coalesced into a single step.
+     */
+    [[nodiscard]] virtual Duration MinTimeStep() const { return Duration{0.0}; }
+
+    /**
+     * @brief Adjusts the shortest step taken in event-driven mode.
+     *
+     * The default ignores the request, like SetStepping().
+     */
+    virtual void SetMinTimeStep(Duration timeStep) { static_cast<void>(timeStep); }
 };
 
 } // namespace rfmodel::engine
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "PropagationSettings.h"
+
 #include <memory>
 #include <string>
 #include <vector>
@@ -55,6 +57,23 @@ public:
      * @brief Advances the scene-level simulation by the supplied time step in seconds.
      */
     virtual void Step(double deltaTimeSeconds) = 0;
+
+    /**
+     * @brief Returns the path-finding engine used for this scene; the image method unless
+     * overridden.
+     */
+    [[nodiscard]] virtual PropagationMethod GetPropagationMethod() const
+    {
+        return PropagationMethod::ImageMethod;
+    }
+
+    /**
+     * @brief Selects the path-finding engine used for this scene.
+     *
+     * The default ignores the request; scenes that support ray launching override it
+     * together with GetPropagationMethod().
+     */
+    virtual void SetPropagationMethod(PropagationMethod method) { static_cast<void>(method); }
 };
 
 } // namespace rfmodel::engine
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 namespace rfmodel::engine {
@@ -38,6 +39,20 @@ public:
      * @brief Resets transient state so the object can be reused in a fresh simulation run.
      */
     virtual void Reset() = 0;
+
+    /**
+     * @brief Returns the absolute simulation time in seconds at which the object next needs
+     * to be stepped, or nullopt when it stays idle until something else changes.
+     *
+     * Only consulted in SteppingMode::EventDriven. Typical events are motion waypoints,
+     * the end of a fading coherence interval, or a scheduled configuration change. The next
+     * Step() call receives the full time elapsed since the object was last stepped.
+     */
+    [[nodiscard]] virtual std::optional<double> NextEventTime(double currentTimeSeconds) const
+    {
+        static_cast<void>(currentTimeSeconds);
+        return std::nullopt;
+    }
 };
 
 } // namespace rfmodel::engine
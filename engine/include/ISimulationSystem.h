@@ -1,10 +1,12 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 namespace rfmodel::engine {
 
 class IScene;
+struct ConfigurationChangeSet;
 
 /**
  * @brief Interface for subsystems that perform domain-specific simulation work.
@@ -35,6 +37,32 @@ public:
      * @brief Signals that configuration inputs have changed and cached data should refresh.
      */
     virtual void OnConfigurationReload(const std::string &sourceIdentifier) = 0;
+
+    /**
+     * @brief Delivers the object- and field-level differences produced by a reload.
+     *
+     * Systems override this to invalidate only the caches and acceleration structures that
+     * the changed objects touch, and return true once they have. Returning false, as the
+     * default does, makes the caller fall back to a full OnConfigurationReload().
+     */
+    virtual bool OnConfigurationChanged(const ConfigurationChangeSet &changes)
+    {
+        static_cast<void>(changes);
+        return false;
+    }
+
+    /**
+     * @brief Returns the absolute simulation time in seconds at which the system next needs
+     * to run, or nullopt when it only reacts to object events.
+     *
+     * Only consulted in SteppingMode::EventDriven; systems are also stepped whenever any
+     * object event fires.
+     */
+    [[nodiscard]] virtual std::optional<double> NextEventTime(double currentTimeSeconds) const
+    {
+        static_cast<void>(currentTimeSeconds);
+        return std::nullopt;
+    }
 };
 
 } // namespace rfmodel::engine
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "SceneSnapshot.h"
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Optional interface for scenes that can capture and restore copy-on-write snapshots.
+ *
+ * Scenes implement it alongside IScene; callers discover support with dynamic_cast, so
+ * scenes without snapshot support and users that never branch a scene are unaffected.
+ */
+class ISnapshotScene {
+public:
+    virtual ~ISnapshotScene() = default;
+
+    /**
+     * @brief Captures the scene contents as a copy-on-write snapshot.
+     *
+     * Taking a snapshot must not copy object states; callers branch the result to explore
+     * alternatives and compare them with SceneSnapshot::Diff().
+     */
+    [[nodiscard]] virtual SceneSnapshot Snapshot() const = 0;
+
+    /**
+     * @brief Replaces the scene contents with those of the given snapshot.
+     *
+     * Implementations should only rebuild objects reported by SceneSnapshot::Diff() against
+     * their current snapshot.
+     */
+    virtual void RestoreSnapshot(const SceneSnapshot &snapshot) = 0;
+};
+
+} // namespace rfmodel::engine
@@ -32,6 +32,15 @@ public:
      */
     [[nodiscard]] virtual double Thickness() const = 0;
 
+    /**
+     * @brief Returns the wall extent along its face in meters.
+     *
+     * Walls are vertical; in plan view they run from Position() - tangent * Length() / 2 to
+     * Position() + tangent * Length() / 2, where tangent = (-normal.y, normal.x). The default
+     * of zero describes a wall without a footprint, which path finding never hits.
+     */
+    [[nodiscard]] virtual double Length() const { return 0.0; }
+
     /**
      * @brief Returns the relative permittivity of the wall material.
      */
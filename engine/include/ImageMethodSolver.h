@@ -0,0 +1,399 @@
+#pragma once
+
+#include "PotentiallyVisibleSet.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Builds the exact path that reflects off the given walls in order.
+ *
+ * images[0] is the transmitter in plan view and images[k] its mirror image across
+ * walls[0..k-1]. The path is backtraced from the receiver through the images; it is rejected
+ * when a reflection point falls outside its wall, when a reflection would happen on the far
+ * side of a wall, when more than maxTransmissions walls are crossed along the way, or when
+ * it exceeds maxPathLengthMeters. Crossed walls become transmission interactions. Heights
+ * are interpolated linearly along the unfolded path, which is exact for vertical walls.
+ *
+ * The index only needs WallIndex's Wall() and Crossings(), so a DomainDecomposition can
+ * stand in for it.
+ */
+template <typename WallQuery>
+std::optional<PropagationPath> TraceReflectionPath(
+    const WallQuery &index, const math::Vec3d &transmitter, const math::Vec3d &receiver,
+    const std::vector<std::size_t> &walls, const std::vector<math::Vec2d> &images,
+    const PropagationSettings &settings)
+{
+    const std::size_t order = walls.size();
+    std::vector<math::Vec2d> points(order + 2);
+    points.front() = math::Vec2d{transmitter.x, transmitter.y};
+    points.back() = math::Vec2d{receiver.x, receiver.y};
+
+    math::Vec2d target = points.back();
+    for (std::size_t k = order; k >= 1; --k) {
+        const WallSegment &wall = index.Wall(walls[k - 1]);
+        const math::Vec2d &image = images[k];
+        const auto hit = IntersectWall(image, target - image, wall, 0.0, 1.0);
+        if (!hit) {
+            return std::nullopt;
+        }
+        target = image + (target - image) * hit->t;
+        points[k] = target;
+    }
+    for (std::size_t k = 1; k <= order; ++k) {
+        const WallSegment &wall = index.Wall(walls[k - 1]);
+        if (wall.SignedDistance(points[k - 1]) * wall.SignedDistance(points[k + 1]) <= 0.0) {
+            return std::nullopt;
+        }
+    }
+
+    double planLength = 0.0;
+    std::vector<double> cumulative(points.size(), 0.0);
+    for (std::size_t leg = 1; leg < points.size(); ++leg) {
+        planLength += (points[leg] - points[leg - 1]).length();
+        cumulative[leg] = planLength;
+    }
+    const double rise = receiver.z - transmitter.z;
+    PropagationPath path;
+    path.lengthMeters = std::sqrt(planLength * planLength + rise * rise);
+    if (path.lengthMeters > settings.maxPathLengthMeters) {
+        return std::nullopt;
+    }
+
+    const auto lift = [&](const math::Vec2d &point, double along) {
+        const double fraction = planLength > 0.0 ? along / planLength : 0.0;
+        return math::Vec3d{point.x, point.y, transmitter.z + rise * fraction};
+    };
+    const auto incidence = [&](const math::Vec3d &direction, std::size_t wallIndex) {
+        const math::Vec2d &normal = index.Wall(wallIndex).normal;
+        const double cosine = std::abs(direction.dot(math::Vec3d{normal.x, normal.y, 0.0}));
+        return std::acos(std::min(1.0, cosine));
+    };
+
+    std::size_t transmissions = 0;
+    path.vertices.push_back(transmitter);
+    for (std::size_t leg = 1; leg < points.size(); ++leg) {
+        const std::size_t fromWall = leg >= 2 ? walls[leg - 2] : WallIndex::kNoWall;
+        const std::size_t toWall = leg <= order ? walls[leg - 1] : WallIndex::kNoWall;
+        const math::Vec3d from = lift(points[leg - 1], cumulative[leg - 1]);
+        const math::Vec3d to =
+            leg + 1 == points.size() ? receiver : lift(points[leg], cumulative[leg]);
+        const math::Vec3d direction = (to - from).normalized();
+
+        const std::vector<WallHit> crossings =
+            index.Crossings(points[leg - 1], points[leg], fromWall, toWall);
+        transmissions += crossings.size();
+        if (transmissions > settings.maxTransmissions) {
+            return std::nullopt;
+        }
+        for (const WallHit &crossing : crossings) {
+            path.interactions.push_back(PathInteraction{InteractionType::Transmission,
+                                                        crossing.wallIndex,
+                                                        incidence(direction, crossing.wallIndex)});
+        }
+        if (toWall != WallIndex::kNoWall) {
+            path.interactions.push_back(
+                PathInteraction{InteractionType::Reflection, toWall, incidence(direction, toWall)});
+        }
+        path.vertices.push_back(to);
+    }
+    return path;
+}
+
+/**
+ * @brief Transmitter images for all reflection sequences up to a maximum order.
+ *
+ * Node 0 is the transmitter itself; every other node is the mirror image of its parent
+ * across one wall. Walking parents from a node yields its reflection sequence in reverse.
+ */
+struct ImageTree {
+    struct Node {
+        math::Vec2d position;
+        std::size_t wallIndex{WallIndex::kNoWall};
+        std::size_t parent{WallIndex::kNoWall};
+        std::size_t depth{0};
+        /** Children occupy nodes[firstChild, firstChild + childCount). */
+        std::size_t firstChild{0};
+        std::size_t childCount{0};
+        /** Number of nodes in the subtree below this one. */
+        std::size_t descendants{0};
+    };
+
+    math::Vec3d       transmitter;
+    std::vector<Node> nodes;
+
+    /**
+     * @brief Returns the reflection sequence (first wall first) and images of a node.
+     */
+    void Sequence(std::size_t node, std::vector<std::size_t> &walls,
+                  std::vector<math::Vec2d> &images) const
+    {
+        walls.clear();
+        images.clear();
+        for (std::size_t current = node; current != WallIndex::kNoWall;
+             current = nodes[current].parent) {
+            images.push_back(nodes[current].position);
+            if (nodes[current].wallIndex != WallIndex::kNoWall) {
+                walls.push_back(nodes[current].wallIndex);
+            }
+        }
+        std::reverse(walls.begin(), walls.end());
+        std::reverse(images.begin(), images.end());
+    }
+};
+
+/**
+ * @brief Work counters reported by the image-method search.
+ */
+struct PathSearchStatistics {
+    /** Image nodes created or traced against a receiver. */
+    std::size_t explored{0};
+    /** Image nodes skipped because their bound stayed below sensitivity. */
+    std::size_t pruned{0};
+    std::size_t paths{0};
+};
+
+/**
+ * @brief Builds the transmitter's image tree over the walls of a WallIndex-like query.
+ *
+ * Only Wall() and WallCount() are used, so a DomainDecomposition builds the same tree as
+ * a WallIndex over the same walls. Branches are culled with the visibility sets when
+ * given; with a budget, walls too far from an image for any receiver to be reached are
+ * not expanded and the tree stays valid for every receiver.
+ */
+template <typename WallQuery>
+ImageTree BuildImageTree(const WallQuery &index, const math::Vec3d &transmitter,
+                         const PropagationSettings &settings,
+                         const PotentiallyVisibleSet *visibility = nullptr,
+                         const LinkBudget *budget = nullptr,
+                         PathSearchStatistics *statistics = nullptr)
+{
+    ImageTree tree;
+    tree.transmitter = transmitter;
+    const math::Vec2d origin{transmitter.x, transmitter.y};
+    tree.nodes.push_back(ImageTree::Node{origin});
+    for (std::size_t node = 0; node < tree.nodes.size(); ++node) {
+        tree.nodes[node].firstChild = tree.nodes.size();
+        if (tree.nodes[node].depth >= settings.maxReflections) {
+            continue;
+        }
+        for (std::size_t wall = 0; wall < index.WallCount(); ++wall) {
+            const ImageTree::Node &parent = tree.nodes[node];
+            if (wall == parent.wallIndex ||
+                std::abs(index.Wall(wall).SignedDistance(parent.position)) < 1e-9) {
+                continue;
+            }
+            if (visibility != nullptr && (parent.wallIndex == WallIndex::kNoWall
+                                              ? !visibility->PointSees(origin, wall)
+                                              : !visibility->WallSees(parent.wallIndex, wall))) {
+                continue;
+            }
+            // Any path through this wall is at least as long as image to wall.
+            if (budget != nullptr &&
+                !budget->CanReach(index.Wall(wall).Distance(parent.position), 0.0,
+                                  settings.pruningMarginDb)) {
+                if (statistics != nullptr) {
+                    ++statistics->pruned;
+                }
+                continue;
+            }
+            tree.nodes.push_back(ImageTree::Node{index.Wall(wall).Mirror(parent.position), wall,
+                                                 node, parent.depth + 1});
+            ++tree.nodes[node].childCount;
+        }
+    }
+    for (std::size_t node = tree.nodes.size(); node-- > 1;) {
+        tree.nodes[tree.nodes[node].parent].descendants += tree.nodes[node].descendants + 1;
+    }
+    if (statistics != nullptr) {
+        statistics->explored += tree.nodes.size();
+    }
+    return tree;
+}
+
+/**
+ * @brief Finds propagation paths with the image method.
+ *
+ * The image tree depends only on the transmitter, so it is built once and traced against
+ * every receiver. Its size grows as walls^maxReflections, which makes this method exact but
+ * expensive for dense floorplans and high orders; see RayLaunchingSolver. A potentially
+ * visible set limits each branch to walls the previous wall (or the transmitter's cell) may
+ * see, which shrinks the tree sharply in buildings with many rooms.
+ *
+ * Given a LinkBudget the search is branch and bound: every image node gets an optimistic
+ * received power from the shortest path its reflection sequence could still form
+ * (image-to-wall plus wall-to-receiver distance) and the best reflection magnitude over
+ * the incidence angles the wall allows, and whole subtrees are skipped once that bound
+ * falls below sensitivity minus PropagationSettings::pruningMarginDb. The reflection
+ * bound is the largest tabulated magnitude between the smallest and largest possible
+ * incidence; slab reflection oscillates with incidence, so the magnitudes at the two ends
+ * of the range alone would not bound it.
+ */
+class ImageMethodSolver {
+public:
+    /**
+     * @param evaluator Optional; tightens the pruning bound with reflection coefficients.
+     *                  Without it reflections are assumed lossless for the bound.
+     */
+    ImageMethodSolver(const WallIndex &index, PropagationSettings settings,
+                      const PathEvaluator *evaluator = nullptr)
+        : index_(index), settings_(settings), evaluator_(evaluator)
+    {
+    }
+
+    [[nodiscard]] const PropagationSettings &Settings() const { return settings_; }
+
+    /**
+     * @brief Uses the given visibility sets to cull walls; nullptr disables culling.
+     *
+     * The sets are ignored when they were built for fewer transmissions than the settings
+     * allow, since culling would then drop valid paths.
+     */
+    void SetVisibility(const PotentiallyVisibleSet *visibility) { visibility_ = visibility; }
+
+    /**
+     * @brief Returns true when wall culling is active.
+     */
+    [[nodiscard]] bool Culling() const
+    {
+        return visibility_ != nullptr && !visibility_->Empty() &&
+               settings_.maxTransmissions <= visibility_->TransmissionDepth();
+    }
+
+    /**
+     * @brief Builds the transmitter's image tree.
+     *
+     * With a budget, walls too far from an image for any receiver to be reached are not
+     * expanded; the tree stays valid for every receiver.
+     */
+    [[nodiscard]] ImageTree BuildTree(const math::Vec3d &transmitter,
+                                      const LinkBudget *budget = nullptr,
+                                      PathSearchStatistics *statistics = nullptr) const
+    {
+        return BuildImageTree(index_, transmitter, settings_, Culling() ? visibility_ : nullptr,
+                              budget, statistics);
+    }
+
+    /**
+     * @brief Returns every valid path from the tree's transmitter to the receiver.
+     *
+     * With a budget, subtrees whose optimistic received power stays below sensitivity are
+     * skipped without tracing.
+     */
+    [[nodiscard]] std::vector<PropagationPath> Trace(const ImageTree &tree,
+                                                     const math::Vec3d &receiver,
+                                                     const LinkBudget *budget = nullptr,
+                                                     PathSearchStatistics *statistics = nullptr)
+        const
+    {
+        PathSearchStatistics counters;
+        std::vector<PropagationPath> paths;
+        std::vector<std::size_t> walls;
+        std::vector<math::Vec2d> images;
+        const bool culling = Culling();
+        const math::Vec2d target{receiver.x, receiver.y};
+        const double rise = receiver.z - tree.transmitter.z;
+
+        // Depth-first over (node, best-case amplitude of its reflections).
+        std::vector<std::pair<std::size_t, double>> stack;
+        if (!tree.nodes.empty()) {
+            stack.emplace_back(0, 1.0);
+        }
+        while (!stack.empty()) {
+            const auto [node, amplitude] = stack.back();
+            stack.pop_back();
+            ++counters.explored;
+            const ImageTree::Node &current = tree.nodes[node];
+            if (!culling || current.wallIndex == WallIndex::kNoWall ||
+                visibility_->PointSees(target, current.wallIndex)) {
+                tree.Sequence(node, walls, images);
+                if (auto path = TraceReflectionPath(index_, tree.transmitter, receiver, walls,
+                                                    images, settings_)) {
+                    paths.push_back(std::move(*path));
+                }
+            }
+            for (std::size_t child = current.firstChild + current.childCount;
+                 child-- > current.firstChild;) {
+                double bound = amplitude;
+                if (budget != nullptr &&
+                    !WithinBudget(tree, child, current.position, target, rise, *budget, bound)) {
+                    counters.pruned += tree.nodes[child].descendants + 1;
+                    continue;
+                }
+                stack.emplace_back(child, bound);
+            }
+        }
+        counters.paths = paths.size();
+        if (statistics != nullptr) {
+            statistics->explored += counters.explored;
+            statistics->pruned += counters.pruned;
+            statistics->paths += counters.paths;
+        }
+        return paths;
+    }
+
+    /**
+     * @brief Returns every valid path between one transmitter and one receiver.
+     */
+    [[nodiscard]] std::vector<PropagationPath> Solve(const math::Vec3d &transmitter,
+                                                     const math::Vec3d &receiver,
+                                                     const LinkBudget *budget = nullptr,
+                                                     PathSearchStatistics *statistics = nullptr)
+        const
+    {
+        return Trace(BuildTree(transmitter, budget, statistics), receiver, budget, statistics);
+    }
+
+private:
+    /**
+     * @brief Bounds the received power of every path below an image node.
+     *
+     * On success amplitude is multiplied by the node's best-case reflection magnitude.
+     */
+    bool WithinBudget(const ImageTree &tree, std::size_t node, const math::Vec2d &source,
+                      const math::Vec2d &receiver, double rise, const LinkBudget &budget,
+                      double &amplitude) const
+    {
+        const ImageTree::Node &current = tree.nodes[node];
+        const WallSegment &wall = index_.Wall(current.wallIndex);
+        const double nearest = wall.Distance(source);
+        const double planLength = nearest + wall.Distance(receiver);
+        const double length = std::sqrt(planLength * planLength + rise * rise);
+
+        if (evaluator_ != nullptr) {
+            // Plan-view incidence spans [nearest point, farthest endpoint]; the path's
+            // elevation can only tilt it further from the normal.
+            const double offset = std::abs(wall.SignedDistance(source));
+            const double farthest =
+                std::max((wall.start - source).length(), (wall.end - source).length());
+            const double elevation = length > 0.0 ? planLength / length : 1.0;
+            const double minIncidence = std::acos(std::min(1.0, offset / std::max(nearest, 1e-12)));
+            const double maxIncidence =
+                std::acos(std::min(1.0, offset / std::max(farthest, 1e-12) * elevation));
+            amplitude *=
+                evaluator_->MaxReflectionMagnitude(current.wallIndex, minIncidence, maxIncidence);
+        }
+        const double lossDb = amplitude > 0.0 ? -20.0 * std::log10(amplitude)
+                                              : std::numeric_limits<double>::infinity();
+        return budget.CanReach(length, lossDb, settings_.pruningMarginDb);
+    }
+
+    const WallIndex             &index_;
+    PropagationSettings          settings_;
+    const PathEvaluator         *evaluator_;
+    const PotentiallyVisibleSet *visibility_{nullptr};
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,366 @@
+#pragma once
+
+#include "CoverageRaster.h"
+#include "TransmitterState.h"
+
+#include "rfmodel/math/Constants.h"
+#include "rfmodel/math/Decibel.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Tuning knobs for hierarchical interference evaluation.
+ */
+struct InterferenceOptions {
+    /**
+     * A cluster of radius r at distance D is approximated when r / D is below this value.
+     * Its relative error is then at most (1 / (1 - theta))^2 - 1; zero forces exact sums.
+     */
+    double openingAngle{0.3};
+    /** Transmitters per leaf of the spatial hierarchy. */
+    std::size_t leafSize{8};
+};
+
+/**
+ * @brief Aggregated power from many transmitters at one position.
+ */
+struct InterferenceSample {
+    /** Estimated sum of received powers in mW. */
+    double powerMilliwatts{0.0};
+    /** Guaranteed bound on |estimate - exact sum| in mW. */
+    double errorBoundMilliwatts{0.0};
+    /** Transmitters evaluated one by one. */
+    std::size_t exactTransmitters{0};
+    /** Clusters replaced by a single aggregate. */
+    std::size_t clusters{0};
+
+    [[nodiscard]] double PowerDbm() const
+    {
+        return 10.0 * std::log10(std::max(powerMilliwatts, std::numeric_limits<double>::min()));
+    }
+};
+
+/**
+ * @brief Barnes-Hut style hierarchy for summed free-space power of many transmitters.
+ *
+ * Interference adds incoherently, so each transmitter contributes strength / d^2 with
+ * strength = P (lambda / 4 pi)^2, the Friis law used by CoverageKernel. Transmitters are
+ * organised in a quadtree whose nodes store total strength, the strength-weighted centroid,
+ * the radius r of the sphere around it holding all members and their strength-weighted
+ * second moment M. Far clusters are replaced by total strength / D^2 at the centroid. The
+ * error of each aggregate is bounded by the smaller of the spread between D - r and D + r
+ * and the Taylor remainder 3 M / (D - r)^4 (first-order terms cancel at the weighted
+ * centroid); the bounds are summed into InterferenceSample::errorBoundMilliwatts. Nearby
+ * transmitters are evaluated exactly, so a point costs O(log n) cluster visits plus its
+ * near neighbours instead of O(n).
+ */
+class InterferenceField {
+public:
+    InterferenceField(const std::vector<TransmitterState> &transmitters,
+                      double receiverHeightMeters = 0.0, InterferenceOptions options = {})
+        : options_(options), receiverHeight_(receiverHeightMeters)
+    {
+        options_.leafSize = std::max<std::size_t>(1, options_.leafSize);
+        options_.openingAngle = std::clamp(options_.openingAngle, 0.0, 0.95);
+        emitters_.reserve(transmitters.size());
+        for (const TransmitterState &transmitter : transmitters) {
+            const double referenceGain = transmitter.WavelengthMeters() / (4.0 * math::kPi);
+            emitters_.push_back(Emitter{transmitter.positionMeters,
+                                        math::decibelsToPower(transmitter.powerDbm) *
+                                            referenceGain * referenceGain,
+                                        referenceGain});
+        }
+        order_.resize(emitters_.size());
+        std::iota(order_.begin(), order_.end(), std::size_t{0});
+        if (!emitters_.empty()) {
+            nodes_.reserve(2 * emitters_.size() / options_.leafSize + 1);
+            Build(0, emitters_.size(), 0);
+        }
+    }
+
+    [[nodiscard]] std::size_t TransmitterCount() const { return emitters_.size(); }
+    [[nodiscard]] std::size_t NodeCount() const { return nodes_.size(); }
+    [[nodiscard]] const InterferenceOptions &Options() const { return options_; }
+
+    /**
+     * @brief Returns the received power of one transmitter at a position in mW.
+     */
+    [[nodiscard]] double ExactPower(std::size_t transmitter, double xMeters, double yMeters) const
+    {
+        const Emitter &emitter = emitters_[transmitter];
+        const double distance =
+            std::max(Distance(emitter.position, xMeters, yMeters), emitter.minimumDistance);
+        return emitter.strength / (distance * distance);
+    }
+
+    /**
+     * @brief Estimates the summed power of all transmitters at a position.
+     */
+    [[nodiscard]] InterferenceSample Evaluate(double xMeters, double yMeters) const
+    {
+        InterferenceSample sample;
+        if (nodes_.empty()) {
+            return sample;
+        }
+        std::vector<std::size_t> stack{0};
+        while (!stack.empty()) {
+            const Node &node = nodes_[stack.back()];
+            stack.pop_back();
+            const double distance = Distance(node.centroid, xMeters, yMeters);
+            if (node.radius < options_.openingAngle * distance &&
+                distance - node.radius >= node.clampDistance) {
+                const double nearest = distance - node.radius;
+                const double farthest = distance + node.radius;
+                const double estimate = node.strength / (distance * distance);
+                const double upper = node.strength / (nearest * nearest);
+                const double lower = node.strength / (farthest * farthest);
+                const double taylor = 3.0 * node.secondMoment / std::pow(nearest, 4.0);
+                sample.powerMilliwatts += estimate;
+                sample.errorBoundMilliwatts +=
+                    std::min(std::max(upper - estimate, estimate - lower), taylor);
+                ++sample.clusters;
+            } else if (node.IsLeaf()) {
+                for (std::size_t index = node.first; index < node.last; ++index) {
+                    sample.powerMilliwatts += ExactPower(order_[index], xMeters, yMeters);
+                }
+                sample.exactTransmitters += node.last - node.first;
+            } else {
+                for (const std::size_t child : node.children) {
+                    if (child != kNoChild) {
+                        stack.push_back(child);
+                    }
+                }
+            }
+        }
+        return sample;
+    }
+
+    /**
+     * @brief Finds the transmitter received strongest at a position.
+     *
+     * Branch and bound over the hierarchy: a cluster is skipped when even its nearest
+     * possible member could not beat the best transmitter found so far.
+     */
+    [[nodiscard]] std::pair<std::size_t, double> Strongest(double xMeters, double yMeters) const
+    {
+        std::size_t best = emitters_.size();
+        double bestPower = 0.0;
+        std::vector<std::size_t> stack;
+        if (!nodes_.empty()) {
+            stack.push_back(0);
+        }
+        while (!stack.empty()) {
+            const Node &node = nodes_[stack.back()];
+            stack.pop_back();
+            const double nearest = std::max(
+                Distance(node.centroid, xMeters, yMeters) - node.radius, node.minimumDistance);
+            if (node.maxStrength / (nearest * nearest) <= bestPower) {
+                continue;
+            }
+            if (node.IsLeaf()) {
+                for (std::size_t index = node.first; index < node.last; ++index) {
+                    const double power = ExactPower(order_[index], xMeters, yMeters);
+                    if (power > bestPower) {
+                        bestPower = power;
+                        best = order_[index];
+                    }
+                }
+                continue;
+            }
+            for (const std::size_t child : node.children) {
+                if (child != kNoChild) {
+                    stack.push_back(child);
+                }
+            }
+        }
+        return {best, bestPower};
+    }
+
+    /**
+     * @brief Evaluates summed interference power in dBm at every cell center.
+     *
+     * @param errorDb Optional; receives the relative error bound of each cell in dB.
+     */
+    void EvaluatePowerDbm(const RasterGeometry &geometry, CoverageRaster &powerDbm,
+                          CoverageRaster *errorDb = nullptr) const
+    {
+        powerDbm = CoverageRaster(geometry);
+        if (errorDb != nullptr) {
+            *errorDb = CoverageRaster(geometry);
+        }
+        for (std::size_t row = 0; row < geometry.rows; ++row) {
+            for (std::size_t column = 0; column < geometry.columns; ++column) {
+                const InterferenceSample sample =
+                    Evaluate(geometry.CellCenterX(column), geometry.CellCenterY(row));
+                powerDbm.Set(column, row, sample.PowerDbm());
+                if (errorDb != nullptr) {
+                    errorDb->Set(column, row, RelativeErrorDb(sample));
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Evaluates best-server SINR in dB at every cell center.
+     *
+     * The strongest transmitter at each cell is the serving one and is evaluated exactly;
+     * all others count as interference.
+     */
+    void EvaluateSinrDb(const RasterGeometry &geometry, double noiseDbm,
+                        CoverageRaster &sinrDb) const
+    {
+        sinrDb = CoverageRaster(geometry);
+        const double noise = math::decibelsToPower(noiseDbm);
+        for (std::size_t row = 0; row < geometry.rows; ++row) {
+            for (std::size_t column = 0; column < geometry.columns; ++column) {
+                const double x = geometry.CellCenterX(column);
+                const double y = geometry.CellCenterY(row);
+                const auto [server, signal] = Strongest(x, y);
+                const double total = Evaluate(x, y).powerMilliwatts;
+                const double interference = std::max(total - signal, 0.0);
+                sinrDb.Set(column, row,
+                           server == emitters_.size()
+                               ? -std::numeric_limits<double>::infinity()
+                               : 10.0 * std::log10(signal / (interference + noise)));
+            }
+        }
+    }
+
+    /**
+     * @brief Converts a sample's absolute error bound into a bound in dB.
+     */
+    static double RelativeErrorDb(const InterferenceSample &sample)
+    {
+        if (sample.errorBoundMilliwatts <= 0.0) {
+            return 0.0;
+        }
+        const double ratio = sample.errorBoundMilliwatts / sample.powerMilliwatts;
+        return ratio < 1.0 ? -10.0 * std::log10(1.0 - ratio)
+                           : std::numeric_limits<double>::infinity();
+    }
+
+private:
+    static constexpr std::size_t kNoChild = std::numeric_limits<std::size_t>::max();
+
+    struct Emitter {
+        std::array<double, 3> position;
+        /** Received power at 1 m in mW. */
+        double                strength{0.0};
+        /** Distance below which the Friis gain is clamped to unity. */
+        double                minimumDistance{0.0};
+    };
+
+    struct Node {
+        std::array<double, 3>      centroid{};
+        double                     radius{0.0};
+        double                     secondMoment{0.0};
+        double                     strength{0.0};
+        double                     maxStrength{0.0};
+        /** Smallest and largest member clamp distance. */
+        double                     minimumDistance{std::numeric_limits<double>::infinity()};
+        double                     clampDistance{0.0};
+        std::size_t                first{0};
+        std::size_t                last{0};
+        std::array<std::size_t, 4> children{kNoChild, kNoChild, kNoChild, kNoChild};
+
+        [[nodiscard]] bool IsLeaf() const
+        {
+            return std::all_of(children.begin(), children.end(),
+                               [](std::size_t child) { return child == kNoChild; });
+        }
+    };
+
+    double Distance(const std::array<double, 3> &point, double xMeters, double yMeters) const
+    {
+        const double dx = xMeters - point[0];
+        const double dy = yMeters - point[1];
+        const double dz = receiverHeight_ - point[2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+
+    std::size_t Build(std::size_t first, std::size_t last, std::size_t depth)
+    {
+        const std::size_t index = nodes_.size();
+        nodes_.emplace_back();
+        Node node;
+        node.first = first;
+        node.last = last;
+        double minX = std::numeric_limits<double>::infinity();
+        double minY = minX;
+        double maxX = -minX;
+        double maxY = -minX;
+        double weight = 0.0;
+        for (std::size_t member = first; member < last; ++member) {
+            const Emitter &emitter = emitters_[order_[member]];
+            // Zero-power emitters still need a position for the radius below.
+            const double share = std::max(emitter.strength, 1e-300);
+            for (int axis = 0; axis < 3; ++axis) {
+                node.centroid[axis] += share * emitter.position[axis];
+            }
+            weight += share;
+            node.strength += emitter.strength;
+            node.maxStrength = std::max(node.maxStrength, emitter.strength);
+            node.minimumDistance = std::min(node.minimumDistance, emitter.minimumDistance);
+            node.clampDistance = std::max(node.clampDistance, emitter.minimumDistance);
+            minX = std::min(minX, emitter.position[0]);
+            minY = std::min(minY, emitter.position[1]);
+            maxX = std::max(maxX, emitter.position[0]);
+            maxY = std::max(maxY, emitter.position[1]);
+        }
+        for (int axis = 0; axis < 3; ++axis) {
+            node.centroid[axis] /= weight;
+        }
+        for (std::size_t member = first; member < last; ++member) {
+            const Emitter &emitter = emitters_[order_[member]];
+            const double dx = emitter.position[0] - node.centroid[0];
+            const double dy = emitter.position[1] - node.centroid[1];
+            const double dz = emitter.position[2] - node.centroid[2];
+            const double squared = dx * dx + dy * dy + dz * dz;
+            node.radius = std::max(node.radius, std::sqrt(squared));
+            node.secondMoment += emitter.strength * squared;
+        }
+
+        // Split into quadrants around the bounding-box center; coincident points stay a leaf.
+        constexpr std::size_t kMaxDepth = 32;
+        if (last - first > options_.leafSize && depth < kMaxDepth &&
+            (maxX > minX || maxY > minY)) {
+            const double midX = 0.5 * (minX + maxX);
+            const double midY = 0.5 * (minY + maxY);
+            const auto quadrant = [&](std::size_t id) {
+                const Emitter &emitter = emitters_[id];
+                return (emitter.position[0] > midX ? 1 : 0) + (emitter.position[1] > midY ? 2 : 0);
+            };
+            std::size_t begin = first;
+            for (int target = 0; target < 4; ++target) {
+                const auto split =
+                    std::partition(order_.begin() + static_cast<std::ptrdiff_t>(begin),
+                                   order_.begin() + static_cast<std::ptrdiff_t>(last),
+                                   [&](std::size_t id) { return quadrant(id) == target; });
+                const auto end = static_cast<std::size_t>(split - order_.begin());
+                if (end > begin) {
+                    node.children[target] = Build(begin, end, depth + 1);
+                }
+                begin = end;
+            }
+        }
+        nodes_[index] = node;
+        return index;
+    }
+
+    InterferenceOptions      options_;
+    double                   receiverHeight_;
+    std::vector<Emitter>     emitters_;
+    std::vector<std::size_t> order_;
+    std::vector<Node>        nodes_;
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "FresnelCoefficients.h"
+#include "IWall.h"
+
+#include "rfmodel/math/Complex.h"
+#include "rfmodel/math/Constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Fresnel coefficients of one material at one frequency, tabulated over incidence angle.
+ *
+ * Lookups linearly interpolate between uniformly spaced samples on [0, pi/2], replacing the
+ * complex square roots and exponentials of ComputeFresnelCoefficients() with a few
+ * multiply-adds per interaction. A sparse table of reflection magnitudes answers
+ * "largest |R| over an incidence interval" in constant time for path pruning; slab
+ * reflection oscillates with incidence, so the endpoints of an interval do not bound it.
+ */
+class MaterialCoefficientTable {
+public:
+    static constexpr std::size_t kDefaultSamples = 256;
+
+    MaterialCoefficientTable(const WallMaterial &material, double frequencyHz,
+                             std::size_t intervals = kDefaultSamples)
+        : material_(material), frequencyHz_(frequencyHz)
+    {
+        intervals = std::max<std::size_t>(intervals, 1);
+        step_ = math::kHalfPi / static_cast<double>(intervals);
+        samples_.reserve(intervals + 1);
+        for (std::size_t index = 0; index <= intervals; ++index) {
+            const double incidence = static_cast<double>(index) * step_;
+            samples_.push_back(ComputeFresnelCoefficients(material, frequencyHz, incidence));
+        }
+        for (const FresnelCoefficients &sample : samples_) {
+            maxReflectionTe_ = std::max(maxReflectionTe_, sample.reflectionTe.magnitude());
+            maxReflectionTm_ = std::max(maxReflectionTm_, sample.reflectionTm.magnitude());
+        }
+        BuildRangeMaxima(Polarization::TransverseElectric, rangeMaxTe_);
+        BuildRangeMaxima(Polarization::TransverseMagnetic, rangeMaxTm_);
+    }
+
+    /**
+     * @brief Returns the material the table was built for.
+     */
+    [[nodiscard]] const WallMaterial &Material() const { return material_; }
+
+    /**
+     * @brief Returns the carrier frequency the table was built for in hertz.
+     */
+    [[nodiscard]] double FrequencyHz() const { return frequencyHz_; }
+
+    /**
+     * @brief Interpolates all coefficients at the given incidence angle in radians.
+     */
+    [[nodiscard]] FresnelCoefficients Lookup(double incidenceRadians) const
+    {
+        const double position = std::clamp(incidenceRadians, 0.0, math::kHalfPi) / step_;
+        const std::size_t lower =
+            std::min(static_cast<std::size_t>(position), samples_.size() - 2);
+        const double fraction = position - static_cast<double>(lower);
+        const FresnelCoefficients &a = samples_[lower];
+        const FresnelCoefficients &b = samples_[lower + 1];
+
+        const auto lerp = [fraction](const math::Complex &from, const math::Complex &to) {
+            return from + (to - from) * fraction;
+        };
+        return FresnelCoefficients{lerp(a.reflectionTe, b.reflectionTe),
+                                   lerp(a.reflectionTm, b.reflectionTm),
+                                   lerp(a.transmissionTe, b.transmissionTe),
+                                   lerp(a.transmissionTm, b.transmissionTm)};
+    }
+
+    /**
+     * @brief Interpolates the reflection coefficient at the given incidence angle.
+     */
+    [[nodiscard]] math::Complex Reflection(double incidenceRadians, Polarization polarization) const
+    {
+        return Lookup(incidenceRadians).Reflection(polarization);
+    }
+
+    /**
+     * @brief Interpolates the slab transmission coefficient at the given incidence angle.
+     */
+    [[nodiscard]] math::Complex Transmission(double incidenceRadians,
+                                             Polarization polarization) const
+    {
+        return Lookup(incidenceRadians).Transmission(polarization);
+    }
+
+    /**
+     * @brief Returns the largest tabulated reflection magnitude over all incidence angles.
+     */
+    [[nodiscard]] double MaxReflectionMagnitude(Polarization polarization) const
+    {
+        return polarization == Polarization::TransverseElectric ? maxReflectionTe_
+                                                                : maxReflectionTm_;
+    }
+
+    /**
+     * @brief Returns an upper bound on |Reflection()| for incidence angles in [from, to].
+     *
+     * Interpolation never exceeds the larger magnitude of its two samples, so the bound is
+     * the largest magnitude among the interpolated endpoints and the samples between them.
+     */
+    [[nodiscard]] double MaxReflectionMagnitude(Polarization polarization, double from,
+                                                double to) const
+    {
+        if (from > to) {
+            std::swap(from, to);
+        }
+        double bound = std::max(Reflection(from, polarization).magnitude(),
+                                Reflection(to, polarization).magnitude());
+        const double first = std::ceil(std::clamp(from, 0.0, math::kHalfPi) / step_);
+        const double last = std::floor(std::clamp(to, 0.0, math::kHalfPi) / step_);
+        if (first > last) {
+            return bound;
+        }
+        const auto lower = static_cast<std::size_t>(first);
+        const auto upper = std::min(static_cast<std::size_t>(last), samples_.size() - 1);
+        const std::vector<std::vector<double>> &levels =
+            polarization == Polarization::TransverseElectric ? rangeMaxTe_ : rangeMaxTm_;
+        std::size_t level = 0;
+        while ((std::size_t{2} << level) <= upper - lower + 1) {
+            ++level;
+        }
+        bound = std::max({bound, levels[level][lower],
+                          levels[level][upper + 1 - (std::size_t{1} << level)]});
+        return bound;
+    }
+
+private:
+    /**
+     * @brief Fills levels[k][i] with the largest reflection magnitude of samples
+     * [i, i + 2^k).
+     */
+    void BuildRangeMaxima(Polarization polarization, std::vector<std::vector<double>> &levels)
+    {
+        levels.emplace_back();
+        for (const FresnelCoefficients &sample : samples_) {
+            levels.back().push_back(sample.Reflection(polarization).magnitude());
+        }
+        for (std::size_t width = 2; width <= samples_.size(); width *= 2) {
+            const std::vector<double> &previous = levels.back();
+            std::vector<double> next(samples_.size() + 1 - width);
+            for (std::size_t index = 0; index < next.size(); ++index) {
+                next[index] = std::max(previous[index], previous[index + width / 2]);
+            }
+            levels.push_back(std::move(next));
+        }
+    }
+
+    WallMaterial                     material_;
+    double                           frequencyHz_;
+    double                           step_{1.0};
+    double                           maxReflectionTe_{0.0};
+    double                           maxReflectionTm_{0.0};
+    std::vector<FresnelCoefficients> samples_;
+    std::vector<std::vector<double>> rangeMaxTe_;
+    std::vector<std::vector<double>> rangeMaxTm_;
+};
+
+/**
+ * @brief Shares coefficient tables between all walls with identical material properties.
+ *
+ * Floorplans typically use a handful of distinct materials across thousands of walls, so
+ * tables are keyed by (material, frequency) and built once on first use. The cache is safe
+ * to use from multiple worker threads.
+ */
+class MaterialCoefficientCache {
+public:
+    using TablePtr = std::shared_ptr<const MaterialCoefficientTable>;
+
+    explicit MaterialCoefficientCache(
+        std::size_t angleIntervals = MaterialCoefficientTable::kDefaultSamples)
+        : angleIntervals_(angleIntervals)
+    {
+    }
+
+    /**
+     * @brief Returns the table for the material at the given frequency, building it if needed.
+     */
+    [[nodiscard]] TablePtr Get(const WallMaterial &material, double frequencyHz)
+    {
+        const Key key{material, frequencyHz};
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = tables_.find(key);
+        if (found == tables_.end()) {
+            found = tables_
+                        .emplace(key, std::make_shared<const MaterialCoefficientTable>(
+                                          material, frequencyHz, angleIntervals_))
+                        .first;
+        }
+        return found->second;
+    }
+
+    /**
+     * @brief Returns the table matching the wall's material at the given frequency.
+     */
+    [[nodiscard]] TablePtr Get(const IWall &wall, double frequencyHz)
+    {
+        return Get(MakeWallMaterial(wall), frequencyHz);
+    }
+
+    /**
+     * @brief Returns the number of distinct tables currently cached.
+     */
+    [[nodiscard]] std::size_t Size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tables_.size();
+    }
+
+    /**
+     * @brief Drops all cached tables; outstanding table pointers remain valid.
+     */
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tables_.clear();
+    }
+
+private:
+    struct Key {
+        WallMaterial material;
+        double       frequencyHz;
+
+        [[nodiscard]] bool operator==(const Key &other) const
+        {
+            return material == other.material && frequencyHz == other.frequencyHz;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key &key) const
+        {
+            std::size_t seed = 0;
+            const auto combine = [&seed](double value) {
+                seed ^= std::hash<double>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6U) +
+                        (seed >> 2U);
+            };
+            combine(key.material.relativePermittivity);
+            combine(key.material.conductivity);
+            combine(key.material.thicknessMeters);
+            combine(key.frequencyHz);
+            return seed;
+        }
+    };
+
+    std::size_t                                angleIntervals_;
+    mutable std::mutex                         mutex_;
+    std::unordered_map<Key, TablePtr, KeyHash> tables_;
+};
+
+} // namespace rfmodel::engine
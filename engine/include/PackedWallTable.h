@@ -0,0 +1,176 @@
+#pragma once
+
+#include "FresnelCoefficients.h"
+#include "IWall.h"
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Plan-view wall footprint in single precision with a shared material reference.
+ *
+ * Coordinates are relative to the owning table's origin, which keeps float precision at
+ * about 0.1 mm even two kilometers away from it. The normal is not stored; it follows from
+ * the endpoints as in MakeWallSegment(start, end).
+ */
+struct PackedWall {
+    float         startX;
+    float         startY;
+    float         endX;
+    float         endY;
+    std::uint32_t material;
+};
+
+static_assert(sizeof(PackedWall) == 20, "PackedWall is expected to stay 20 bytes");
+
+/**
+ * @brief Compact wall storage: 20-byte footprints plus a table of distinct materials.
+ *
+ * A PropagationEnvironment keeps two double vectors and a full WallMaterial per wall
+ * (72 bytes); scenes built from a handful of wall types shrink to a little over a quarter
+ * of that. Materials are deduplicated exactly, so they round-trip losslessly; footprints
+ * round-trip within MaxPositionErrorMeters(), which is recorded while packing. Keep the
+ * PropagationEnvironment when bit-exact geometry is required.
+ */
+class PackedWallTable {
+public:
+    PackedWallTable() = default;
+
+    /**
+     * @brief Packs an environment, using the center of its bounding box as origin.
+     */
+    static PackedWallTable FromEnvironment(const PropagationEnvironment &environment)
+    {
+        PackedWallTable table;
+        if (!environment.walls.empty()) {
+            math::Vec2d low{std::numeric_limits<double>::infinity(),
+                            std::numeric_limits<double>::infinity()};
+            math::Vec2d high = -low;
+            for (const WallSegment &wall : environment.walls) {
+                for (const math::Vec2d &point : {wall.start, wall.end}) {
+                    low = math::Vec2d{std::min(low.x, point.x), std::min(low.y, point.y)};
+                    high = math::Vec2d{std::max(high.x, point.x), std::max(high.y, point.y)};
+                }
+            }
+            table.origin_ = (low + high) * 0.5;
+        }
+        table.walls_.reserve(environment.walls.size());
+        for (std::size_t wall = 0; wall < environment.walls.size(); ++wall) {
+            const WallMaterial material =
+                wall < environment.materials.size() ? environment.materials[wall] : WallMaterial{};
+            table.Add(environment.walls[wall], material);
+        }
+        return table;
+    }
+
+    /**
+     * @brief Packs scene walls without building an intermediate environment.
+     */
+    static PackedWallTable FromWalls(const std::vector<const IWall *> &sceneWalls)
+    {
+        return FromEnvironment(PropagationEnvironment::FromWalls(sceneWalls));
+    }
+
+    /**
+     * @brief Appends a wall and returns its index; the material is shared when already known.
+     */
+    std::size_t Add(const WallSegment &segment, const WallMaterial &material)
+    {
+        const auto [known, inserted] = materialLookup_.emplace(
+            std::array<double, 3>{material.relativePermittivity, material.conductivity,
+                                  material.thicknessMeters},
+            static_cast<std::uint32_t>(materials_.size()));
+        if (inserted) {
+            materials_.push_back(material);
+        }
+        const std::uint32_t materialIndex = known->second;
+        const auto pack = [&](double value, double origin) {
+            return static_cast<float>(value - origin);
+        };
+        const PackedWall packed{pack(segment.start.x, origin_.x), pack(segment.start.y, origin_.y),
+                                pack(segment.end.x, origin_.x), pack(segment.end.y, origin_.y),
+                                materialIndex};
+        walls_.push_back(packed);
+        const WallSegment unpacked = Segment(walls_.size() - 1);
+        maxPositionError_ = std::max({maxPositionError_, (unpacked.start - segment.start).length(),
+                                      (unpacked.end - segment.end).length()});
+        return walls_.size() - 1;
+    }
+
+    [[nodiscard]] std::size_t WallCount() const { return walls_.size(); }
+    [[nodiscard]] std::size_t MaterialCount() const { return materials_.size(); }
+    [[nodiscard]] const std::vector<PackedWall> &Walls() const { return walls_; }
+    [[nodiscard]] const std::vector<WallMaterial> &Materials() const { return materials_; }
+    [[nodiscard]] const math::Vec2d &Origin() const { return origin_; }
+
+    /**
+     * @brief Returns the largest endpoint displacement introduced by packing, in meters.
+     */
+    [[nodiscard]] double MaxPositionErrorMeters() const { return maxPositionError_; }
+
+    /**
+     * @brief Returns the material index shared by the given wall.
+     */
+    [[nodiscard]] std::uint32_t MaterialIndex(std::size_t wall) const
+    {
+        return walls_[wall].material;
+    }
+
+    [[nodiscard]] const WallMaterial &Material(std::size_t wall) const
+    {
+        return materials_[walls_[wall].material];
+    }
+
+    /**
+     * @brief Expands one wall back to its double-precision footprint.
+     */
+    [[nodiscard]] WallSegment Segment(std::size_t wall) const
+    {
+        const PackedWall &packed = walls_[wall];
+        return MakeWallSegment(math::Vec2d{origin_.x + packed.startX, origin_.y + packed.startY},
+                               math::Vec2d{origin_.x + packed.endX, origin_.y + packed.endY});
+    }
+
+    /**
+     * @brief Expands the table into an environment for the path solvers.
+     */
+    [[nodiscard]] PropagationEnvironment ToEnvironment() const
+    {
+        PropagationEnvironment environment;
+        environment.walls.reserve(walls_.size());
+        environment.materials.reserve(walls_.size());
+        for (std::size_t wall = 0; wall < walls_.size(); ++wall) {
+            environment.AddWall(Segment(wall), Material(wall));
+        }
+        return environment;
+    }
+
+    /**
+     * @brief Returns the bytes held by the wall and material arrays.
+     */
+    [[nodiscard]] std::size_t MemoryBytes() const
+    {
+        return walls_.size() * sizeof(PackedWall) + materials_.size() * sizeof(WallMaterial);
+    }
+
+private:
+    math::Vec2d                                    origin_{};
+    std::vector<PackedWall>                        walls_;
+    std::vector<WallMaterial>                      materials_;
+    double                                         maxPositionError_{0.0};
+    /** Finds the shared entry of a material while packing. */
+    std::map<std::array<double, 3>, std::uint32_t> materialLookup_;
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,365 @@
+#pragma once
+
+#include "DiffractionSolver.h"
+#include "ImageMethodSolver.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "PropagationSolver.h"
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Constants.h"
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief A propagation path followed across simulation steps.
+ */
+struct TrackedPath {
+    PropagationPath path;
+    /** Rate of change of the path length in meters per second. */
+    double lengthRateMetersPerSecond{0.0};
+    /** Doppler shift in hertz, -rate / wavelength. */
+    double dopplerHz{0.0};
+    /** False for paths that appeared this step; their rate and Doppler are zero. */
+    bool persistent{false};
+};
+
+/**
+ * @brief Tuning for PathTracker.
+ */
+struct PathTrackerOptions {
+    /** Carrier frequency used for Doppler shifts. */
+    double frequencyHz{2.4e9};
+};
+
+/**
+ * @brief Work counters accumulated by PathTracker::Update().
+ */
+struct PathTrackingStatistics {
+    std::size_t updates{0};
+    std::size_t fullSearches{0};
+    /** Image nodes whose beams were built during full searches. */
+    std::size_t imageNodes{0};
+    /** Reflection sequences re-traced, in both full and incremental updates. */
+    std::size_t sequencesTraced{0};
+};
+
+/**
+ * @brief Follows the paths of one link while its endpoints move.
+ *
+ * A full search builds the image tree of one endpoint (the anchor) together with the beam of
+ * every image: the region the other endpoint must lie in for that reflection sequence to
+ * exist. Sequences whose beam holds the other endpoint become candidates; for every other
+ * image the distance to its beam is a clearance, and the smallest one is a safe radius
+ * within which no new reflection can appear. While the anchor stays put and the other
+ * endpoint has moved less than the safe radius, an update only re-traces the candidates,
+ * so paths that become blocked or leave their beam drop out and blocked ones come back
+ * without searching. Moving the anchor, or leaving the safe radius, is a visibility event
+ * and triggers a full search; the anchor is then the endpoint that did not move, so a
+ * static transmitter with a moving receiver (or the reverse) stays incremental.
+ *
+ * Diffraction paths are found again every update from the edge visibility cache, which is
+ * cheap next to the image search. Paths are matched across updates by their reflection and
+ * diffraction sequence to derive length rates and Doppler shifts. The wall grid must
+ * outlive the tracker.
+ */
+class PathTracker {
+public:
+    PathTracker(const WallIndex &index, PropagationSettings settings,
+                const EdgeVisibilityCache *edges = nullptr, PathTrackerOptions options = {})
+        : index_(index), settings_(settings), edges_(edges), options_(options)
+    {
+    }
+
+    /**
+     * @brief Tracks paths with the walls and settings of a solver, including its edge cache.
+     */
+    explicit PathTracker(const PropagationSolver &solver, PathTrackerOptions options = {})
+        : PathTracker(solver.Index(), solver.Settings(), solver.EdgeCache(), options)
+    {
+    }
+
+    /**
+     * @brief Moves the endpoints and returns the paths between them.
+     *
+     * deltaTimeSeconds is the time since the previous update and scales the length rates;
+     * when an evaluator is given, each path's gain is filled in.
+     */
+    const std::vector<TrackedPath> &Update(const math::Vec3d &transmitter,
+                                           const math::Vec3d &receiver,
+                                           double deltaTimeSeconds,
+                                           const PathEvaluator *evaluator = nullptr)
+    {
+        ++statistics_.updates;
+        const math::Vec2d from{transmitter.x, transmitter.y};
+        const math::Vec2d to{receiver.x, receiver.y};
+        if (NeedsFullSearch(from, to)) {
+            const bool receiverMoved = searched_ && (to - lastReceiver_).length() > kStill;
+            const bool transmitterMoved =
+                searched_ && (from - lastTransmitter_).length() > kStill;
+            const bool anchorIsReceiver = transmitterMoved && !receiverMoved;
+            FullSearch(anchorIsReceiver ? receiver : transmitter,
+                       anchorIsReceiver ? transmitter : receiver, anchorIsReceiver);
+        }
+        lastTransmitter_ = from;
+        lastReceiver_ = to;
+
+        std::vector<PropagationPath> found;
+        const math::Vec3d &anchor = anchorIsReceiver_ ? receiver : transmitter;
+        const math::Vec3d &other = anchorIsReceiver_ ? transmitter : receiver;
+        for (const Candidate &candidate : candidates_) {
+            ++statistics_.sequencesTraced;
+            auto path = TraceReflectionPath(index_, anchor, other, candidate.walls,
+                                            candidate.images, settings_);
+            if (!path) {
+                continue;
+            }
+            if (anchorIsReceiver_) {
+                std::reverse(path->vertices.begin(), path->vertices.end());
+                std::reverse(path->interactions.begin(), path->interactions.end());
+            }
+            found.push_back(std::move(*path));
+        }
+        if (settings_.diffraction && edges_ != nullptr) {
+            for (PropagationPath &path :
+                 DiffractionSolver(*edges_, settings_).Solve(transmitter, receiver)) {
+                found.push_back(std::move(path));
+            }
+        }
+
+        std::map<std::vector<std::size_t>, double> lengths;
+        const double wavelength = math::kSpeedOfLight / options_.frequencyHz;
+        paths_.clear();
+        for (PropagationPath &path : found) {
+            if (evaluator != nullptr) {
+                evaluator->Apply(path);
+            }
+            TrackedPath tracked;
+            std::vector<std::size_t> key = Key(path);
+            const auto previous = lengths_.find(key);
+            if (previous != lengths_.end() && deltaTimeSeconds > 0.0) {
+                tracked.persistent = true;
+                tracked.lengthRateMetersPerSecond =
+                    (path.lengthMeters - previous->second) / deltaTimeSeconds;
+                tracked.dopplerHz = -tracked.lengthRateMetersPerSecond / wavelength;
+            }
+            lengths.emplace(std::move(key), path.lengthMeters);
+            tracked.path = std::move(path);
+            paths_.push_back(std::move(tracked));
+        }
+        lengths_ = std::move(lengths);
+        return paths_;
+    }
+
+    /**
+     * @brief Forgets all tracked state; the next update runs a full search.
+     */
+    void Reset()
+    {
+        searched_ = false;
+        candidates_.clear();
+        paths_.clear();
+        lengths_.clear();
+    }
+
+    [[nodiscard]] const std::vector<TrackedPath> &Paths() const { return paths_; }
+    [[nodiscard]] const PathTrackingStatistics &Statistics() const { return statistics_; }
+    [[nodiscard]] const PropagationSettings &Settings() const { return settings_; }
+
+    /**
+     * @brief Returns how far the non-anchor endpoint may move before the next full search.
+     */
+    [[nodiscard]] double SafeRadius() const { return searched_ ? safeRadius_ : 0.0; }
+
+    /**
+     * @brief Returns true when the last full search was rooted at the receiver.
+     */
+    [[nodiscard]] bool AnchoredAtReceiver() const { return anchorIsReceiver_; }
+
+private:
+    /** Plan-view displacement below which an endpoint counts as not having moved. */
+    static constexpr double kStill = 1e-9;
+
+    struct Candidate {
+        std::vector<std::size_t> walls;
+        std::vector<math::Vec2d> images;
+    };
+
+    /**
+     * @brief Reflection beam of an image node: rays from apex through the aperture [a, b].
+     */
+    struct Beam {
+        bool        open{false};
+        math::Vec2d apex;
+        math::Vec2d a;
+        math::Vec2d b;
+    };
+
+    bool NeedsFullSearch(const math::Vec2d &from, const math::Vec2d &to) const
+    {
+        if (!searched_) {
+            return true;
+        }
+        const math::Vec2d &anchor = anchorIsReceiver_ ? to : from;
+        const math::Vec2d &other = anchorIsReceiver_ ? from : to;
+        return (anchor - searchAnchor_).length() > kStill ||
+               (other - searchOther_).length() >= safeRadius_;
+    }
+
+    void FullSearch(const math::Vec3d &anchor, const math::Vec3d &other, bool anchorIsReceiver)
+    {
+        ++statistics_.fullSearches;
+        searched_ = true;
+        anchorIsReceiver_ = anchorIsReceiver;
+        searchAnchor_ = math::Vec2d{anchor.x, anchor.y};
+        searchOther_ = math::Vec2d{other.x, other.y};
+        safeRadius_ = std::numeric_limits<double>::infinity();
+        candidates_.clear();
+
+        const ImageTree tree = ImageMethodSolver(index_, settings_).BuildTree(anchor);
+        statistics_.imageNodes += tree.nodes.size();
+        std::vector<Beam> beams(tree.nodes.size());
+        Candidate candidate;
+        tree.Sequence(0, candidate.walls, candidate.images);
+        candidates_.push_back(candidate);
+        for (std::size_t node = 1; node < tree.nodes.size(); ++node) {
+            const ImageTree::Node &current = tree.nodes[node];
+            const WallSegment &wall = index_.Wall(current.wallIndex);
+            Beam &beam = beams[node];
+            if (current.parent == 0) {
+                beam = Beam{true, current.position, wall.start, wall.end};
+            } else if (beams[current.parent].open) {
+                beam = Clip(beams[current.parent], wall);
+                beam.apex = current.position;
+            }
+            if (!beam.open) {
+                continue;
+            }
+            const double clearance = Clearance(beam, searchOther_);
+            if (clearance > 0.0) {
+                safeRadius_ = std::min(safeRadius_, clearance);
+                continue;
+            }
+            tree.Sequence(node, candidate.walls, candidate.images);
+            candidates_.push_back(candidate);
+        }
+    }
+
+    /**
+     * @brief Restricts a wall to the part a parent beam reaches; closed when nothing is left.
+     */
+    static Beam Clip(const Beam &parent, const WallSegment &wall)
+    {
+        const double orientation = Cross2(parent.a - parent.apex, parent.b - parent.apex);
+        const double apexSide = Cross2(parent.b - parent.a, parent.apex - parent.a);
+        if (std::abs(orientation) <= 1e-12 || std::abs(apexSide) <= 1e-12) {
+            return Beam{};
+        }
+        const double sign = orientation > 0.0 ? 1.0 : -1.0;
+        const double beyond = apexSide > 0.0 ? -1.0 : 1.0;
+        // Each half-plane is linear along the wall: f(t) = f(0) + t (f(1) - f(0)) >= 0.
+        const auto constraints = [&](const math::Vec2d &point) {
+            return std::array<double, 3>{
+                sign * Cross2(parent.a - parent.apex, point - parent.apex),
+                sign * Cross2(point - parent.apex, parent.b - parent.apex),
+                beyond * Cross2(parent.b - parent.a, point - parent.a)};
+        };
+        const std::array<double, 3> atStart = constraints(wall.start);
+        const std::array<double, 3> atEnd = constraints(wall.end);
+        double low = 0.0;
+        double high = 1.0;
+        for (std::size_t k = 0; k < atStart.size(); ++k) {
+            const double slope = atEnd[k] - atStart[k];
+            if (std::abs(slope) <= 1e-15) {
+                if (atStart[k] < 0.0) {
+                    return Beam{};
+                }
+            } else if (slope > 0.0) {
+                low = std::max(low, -atStart[k] / slope);
+            } else {
+                high = std::min(high, -atStart[k] / slope);
+            }
+        }
+        if (high - low <= 1e-12) {
+            return Beam{};
+        }
+        return Beam{true, math::Vec2d{}, wall.PointAt(low), wall.PointAt(high)};
+    }
+
+    /**
+     * @brief Returns the distance from a point to a beam, zero when the beam contains it.
+     */
+    static double Clearance(const Beam &beam, const math::Vec2d &point)
+    {
+        const double orientation = Cross2(beam.a - beam.apex, beam.b - beam.apex);
+        const double apexSide = Cross2(beam.b - beam.a, beam.apex - beam.a);
+        const double pointSide = Cross2(beam.b - beam.a, point - beam.a);
+        const bool inside = orientation * Cross2(beam.a - beam.apex, point - beam.apex) >= 0.0 &&
+                            orientation * Cross2(point - beam.apex, beam.b - beam.apex) >= 0.0 &&
+                            apexSide * pointSide < 0.0;
+        if (inside) {
+            return 0.0;
+        }
+        const auto toRay = [&](const math::Vec2d &origin, const math::Vec2d &direction) {
+            const double along = std::max(0.0, (point - origin).dot(direction) /
+                                                   std::max(direction.dot(direction), 1e-24));
+            return (point - (origin + direction * along)).length();
+        };
+        const math::Vec2d aperture = beam.b - beam.a;
+        const double along = std::clamp((point - beam.a).dot(aperture) /
+                                            std::max(aperture.dot(aperture), 1e-24),
+                                        0.0, 1.0);
+        return std::min({(point - (beam.a + aperture * along)).length(),
+                         toRay(beam.a, beam.a - beam.apex), toRay(beam.b, beam.b - beam.apex)});
+    }
+
+    /**
+     * @brief Identifies a path by its reflections and diffractions; transmissions come and go.
+     */
+    static std::vector<std::size_t> Key(const PropagationPath &path)
+    {
+        std::vector<std::size_t> key;
+        for (const PathInteraction &interaction : path.interactions) {
+            if (interaction.type != InteractionType::Transmission) {
+                key.push_back(interaction.wallIndex * 3 +
+                              static_cast<std::size_t>(interaction.type));
+                // Knife-edge paths past both ends of a wall share it; the edge tells them apart.
+                if (interaction.type == InteractionType::Diffraction && path.vertices.size() > 2) {
+                    key.push_back(std::hash<double>{}(path.vertices[1].x));
+                    key.push_back(std::hash<double>{}(path.vertices[1].y));
+                }
+            }
+        }
+        return key;
+    }
+
+    const WallIndex                            &index_;
+    PropagationSettings                         settings_;
+    const EdgeVisibilityCache                  *edges_;
+    PathTrackerOptions                          options_;
+    bool                                        searched_{false};
+    bool                                        anchorIsReceiver_{false};
+    math::Vec2d                                 searchAnchor_;
+    math::Vec2d                                 searchOther_;
+    math::Vec2d                                 lastTransmitter_;
+    math::Vec2d                                 lastReceiver_;
+    double                                      safeRadius_{0.0};
+    std::vector<Candidate>                      candidates_;
+    std::vector<TrackedPath>                    paths_;
+    std::map<std::vector<std::size_t>, double>  lengths_;
+    PathTrackingStatistics                      statistics_;
+};
+
+} // namespace rfmodel::engine
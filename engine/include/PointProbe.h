@@ -0,0 +1,450 @@
+#pragma once
+
+#include "DiffractionSolver.h"
+#include "ImageMethodSolver.h"
+#include "ProbeResult.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "PropagationSolver.h"
+#include "TransmitterState.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Tuning for PointProbe.
+ */
+struct PointProbeOptions {
+    /** Wall-clock limit for one Probe() call. */
+    double latencyBudgetSeconds{1e-3};
+    /** Image subtrees and diffraction edges that cannot reach this level are skipped. */
+    double sensitivityDbm{-110.0};
+};
+
+/**
+ * @brief Evaluates the channel at one receiver position fast enough to follow the mouse.
+ *
+ * The image tree of every transmitter depends only on the transmitter and the walls, so
+ * SetTransmitters() builds them once (pruned with each transmitter's link budget) and
+ * Probe() only traces them against the receiver, reusing the solver's wall grid, the
+ * evaluator's coefficient tables and, with diffraction enabled, the edge visibility cache.
+ *
+ * Probe() works in order of increasing reflection count across all transmitters, nearest
+ * transmitter first, with diffraction after the first-order reflections. Once the latency
+ * budget is spent it returns what it has and clears ProbeResult::complete. A diffraction
+ * search is not started unless its previous duration still fits, so only the first probe
+ * after SetTransmitters() can overrun. The image method is used regardless of the solver's
+ * method, since its trees can be cached.
+ *
+ * All paths are evaluated at the evaluator's frequency. SetTransmitters() and Probe() may
+ * be called from different threads; they are serialized. The solver and evaluator must
+ * outlive the probe.
+ */
+class PointProbe {
+public:
+    PointProbe(const PropagationSolver &solver, const PathEvaluator &evaluator,
+               PointProbeOptions options = {})
+        : solver_(solver), evaluator_(evaluator), options_(options)
+    {
+    }
+
+    PointProbe(const PointProbe &) = delete;
+    PointProbe &operator=(const PointProbe &) = delete;
+
+    [[nodiscard]] const PointProbeOptions &Options() const { return options_; }
+
+    /**
+     * @brief Replaces the transmitters and returns how many image trees had to be built.
+     *
+     * Trees are kept for transmitters whose id, position and power are unchanged. Call it
+     * again after changing the solver's reflection limit.
+     */
+    std::size_t SetTransmitters(const std::vector<TransmitterState> &transmitters)
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        const ImageMethodSolver images(solver_.Index(), solver_.Settings());
+        std::vector<Source> sources;
+        sources.reserve(transmitters.size());
+        std::size_t built = 0;
+        for (const TransmitterState &state : transmitters) {
+            const auto cached =
+                std::find_if(sources_.begin(), sources_.end(), [&](const Source &entry) {
+                    return entry.state.id == state.id &&
+                           entry.state.positionMeters == state.positionMeters &&
+                           entry.state.powerDbm == state.powerDbm &&
+                           entry.depthStart.size() == solver_.Settings().maxReflections + 2;
+                });
+            if (cached != sources_.end()) {
+                sources.push_back(std::move(*cached));
+                sources.back().state = state;
+                continue;
+            }
+            Source source;
+            source.state = state;
+            source.position = math::Vec3d{state.positionMeters[0], state.positionMeters[1],
+                                          state.positionMeters[2]};
+            source.budget = LinkBudget{state.powerDbm, options_.sensitivityDbm,
+                                       evaluator_.FrequencyHz()};
+            source.tree = images.BuildTree(source.position, &source.budget);
+            // BuildTree appends children breadth first, so every depth is one contiguous run.
+            source.depthStart.assign(solver_.Settings().maxReflections + 2,
+                                     source.tree.nodes.size());
+            for (std::size_t node = source.tree.nodes.size(); node-- > 0;) {
+                source.depthStart[source.tree.nodes[node].depth] = node;
+            }
+            for (std::size_t depth = source.depthStart.size() - 1; depth-- > 0;) {
+                source.depthStart[depth] =
+                    std::min(source.depthStart[depth], source.depthStart[depth + 1]);
+            }
+            sources.push_back(std::move(source));
+            ++built;
+        }
+        sources_ = std::move(sources);
+        return built;
+    }
+
+    [[nodiscard]] std::size_t TransmitterCount() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return sources_.size();
+    }
+
+    /**
+     * @brief Returns the number of image nodes held in the cached trees.
+     */
+    [[nodiscard]] std::size_t CachedImageNodes() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t nodes = 0;
+        for (const Source &source : sources_) {
+            nodes += source.tree.nodes.size();
+        }
+        return nodes;
+    }
+
+    /**
+     * @brief Evaluates every transmitter at the receiver position within the latency budget.
+     */
+    [[nodiscard]] ProbeResult Probe(const math::Vec3d &receiver) const
+    {
+        using Clock = std::chrono::steady_clock;
+        const Clock::time_point start = Clock::now();
+        const Clock::time_point deadline =
+            start + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(options_.latencyBudgetSeconds));
+        const std::lock_guard<std::mutex> lock(mutex_);
+        const PropagationSettings &settings = solver_.Settings();
+
+        std::vector<std::size_t> order(sources_.size());
+        std::iota(order.begin(), order.end(), std::size_t{0});
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return PlanDistance(sources_[a].position, receiver) <
+                   PlanDistance(sources_[b].position, receiver);
+        });
+
+        std::vector<Accumulator> sums(sources_.size());
+        std::vector<std::size_t> walls;
+        std::vector<math::Vec2d> images;
+        std::size_t steps = 0;
+        // Checking the clock every few traces keeps its cost out of the profile.
+        const auto expired = [&] { return ++steps % 8 == 0 && Clock::now() > deadline; };
+        const auto add = [&](std::size_t link, PropagationPath &path) {
+            evaluator_.Apply(path);
+            sums[link].Add(path, sources_[link].state.powerDbm);
+        };
+
+        ProbeResult result;
+        bool diffracted = !settings.diffraction || solver_.EdgeCache() == nullptr;
+        for (std::size_t depth = 0; depth <= settings.maxReflections && result.complete;
+             ++depth) {
+            for (std::size_t link : order) {
+                const Source &source = sources_[link];
+                if (depth + 1 >= source.depthStart.size()) {
+                    continue;
+                }
+                for (std::size_t node = source.depthStart[depth];
+                     node < source.depthStart[depth + 1] && result.complete; ++node) {
+                    if (expired()) {
+                        result.complete = false;
+                        break;
+                    }
+                    source.tree.Sequence(node, walls, images);
+                    if (auto path = TraceReflectionPath(solver_.Index(), source.position,
+                                                        receiver, walls, images, settings)) {
+                        add(link, *path);
+                    }
+                }
+            }
+            if (!result.complete) {
+                break;
+            }
+            ++result.completedOrders;
+            if (!diffracted && (depth >= 1 || depth == settings.maxReflections)) {
+                const DiffractionSolver diffraction(*solver_.EdgeCache(), settings);
+                for (std::size_t link : order) {
+                    // One edge search cannot be interrupted, so it only starts when its
+                    // last measured cost still fits.
+                    const Source &source = sources_[link];
+                    const Clock::time_point begin = Clock::now();
+                    if (begin + source.diffractionCost > deadline) {
+                        result.complete = false;
+                        break;
+                    }
+                    for (PropagationPath &path :
+                         diffraction.Solve(source.position, receiver, &source.budget)) {
+                        add(link, path);
+                    }
+                    source.diffractionCost = Clock::now() - begin;
+                }
+                diffracted = true;
+            }
+        }
+
+        double total = 0.0;
+        double strongest = 0.0;
+        result.links.reserve(sources_.size());
+        for (std::size_t link = 0; link < sources_.size(); ++link) {
+            result.links.push_back(sums[link].Finish(sources_[link].state.id));
+            total += sums[link].power;
+            if (sums[link].power > strongest) {
+                strongest = sums[link].power;
+                result.strongestLink = link;
+            }
+        }
+        result.totalPowerDbm = ToDbm(total);
+        result.elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return result;
+    }
+
+private:
+    struct Source {
+        TransmitterState         state;
+        math::Vec3d              position;
+        LinkBudget               budget;
+        ImageTree                tree;
+        /** Nodes of depth d occupy tree.nodes[depthStart[d], depthStart[d + 1]). */
+        std::vector<std::size_t> depthStart;
+        /** Duration of the last diffraction search, used to keep within the budget. */
+        mutable std::chrono::steady_clock::duration diffractionCost{};
+    };
+
+    /** Running sums over the paths of one link, with powers in milliwatts. */
+    struct Accumulator {
+        math::Complex field;
+        double        power{0.0};
+        double        delay{0.0};
+        double        delaySquared{0.0};
+        std::size_t   paths{0};
+
+        void Add(const PropagationPath &path, double transmitPowerDbm)
+        {
+            const double transmitMilliwatts = std::pow(10.0, transmitPowerDbm / 10.0);
+            const double pathPower = transmitMilliwatts * path.gain.magnitudeSquared();
+            const double tau = path.DelaySeconds();
+            field += path.gain * std::sqrt(transmitMilliwatts);
+            power += pathPower;
+            delay += pathPower * tau;
+            delaySquared += pathPower * tau * tau;
+            ++paths;
+        }
+
+        [[nodiscard]] ProbeLink Finish(const std::string &id) const
+        {
+            ProbeLink link;
+            link.transmitterId = id;
+            link.pathCount = paths;
+            if (power <= 0.0) {
+                return link;
+            }
+            link.receivedPowerDbm = ToDbm(power);
+            link.coherentPowerDbm = ToDbm(field.magnitudeSquared());
+            link.phaseRadians = field.phase();
+            link.meanDelaySeconds = delay / power;
+            link.rmsDelaySpreadSeconds = std::sqrt(std::max(
+                0.0, delaySquared / power - link.meanDelaySeconds * link.meanDelaySeconds));
+            return link;
+        }
+    };
+
+    static double ToDbm(double milliwatts)
+    {
+        return milliwatts > 0.0 ? 10.0 * std::log10(milliwatts)
+                                : -std::numeric_limits<double>::infinity();
+    }
+
+    static double PlanDistance(const math::Vec3d &a, const math::Vec3d &b)
+    {
+        return std::hypot(a.x - b.x, a.y - b.y);
+    }
+
+    const PropagationSolver &solver_;
+    const PathEvaluator     &evaluator_;
+    PointProbeOptions        options_;
+    std::vector<Source>      sources_;
+    mutable std::mutex       mutex_;
+};
+
+/**
+ * @brief Counters reported by ProbeWorker::Statistics().
+ */
+struct ProbeWorkerStatistics {
+    std::size_t submitted{0};
+    std::size_t evaluated{0};
+    /** Requests replaced by a newer one before the worker picked them up. */
+    std::size_t superseded{0};
+};
+
+/**
+ * @brief Dedicated thread that answers probe requests, newest first.
+ *
+ * Interactive dragging produces positions faster than they can matter, so only the most
+ * recent request is kept: Submit() replaces any request still waiting and the worker
+ * always evaluates the latest position once it is free. Running on its own thread keeps
+ * probes from queueing behind WorkerPool batches such as heatmap rendering. Results are
+ * delivered to the callback on the worker thread and can also be polled with Latest().
+ */
+class ProbeWorker {
+public:
+    using ProbeFunction = std::function<ProbeResult(const math::Vec3d &)>;
+    using ResultCallback = std::function<void(std::uint64_t, const ProbeResult &)>;
+
+    explicit ProbeWorker(ProbeFunction probe, ResultCallback onResult = {})
+        : probe_(std::move(probe)), onResult_(std::move(onResult))
+    {
+        thread_ = std::thread([this] { WorkLoop(); });
+    }
+
+    /**
+     * @brief Probes through a PointProbe, which must outlive the worker.
+     */
+    explicit ProbeWorker(const PointProbe &probe, ResultCallback onResult = {})
+        : ProbeWorker([&probe](const math::Vec3d &position) { return probe.Probe(position); },
+                      std::move(onResult))
+    {
+    }
+
+    ProbeWorker(const ProbeWorker &) = delete;
+    ProbeWorker &operator=(const ProbeWorker &) = delete;
+
+    ~ProbeWorker()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    /**
+     * @brief Queues a position, replacing any request not yet started, and returns its
+     * sequence number.
+     */
+    std::uint64_t Submit(const math::Vec3d &position)
+    {
+        std::uint64_t sequence = 0;
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (pending_) {
+                ++statistics_.superseded;
+            }
+            pending_ = position;
+            sequence = ++submittedSequence_;
+            ++statistics_.submitted;
+        }
+        wake_.notify_all();
+        return sequence;
+    }
+
+    /**
+     * @brief Returns the newest result, if any, and optionally the request it answers.
+     */
+    [[nodiscard]] std::optional<ProbeResult> Latest(std::uint64_t *sequence = nullptr) const
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (sequence != nullptr) {
+            *sequence = latestSequence_;
+        }
+        return latest_;
+    }
+
+    /**
+     * @brief Waits until a request at least as new as the given one has been answered.
+     *
+     * Returns false on timeout.
+     */
+    bool WaitFor(std::uint64_t sequence, double timeoutSeconds) const
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return ready_.wait_for(lock, std::chrono::duration<double>(timeoutSeconds),
+                               [&] { return latestSequence_ >= sequence; });
+    }
+
+    [[nodiscard]] ProbeWorkerStatistics Statistics() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+private:
+    void WorkLoop()
+    {
+        while (true) {
+            math::Vec3d position;
+            std::uint64_t sequence = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [this] { return stopping_ || pending_.has_value(); });
+                if (stopping_) {
+                    return;
+                }
+                position = *pending_;
+                pending_.reset();
+                sequence = submittedSequence_;
+            }
+            ProbeResult result = probe_(position);
+            if (onResult_) {
+                onResult_(sequence, result);
+            }
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                latest_ = std::move(result);
+                latestSequence_ = sequence;
+                ++statistics_.evaluated;
+            }
+            ready_.notify_all();
+        }
+    }
+
+    ProbeFunction                      probe_;
+    ResultCallback                     onResult_;
+    mutable std::mutex                 mutex_;
+    std::condition_variable            wake_;
+    mutable std::condition_variable    ready_;
+    std::optional<math::Vec3d>         pending_;
+    std::uint64_t                      submittedSequence_{0};
+    std::optional<ProbeResult>         latest_;
+    std::uint64_t                      latestSequence_{0};
+    ProbeWorkerStatistics              statistics_;
+    bool                               stopping_{false};
+    std::thread                        thread_;
+};
+
+} // namespace rfmodel::engine
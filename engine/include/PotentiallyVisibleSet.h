@@ -0,0 +1,228 @@
+#pragma once
+
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Hash of a wall grid's layout and wall coordinates.
+ *
+ * Visibility sets are only valid for the grid they were built on; persisted sets store this
+ * value so stale files can be detected.
+ */
+inline std::uint64_t WallIndexFingerprint(const WallIndex &index)
+{
+    std::uint64_t hash = 14695981039346656037ULL;
+    const auto mix = [&hash](double value) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        for (int byte = 0; byte < 8; ++byte) {
+            hash ^= (bits >> (8 * byte)) & 0xFFU;
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(index.CellSize());
+    mix(static_cast<double>(index.Columns()));
+    mix(static_cast<double>(index.Rows()));
+    for (std::size_t wall = 0; wall < index.WallCount(); ++wall) {
+        mix(index.Wall(wall).start.x);
+        mix(index.Wall(wall).start.y);
+        mix(index.Wall(wall).end.x);
+        mix(index.Wall(wall).end.y);
+    }
+    return hash;
+}
+
+/**
+ * @brief Conservative cell-to-wall potentially-visible sets (PVS) for a static floorplan.
+ *
+ * For every cell of a WallIndex grid the set lists the walls that some point of the cell
+ * may reach through at most TransmissionDepth() other walls. A wall is only left out when
+ * this is proven impossible: every segment from the cell to the wall crosses more than
+ * TransmissionDepth() distinct wall lines whose collinear walls cover the whole range of
+ * crossing points. The crossing range of a convex cell and a segment is an interval
+ * spanned by the 4 x 2 corner-endpoint pairs, so the test is exact for each line, but
+ * occlusion by several non-collinear walls together (e.g. around corners) is not detected.
+ *
+ * Sets are stored as one bitset per cell. Each wall also gets the union of the sets of the
+ * cells it lies in, which bounds what a reflection off that wall can reach next. Building
+ * costs cells x walls x wall lines and is meant to run once per floorplan; see
+ * rfmodel::io::WriteVisibilitySet() to persist the result.
+ */
+class PotentiallyVisibleSet {
+public:
+    PotentiallyVisibleSet() = default;
+
+    /**
+     * @brief Wraps precomputed cell bitsets (CellCount() x WordsPerSet() words) for a grid.
+     */
+    PotentiallyVisibleSet(const WallIndex &index, std::size_t transmissionDepth,
+                          std::vector<std::uint64_t> cellBits)
+        : index_(&index), transmissionDepth_(transmissionDepth),
+          words_((index.WallCount() + 63) / 64), cellBits_(std::move(cellBits)),
+          fingerprint_(WallIndexFingerprint(index))
+    {
+        cellBits_.resize(index.CellCount() * words_, 0);
+        wallBits_.assign(index.WallCount() * words_, 0);
+        for (std::size_t cell = 0; cell < index.CellCount(); ++cell) {
+            for (const std::uint32_t wall : index.CellWalls(cell)) {
+                for (std::size_t word = 0; word < words_; ++word) {
+                    wallBits_[wall * words_ + word] |= cellBits_[cell * words_ + word];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the sets for paths that pass through at most transmissionDepth walls.
+     */
+    static PotentiallyVisibleSet Build(const WallIndex &index, std::size_t transmissionDepth)
+    {
+        const std::vector<WallLine> lines = CollectWallLines(index);
+        const std::size_t words = (index.WallCount() + 63) / 64;
+        std::vector<std::uint64_t> bits(index.CellCount() * words, 0);
+        std::vector<int> sides(lines.size());
+        const double size = index.CellSize();
+
+        for (std::size_t cell = 0; cell < index.CellCount(); ++cell) {
+            const math::Vec2d origin = index.CellOrigin(cell);
+            const math::Vec2d corners[4] = {origin, origin + math::Vec2d{size, 0.0},
+                                            origin + math::Vec2d{size, size},
+                                            origin + math::Vec2d{0.0, size}};
+            for (std::size_t line = 0; line < lines.size(); ++line) {
+                sides[line] = lines[line].Side(corners, 4);
+            }
+            for (std::size_t wall = 0; wall < index.WallCount(); ++wall) {
+                const math::Vec2d ends[2] = {index.Wall(wall).start, index.Wall(wall).end};
+                std::size_t blockers = 0;
+                for (std::size_t line = 0; line < lines.size() && blockers <= transmissionDepth;
+                     ++line) {
+                    if (sides[line] != 0 && lines[line].Side(ends, 2) == -sides[line] &&
+                        lines[line].Blocks(corners, ends)) {
+                        ++blockers;
+                    }
+                }
+                if (blockers <= transmissionDepth) {
+                    bits[cell * words + wall / 64] |= std::uint64_t{1} << (wall % 64);
+                }
+            }
+        }
+        return PotentiallyVisibleSet(index, transmissionDepth, std::move(bits));
+    }
+
+    [[nodiscard]] bool Empty() const { return index_ == nullptr; }
+    [[nodiscard]] const WallIndex &Index() const { return *index_; }
+    [[nodiscard]] std::size_t CellCount() const { return index_ ? index_->CellCount() : 0; }
+    [[nodiscard]] std::size_t WallCount() const { return index_ ? index_->WallCount() : 0; }
+    [[nodiscard]] std::size_t WordsPerSet() const { return words_; }
+    [[nodiscard]] std::uint64_t Fingerprint() const { return fingerprint_; }
+    [[nodiscard]] const std::vector<std::uint64_t> &CellBits() const { return cellBits_; }
+
+    /**
+     * @brief Returns the transmission budget the sets were built for.
+     *
+     * Culling is only conservative for searches allowing at most this many transmissions.
+     */
+    [[nodiscard]] std::size_t TransmissionDepth() const { return transmissionDepth_; }
+
+    /**
+     * @brief Returns true when the wall may be visible from somewhere in the cell.
+     */
+    [[nodiscard]] bool CellSees(std::size_t cell, std::size_t wall) const
+    {
+        return (cellBits_[cell * words_ + wall / 64] >> (wall % 64)) & 1U;
+    }
+
+    /**
+     * @brief Returns true when a path leaving the first wall may reach the second.
+     */
+    [[nodiscard]] bool WallSees(std::size_t from, std::size_t to) const
+    {
+        return (wallBits_[from * words_ + to / 64] >> (to % 64)) & 1U;
+    }
+
+    /**
+     * @brief Returns true when the wall may be visible from the point; points outside the
+     * grid see every wall.
+     */
+    [[nodiscard]] bool PointSees(const math::Vec2d &point, std::size_t wall) const
+    {
+        const auto cell = index_->CellAt(point);
+        return !cell || CellSees(*cell, wall);
+    }
+
+    /**
+     * @brief Lists the walls potentially visible from anywhere in an axis-aligned region,
+     * e.g. a coverage tile.
+     */
+    [[nodiscard]] std::vector<std::size_t> RegionWalls(const math::Vec2d &minCorner,
+                                                       const math::Vec2d &maxCorner) const
+    {
+        std::vector<std::uint64_t> visible(words_, 0);
+        const double size = index_->CellSize();
+        const math::Vec2d gridMin = index_->CellOrigin(0);
+        const math::Vec2d gridMax =
+            gridMin + math::Vec2d{size * static_cast<double>(index_->Columns()),
+                                  size * static_cast<double>(index_->Rows())};
+        const bool outside = minCorner.x < gridMin.x || minCorner.y < gridMin.y ||
+                       maxCorner.x >= gridMax.x || maxCorner.y >= gridMax.y;
+        if (!outside) {
+            const auto first = *index_->CellAt(minCorner);
+            const auto last = *index_->CellAt(maxCorner);
+            const std::size_t columns = index_->Columns();
+            for (std::size_t row = first / columns; row <= last / columns; ++row) {
+                for (std::size_t column = first % columns; column <= last % columns; ++column) {
+                    const std::size_t cell = row * columns + column;
+                    for (std::size_t word = 0; word < words_; ++word) {
+                        visible[word] |= cellBits_[cell * words_ + word];
+                    }
+                }
+            }
+        }
+        std::vector<std::size_t> walls;
+        for (std::size_t wall = 0; wall < WallCount(); ++wall) {
+            if (outside || ((visible[wall / 64] >> (wall % 64)) & 1U)) {
+                walls.push_back(wall);
+            }
+        }
+        return walls;
+    }
+
+    /**
+     * @brief Returns the share of cell-wall pairs that were culled.
+     */
+    [[nodiscard]] double CulledFraction() const
+    {
+        const double pairs = static_cast<double>(CellCount() * WallCount());
+        if (pairs == 0.0) {
+            return 0.0;
+        }
+        std::size_t visible = 0;
+        for (const std::uint64_t word : cellBits_) {
+            visible += std::bitset<64>(word).count();
+        }
+        return 1.0 - static_cast<double>(visible) / pairs;
+    }
+
+private:
+    const WallIndex           *index_{nullptr};
+    std::size_t                transmissionDepth_{0};
+    std::size_t                words_{0};
+    std::vector<std::uint64_t> cellBits_;
+    std::vector<std::uint64_t> wallBits_;
+    std::uint64_t              fingerprint_{0};
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Metrics of one transmitter as seen from a probed position.
+ */
+struct ProbeLink {
+    std::string transmitterId;
+    /** Sum of the path powers; stable under sub-wavelength moves. */
+    double receivedPowerDbm{-std::numeric_limits<double>::infinity()};
+    /** Power of the coherent sum of the path fields, including multipath fading. */
+    double coherentPowerDbm{-std::numeric_limits<double>::infinity()};
+    /** Carrier phase of the coherent sum relative to the transmitter. */
+    double phaseRadians{0.0};
+    /** Power-weighted mean path delay. */
+    double meanDelaySeconds{0.0};
+    /** Power-weighted RMS delay spread around the mean delay. */
+    double rmsDelaySpreadSeconds{0.0};
+    std::size_t pathCount{0};
+};
+
+/**
+ * @brief Result of a single-position probe.
+ */
+struct ProbeResult {
+    static constexpr std::size_t kNoLink = std::numeric_limits<std::size_t>::max();
+
+    /** One entry per transmitter, in the order the transmitters were given. */
+    std::vector<ProbeLink> links;
+    /** Sum of receivedPowerDbm over all links. */
+    double totalPowerDbm{-std::numeric_limits<double>::infinity()};
+    /** Index into links of the strongest transmitter, or kNoLink when nothing was heard. */
+    std::size_t strongestLink{kNoLink};
+    /**
+     * False when the latency budget ran out before the search finished. Reflection orders
+     * are evaluated lowest first, so the paths left out are typically the weakest.
+     */
+    bool complete{true};
+    /**
+     * Number of reflection orders, counting line of sight as order zero, evaluated in full
+     * for every link.
+     */
+    std::size_t completedOrders{0};
+    double elapsedSeconds{0.0};
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "FresnelCoefficients.h"
+#include "MaterialCoefficientCache.h"
+
+#include "rfmodel/math/Complex.h"
+#include "rfmodel/math/Constants.h"
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Kind of wall interaction along a propagation path.
+ */
+enum class InteractionType {
+    Reflection,
+    Transmission,
+    /** Knife-edge diffraction around a wall endpoint; incidenceRadians is unused. */
+    Diffraction,
+};
+
+/**
+ * @brief Knife-edge diffraction loss J(nu) in dB per ITU-R P.526 for Fresnel parameter nu.
+ *
+ * J(0) = 6 dB at the shadow boundary; the loss grows without bound deeper into the shadow
+ * and vanishes for nu <= -0.78.
+ */
+inline double KnifeEdgeLossDb(double fresnelParameter)
+{
+    if (fresnelParameter <= -0.78) {
+        return 0.0;
+    }
+    const double shifted = fresnelParameter - 0.1;
+    return 6.9 + 20.0 * std::log10(std::sqrt(shifted * shifted + 1.0) + shifted);
+}
+
+/**
+ * @brief Fresnel parameter of a knife edge at edge between from and to.
+ *
+ * Uses the path-excess form nu = 2 sqrt(delta / lambda), where delta is the detour over the
+ * edge compared to the straight line; the edge is assumed to shadow the straight line.
+ */
+inline double KnifeEdgeParameter(const math::Vec3d &from, const math::Vec3d &edge,
+                                 const math::Vec3d &to, double wavelengthMeters)
+{
+    const double excess = (edge - from).length() + (to - edge).length() - (to - from).length();
+    return 2.0 * std::sqrt(std::max(0.0, excess) / wavelengthMeters);
+}
+
+/**
+ * @brief A single wall interaction along a propagation path.
+ */
+struct PathInteraction {
+    InteractionType type{InteractionType::Reflection};
+    /** Index of the wall in the scene's wall list. */
+    std::size_t wallIndex{0};
+    /** Angle between the incoming ray and the wall normal in radians, in [0, pi/2]. */
+    double incidenceRadians{0.0};
+};
+
+/**
+ * @brief Geometric description of one transmitter-to-receiver path and its complex gain.
+ */
+struct PropagationPath {
+    /** Transmitter, interaction points in order, and receiver, in meters. */
+    std::vector<math::Vec3d>     vertices;
+    std::vector<PathInteraction> interactions;
+    /** Unfolded path length in meters. */
+    double lengthMeters{0.0};
+    /** Complex field gain from transmitter to receiver; |gain|^2 is the linear power gain. */
+    math::Complex gain;
+
+    /**
+     * @brief Returns the propagation delay in seconds.
+     */
+    [[nodiscard]] double DelaySeconds() const { return lengthMeters / math::kSpeedOfLight; }
+
+    /**
+     * @brief Returns the unit vector pointing from the receiver back along the arriving ray.
+     *
+     * Paths with fewer than two vertices have no direction and return the zero vector.
+     */
+    [[nodiscard]] math::Vec3d ArrivalDirection() const
+    {
+        if (vertices.size() < 2) {
+            return math::Vec3d{};
+        }
+        return (vertices[vertices.size() - 2] - vertices.back()).normalized();
+    }
+};
+
+/**
+ * @brief Computes path gains from tabulated wall coefficients.
+ *
+ * Coefficient tables are resolved once per wall when the evaluator is constructed; each
+ * path interaction afterwards costs a single interpolated table lookup.
+ */
+class PathEvaluator {
+public:
+    PathEvaluator(const std::vector<WallMaterial> &wallMaterials, double frequencyHz,
+                  MaterialCoefficientCache &cache,
+                  Polarization polarization = Polarization::TransverseElectric)
+        : frequencyHz_(frequencyHz),
+          wavenumber_(math::kTwoPi * frequencyHz / math::kSpeedOfLight),
+          polarization_(polarization)
+    {
+        tables_.reserve(wallMaterials.size());
+        for (const WallMaterial &material : wallMaterials) {
+            tables_.push_back(cache.Get(material, frequencyHz));
+        }
+    }
+
+    /**
+     * @brief Returns the carrier frequency the evaluator was bound to in hertz.
+     */
+    [[nodiscard]] double FrequencyHz() const { return frequencyHz_; }
+
+    /**
+     * @brief Returns the coefficient table bound to the given wall.
+     */
+    [[nodiscard]] const MaterialCoefficientTable &Table(std::size_t wallIndex) const
+    {
+        return *tables_[wallIndex];
+    }
+
+    /**
+     * @brief Returns the complex gain of the path including free-space spreading.
+     */
+    [[nodiscard]] math::Complex Evaluate(const PropagationPath &path) const
+    {
+        const double wavelength = math::kTwoPi / wavenumber_;
+        const double length = std::max(path.lengthMeters, wavelength / (4.0 * math::kPi));
+        const double spreading = wavelength / (4.0 * math::kPi * length);
+        math::Complex gain = math::Complex::fromPolar(spreading, -wavenumber_ * length);
+        std::size_t vertex = 0;
+        for (const PathInteraction &interaction : path.interactions) {
+            const MaterialCoefficientTable &table = *tables_[interaction.wallIndex];
+            switch (interaction.type) {
+            case InteractionType::Reflection:
+                gain *= table.Reflection(interaction.incidenceRadians, polarization_);
+                ++vertex;
+                break;
+            case InteractionType::Transmission:
+                gain *= table.Transmission(interaction.incidenceRadians, polarization_);
+                break;
+            case InteractionType::Diffraction:
+                ++vertex;
+                if (vertex + 1 < path.vertices.size()) {
+                    const double parameter =
+                        KnifeEdgeParameter(path.vertices[vertex - 1], path.vertices[vertex],
+                                           path.vertices[vertex + 1], wavelength);
+                    gain *= math::decibelsToAmplitude(-KnifeEdgeLossDb(parameter));
+                }
+                break;
+            }
+        }
+        return gain;
+    }
+
+    /**
+     * @brief Returns the coefficient magnitude of a single interaction.
+     */
+    [[nodiscard]] double InteractionMagnitude(const PathInteraction &interaction) const
+    {
+        const MaterialCoefficientTable &table = *tables_[interaction.wallIndex];
+        switch (interaction.type) {
+        case InteractionType::Reflection:
+            return table.Reflection(interaction.incidenceRadians, polarization_).magnitude();
+        case InteractionType::Transmission:
+            return table.Transmission(interaction.incidenceRadians, polarization_).magnitude();
+        case InteractionType::Diffraction:
+            break;
+        }
+        // Upper bound for a shadowed knife edge; the actual loss depends on path geometry.
+        return math::decibelsToAmplitude(-KnifeEdgeLossDb(0.0));
+    }
+
+    /**
+     * @brief Returns an upper bound on a wall's reflection magnitude over an incidence range.
+     */
+    [[nodiscard]] double MaxReflectionMagnitude(std::size_t wallIndex, double minIncidence,
+                                                double maxIncidence) const
+    {
+        return tables_[wallIndex]->MaxReflectionMagnitude(polarization_, minIncidence,
+                                                          maxIncidence);
+    }
+
+    /**
+     * @brief Evaluates the path and stores the result in its gain field.
+     */
+    void Apply(PropagationPath &path) const { path.gain = Evaluate(path); }
+
+private:
+    double                                          frequencyHz_;
+    double                                          wavenumber_;
+    Polarization                                    polarization_;
+    std::vector<MaterialCoefficientCache::TablePtr> tables_;
+};
+
+} // namespace rfmodel::engine
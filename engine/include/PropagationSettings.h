@@ -0,0 +1,109 @@
+#pragma once
+
+#include "IReceiver.h"
+#include "ITransmitter.h"
+
+#include "rfmodel/math/Constants.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Algorithm used to find propagation paths in a scene.
+ */
+enum class PropagationMethod {
+    /** Deterministic image method; exact, but grows with walls^reflections. */
+    ImageMethod,
+    /** Shooting-and-bouncing rays; approximate, but grows roughly linearly with walls. */
+    RayLaunching,
+};
+
+/**
+ * @brief Returns the configuration keyword for the given propagation method.
+ */
+inline std::string ToString(PropagationMethod method)
+{
+    return method == PropagationMethod::ImageMethod ? "image" : "rays";
+}
+
+/**
+ * @brief Parses "image" or "rays"/"sbr" into a propagation method, returning nullopt
+ * otherwise.
+ */
+inline std::optional<PropagationMethod> ParsePropagationMethod(const std::string &keyword)
+{
+    if (keyword == "image") {
+        return PropagationMethod::ImageMethod;
+    }
+    if (keyword == "rays" || keyword == "sbr") {
+        return PropagationMethod::RayLaunching;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Limits and resolution shared by the path-finding engines.
+ */
+struct PropagationSettings {
+    PropagationMethod method{PropagationMethod::ImageMethod};
+    /** Maximum number of wall reflections per path. */
+    std::size_t maxReflections{2};
+    /** Maximum number of walls a path may pass through. */
+    std::size_t maxTransmissions{4};
+    /** Paths longer than this are ignored, in meters. */
+    double maxPathLengthMeters{1000.0};
+    /** Rays launched over the full circle per transmitter (ray launching only). */
+    std::size_t raysPerTransmitter{3600};
+    /** Rays traced together as one coherent packet (ray launching only). */
+    std::size_t packetSize{8};
+    /** Rays whose accumulated interaction loss exceeds this are dropped, in dB. */
+    double maxInteractionLossDb{60.0};
+    /** Adds knife-edge diffraction around wall endpoints into shadowed regions. */
+    bool diffraction{false};
+    /**
+     * Work is only pruned when its best case stays below sensitivity minus this margin, in
+     * dB; larger margins keep more marginal paths.
+     */
+    double pruningMarginDb{0.0};
+};
+
+/**
+ * @brief Transmit power, carrier and receiver sensitivity used to prune paths that cannot
+ * matter.
+ */
+struct LinkBudget {
+    double transmitPowerDbm{30.0};
+    double sensitivityDbm{-90.0};
+    double frequencyHz{2.4e9};
+
+    /**
+     * @brief Returns true when a path of at least minLengthMeters with at least minLossDb of
+     * interaction loss could still be received above sensitivity minus marginDb.
+     *
+     * The bound assumes free-space spreading over the minimum length, which can only
+     * overestimate the received power.
+     */
+    [[nodiscard]] bool CanReach(double minLengthMeters, double minLossDb, double marginDb) const
+    {
+        const double wavelength = math::kSpeedOfLight / frequencyHz;
+        const double length = std::max(minLengthMeters, wavelength / (4.0 * math::kPi));
+        const double spreadingDb = 20.0 * std::log10(wavelength / (4.0 * math::kPi * length));
+        return transmitPowerDbm + spreadingDb - minLossDb >= sensitivityDbm - marginDb;
+    }
+};
+
+/**
+ * @brief Captures the budget of a transmitter-receiver pair.
+ */
+inline LinkBudget MakeLinkBudget(const ITransmitter &transmitter, const IReceiver &receiver)
+{
+    return LinkBudget{transmitter.Power(), receiver.Sensitivity(),
+                      transmitter.CarrierFrequency()};
+}
+
+} // namespace rfmodel::engine
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "DiffractionSolver.h"
+#include "ImageMethodSolver.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "RayLaunchingSolver.h"
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Front end that finds paths with the propagation method selected for a scene.
+ *
+ * Owns the wall grid shared by both engines and, once diffraction is enabled, the edge
+ * visibility cache built on it. The environment must outlive the solver.
+ */
+class PropagationSolver {
+public:
+    explicit PropagationSolver(const PropagationEnvironment &environment,
+                               PropagationSettings settings = {}, double cellSizeMeters = 0.0)
+        : environment_(environment), index_(environment.walls, cellSizeMeters),
+          settings_(settings)
+    {
+        UpdateEdgeCache();
+    }
+
+    PropagationSolver(const PropagationSolver &) = delete;
+    PropagationSolver &operator=(const PropagationSolver &) = delete;
+
+    [[nodiscard]] const PropagationEnvironment &Environment() const { return environment_; }
+    [[nodiscard]] const WallIndex &Index() const { return index_; }
+    [[nodiscard]] const PropagationSettings &Settings() const { return settings_; }
+
+    /**
+     * @brief Returns the edge visibility cache, or nullptr while diffraction is disabled.
+     */
+    [[nodiscard]] const EdgeVisibilityCache *EdgeCache() const { return edgeCache_.get(); }
+
+    /**
+     * @brief Replaces the solver limits, including the propagation method.
+     */
+    void SetSettings(const PropagationSettings &settings)
+    {
+        settings_ = settings;
+        UpdateEdgeCache();
+    }
+
+    /**
+     * @brief Switches between the image method and ray launching.
+     */
+    void SetMethod(PropagationMethod method) { settings_.method = method; }
+
+    /**
+     * @brief Lets the image method cull walls with precomputed visibility sets built on
+     * Index(); nullptr disables culling. The sets must outlive the solver.
+     */
+    void SetVisibility(const PotentiallyVisibleSet *visibility) { visibility_ = visibility; }
+
+    /**
+     * @brief Finds the paths from one transmitter to each receiver.
+     *
+     * When an evaluator is given, each path's gain is filled in (and ray launching uses it to
+     * drop rays that have become too weak). With diffraction enabled, knife-edge paths into
+     * shadowed regions are appended. A budget turns on sensitivity-bounded pruning in every
+     * engine; statistics then report image nodes explored and pruned.
+     */
+    [[nodiscard]] std::vector<std::vector<PropagationPath>> Solve(
+        const math::Vec3d &transmitter, const std::vector<math::Vec3d> &receivers,
+        const PathEvaluator *evaluator = nullptr, const LinkBudget *budget = nullptr,
+        PathSearchStatistics *statistics = nullptr) const
+    {
+        std::vector<std::vector<PropagationPath>> paths;
+        if (settings_.method == PropagationMethod::RayLaunching) {
+            paths = RayLaunchingSolver(index_, settings_, evaluator)
+                        .Solve(transmitter, receivers, budget);
+        } else {
+            ImageMethodSolver solver(index_, settings_, evaluator);
+            solver.SetVisibility(visibility_);
+            const ImageTree tree = solver.BuildTree(transmitter, budget, statistics);
+            paths.reserve(receivers.size());
+            for (const math::Vec3d &receiver : receivers) {
+                paths.push_back(solver.Trace(tree, receiver, budget, statistics));
+            }
+        }
+        if (settings_.diffraction && edgeCache_) {
+            const DiffractionSolver diffraction(*edgeCache_, settings_);
+            for (std::size_t receiver = 0; receiver < receivers.size(); ++receiver) {
+                for (PropagationPath &path :
+                     diffraction.Solve(transmitter, receivers[receiver], budget)) {
+                    paths[receiver].push_back(std::move(path));
+                }
+            }
+        }
+        if (evaluator != nullptr) {
+            for (std::vector<PropagationPath> &receiverPaths : paths) {
+                for (PropagationPath &path : receiverPaths) {
+                    evaluator->Apply(path);
+                }
+            }
+        }
+        return paths;
+    }
+
+private:
+    /** Edge visibility only depends on the walls, so it is built once on first use. */
+    void UpdateEdgeCache()
+    {
+        if (settings_.diffraction && !edgeCache_) {
+            edgeCache_ = std::make_unique<EdgeVisibilityCache>(index_);
+        }
+    }
+
+    const PropagationEnvironment        &environment_;
+    WallIndex                            index_;
+    PropagationSettings                  settings_;
+    std::unique_ptr<EdgeVisibilityCache> edgeCache_;
+    const PotentiallyVisibleSet         *visibility_{nullptr};
+};
+
+} // namespace rfmodel::engine
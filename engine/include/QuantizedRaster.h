@@ -0,0 +1,161 @@
+#pragma once
+
+#include "CoverageRaster.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief 16-bit fixed-point encoding of decibel values.
+ *
+ * value = minimumDb + code * stepDb. With the defaults (-300 dB, 0.01 dB) codes cover
+ * -300 dB to +355.34 dB and round to within 0.005 dB, well below anything a heatmap or a
+ * link budget can resolve. Values beyond the range saturate to its ends, including -inf.
+ * Code 0xFFFF is reserved for NaN ("no data").
+ */
+struct DecibelQuantizer {
+    static constexpr std::uint16_t kNoData = 0xFFFF;
+
+    double minimumDb{-300.0};
+    double stepDb{0.01};
+
+    /**
+     * @brief Returns the largest value a code can represent.
+     */
+    [[nodiscard]] double MaximumDb() const
+    {
+        return minimumDb + static_cast<double>(kNoData - 1) * stepDb;
+    }
+
+    /**
+     * @brief Returns the worst-case rounding error for values inside the range.
+     */
+    [[nodiscard]] double ResolutionDb() const { return 0.5 * stepDb; }
+
+    [[nodiscard]] std::uint16_t Encode(double valueDb) const
+    {
+        if (std::isnan(valueDb)) {
+            return kNoData;
+        }
+        const double code = std::round((valueDb - minimumDb) / stepDb);
+        return static_cast<std::uint16_t>(
+            std::clamp(code, 0.0, static_cast<double>(kNoData - 1)));
+    }
+
+    [[nodiscard]] double Decode(std::uint16_t code) const
+    {
+        if (code == kNoData) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return minimumDb + static_cast<double>(code) * stepDb;
+    }
+};
+
+/**
+ * @brief Coverage raster stored as 16-bit decibel codes.
+ *
+ * Takes a quarter of the memory of a double raster and half of a float one, which matters
+ * for large maps and for caches holding many of them. The quantization is lossy by design;
+ * keep the source raster when exact values are needed, or compare MaxQuantizationErrorDb()
+ * with the quantizer's resolution.
+ */
+class QuantizedCoverageRaster {
+public:
+    QuantizedCoverageRaster() = default;
+
+    explicit QuantizedCoverageRaster(const RasterGeometry &geometry,
+                                     DecibelQuantizer quantizer = {})
+        : geometry_(geometry), quantizer_(quantizer),
+          codes_(geometry.CellCount(), DecibelQuantizer::kNoData)
+    {
+    }
+
+    /**
+     * @brief Encodes a raster of decibel values.
+     */
+    template <typename Scalar>
+    static QuantizedCoverageRaster FromRaster(const BasicCoverageRaster<Scalar> &raster,
+                                              DecibelQuantizer quantizer = {})
+    {
+        QuantizedCoverageRaster quantized(raster.Geometry(), quantizer);
+        std::transform(raster.Values().begin(), raster.Values().end(), quantized.codes_.begin(),
+                       [&quantizer](Scalar value) {
+                           return quantizer.Encode(static_cast<double>(value));
+                       });
+        return quantized;
+    }
+
+    /**
+     * @brief Decodes the raster at the requested precision.
+     */
+    template <typename Scalar = double>
+    [[nodiscard]] BasicCoverageRaster<Scalar> ToRaster() const
+    {
+        BasicCoverageRaster<Scalar> raster(geometry_);
+        std::transform(codes_.begin(), codes_.end(), raster.Values().begin(),
+                       [this](std::uint16_t code) {
+                           return static_cast<Scalar>(quantizer_.Decode(code));
+                       });
+        return raster;
+    }
+
+    [[nodiscard]] const RasterGeometry &Geometry() const { return geometry_; }
+    [[nodiscard]] const DecibelQuantizer &Quantizer() const { return quantizer_; }
+
+    [[nodiscard]] double At(std::size_t column, std::size_t row) const
+    {
+        return quantizer_.Decode(codes_[row * geometry_.columns + column]);
+    }
+
+    void Set(std::size_t column, std::size_t row, double valueDb)
+    {
+        codes_[row * geometry_.columns + column] = quantizer_.Encode(valueDb);
+    }
+
+    /**
+     * @brief Provides contiguous row-major access to the codes, e.g. for export.
+     */
+    [[nodiscard]] const std::vector<std::uint16_t> &Codes() const { return codes_; }
+
+    [[nodiscard]] std::size_t MemoryBytes() const
+    {
+        return codes_.size() * sizeof(std::uint16_t);
+    }
+
+private:
+    RasterGeometry             geometry_{};
+    DecibelQuantizer           quantizer_{};
+    std::vector<std::uint16_t> codes_;
+};
+
+/**
+ * @brief Returns the largest difference between a raster and its quantized form in dB.
+ *
+ * Cells where both are NaN agree; a NaN on one side only counts as infinite error.
+ */
+template <typename Scalar>
+double MaxQuantizationErrorDb(const BasicCoverageRaster<Scalar> &raster,
+                              const QuantizedCoverageRaster &quantized)
+{
+    double worst = 0.0;
+    const std::vector<std::uint16_t> &codes = quantized.Codes();
+    for (std::size_t cell = 0; cell < codes.size() && cell < raster.Values().size(); ++cell) {
+        const double original = static_cast<double>(raster.Values()[cell]);
+        const double decoded = quantized.Quantizer().Decode(codes[cell]);
+        if (std::isnan(original) && std::isnan(decoded)) {
+            continue;
+        }
+        const double error = std::abs(original - decoded);
+        worst = std::max(worst, std::isnan(error) ? std::numeric_limits<double>::infinity()
+                                                  : error);
+    }
+    return worst;
+}
+
+} // namespace rfmodel::engine
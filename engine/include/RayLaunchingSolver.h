@@ -0,0 +1,281 @@
+#pragma once
+
+#include "ImageMethodSolver.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Work counters reported by RayLaunchingSolver::Solve().
+ */
+struct RayLaunchStatistics {
+    std::size_t packets{0};
+    std::size_t raySegments{0};
+    std::size_t wallTests{0};
+    std::size_t captures{0};
+    /** Rays dropped because their bound fell below sensitivity. */
+    std::size_t prunedRays{0};
+};
+
+/**
+ * @brief Finds propagation paths by shooting and bouncing rays (SBR).
+ *
+ * Rays are launched evenly over azimuth and traced in coherent packets of adjacent rays that
+ * share their interaction history. A packet walks the wall grid once per ray, but every wall
+ * found in a visited cell is intersected with all rays of the packet at once and never
+ * again, so neighbouring rays mostly reuse tests already done. At each wall the packet
+ * splits by hit wall into a reflected and a transmitted child packet.
+ *
+ * A receiver captures a ray segment that passes within half the local ray spacing
+ * (launch angle step times unfolded distance), the 2D reception circle of ray-tube SBR.
+ * Captures only record reflection sequences; the exact geometry of each distinct sequence
+ * is then rebuilt with TraceReflectionPath(), so duplicate captures from neighbouring rays
+ * collapse to one path and gains match the image method for the paths found. Cost grows
+ * with rays times walls near each ray, roughly linearly in wall count.
+ */
+class RayLaunchingSolver {
+public:
+    /**
+     * @param evaluator Optional; when given, rays are dropped once their accumulated
+     *                  interaction loss exceeds PropagationSettings::maxInteractionLossDb.
+     */
+    RayLaunchingSolver(const WallIndex &index, PropagationSettings settings,
+                       const PathEvaluator *evaluator = nullptr)
+        : index_(index), settings_(settings), evaluator_(evaluator)
+    {
+        settings_.raysPerTransmitter = std::max<std::size_t>(1, settings_.raysPerTransmitter);
+        settings_.packetSize = std::max<std::size_t>(1, settings_.packetSize);
+    }
+
+    [[nodiscard]] const PropagationSettings &Settings() const { return settings_; }
+
+    /**
+     * @brief Traces one transmitter against a set of receivers; returns paths per receiver.
+     *
+     * With a budget, a ray is dropped once free-space loss over the distance it has
+     * travelled plus its interaction losses leave it below sensitivity.
+     */
+    [[nodiscard]] std::vector<std::vector<PropagationPath>> Solve(
+        const math::Vec3d &transmitter, const std::vector<math::Vec3d> &receivers,
+        const LinkBudget *budget = nullptr, RayLaunchStatistics *statistics = nullptr) const
+    {
+        RayLaunchStatistics counters;
+        std::vector<std::set<std::vector<std::size_t>>> captured(receivers.size());
+        std::vector<std::uint32_t> mailbox(index_.WallCount(), 0);
+        std::uint32_t stamp = 0;
+
+        const std::size_t rayCount = settings_.raysPerTransmitter;
+        const double angleStep = math::kTwoPi / static_cast<double>(rayCount);
+        const double minAmplitude = std::pow(10.0, -settings_.maxInteractionLossDb / 20.0);
+        const auto keep = [&](double amplitude, double traveled) {
+            if (amplitude < minAmplitude) {
+                return false;
+            }
+            if (budget != nullptr &&
+                !budget->CanReach(traveled, -20.0 * std::log10(amplitude),
+                                  settings_.pruningMarginDb)) {
+                ++counters.prunedRays;
+                return false;
+            }
+            return true;
+        };
+        const math::Vec2d origin{transmitter.x, transmitter.y};
+
+        std::vector<Packet> stack;
+        for (std::size_t first = 0; first < rayCount; first += settings_.packetSize) {
+            Packet packet;
+            for (std::size_t ray = first; ray < std::min(rayCount, first + settings_.packetSize);
+                 ++ray) {
+                const double angle = angleStep * static_cast<double>(ray);
+                packet.rays.push_back(
+                    Ray{origin, math::Vec2d{std::cos(angle), std::sin(angle)}, 0.0, 1.0});
+            }
+            stack.push_back(std::move(packet));
+        }
+
+        std::vector<WallHit> hits;
+        while (!stack.empty()) {
+            Packet packet = std::move(stack.back());
+            stack.pop_back();
+            ++counters.packets;
+            ++stamp;
+
+            // Nearest hit per ray, sharing wall tests across the packet.
+            const std::size_t count = packet.rays.size();
+            hits.assign(count, WallHit{});
+            for (std::size_t ray = 0; ray < count; ++ray) {
+                const Ray &lead = packet.rays[ray];
+                const double reach = settings_.maxPathLengthMeters - lead.traveled;
+                index_.Traverse(lead.origin, lead.direction, reach,
+                                [&](std::size_t cell, double, double tExit) {
+                                    for (const std::uint32_t wall : index_.CellWalls(cell)) {
+                                        if (wall == packet.lastWall || mailbox[wall] == stamp) {
+                                            continue;
+                                        }
+                                        mailbox[wall] = stamp;
+                                        TestWall(packet, wall, hits, counters);
+                                    }
+                                    return hits[ray].t > tExit;
+                                });
+            }
+
+            // Receiver capture along each ray segment.
+            for (std::size_t ray = 0; ray < count; ++ray) {
+                const Ray &current = packet.rays[ray];
+                const double reach = std::min(hits[ray].t,
+                                              settings_.maxPathLengthMeters - current.traveled);
+                ++counters.raySegments;
+                for (std::size_t receiver = 0; receiver < receivers.size(); ++receiver) {
+                    const math::Vec2d offset =
+                        math::Vec2d{receivers[receiver].x, receivers[receiver].y} -
+                        current.origin;
+                    const double along = offset.dot(current.direction);
+                    if (along < 0.0 || along > reach) {
+                        continue;
+                    }
+                    const double miss = std::abs(Cross2(current.direction, offset));
+                    const double radius = 0.5 * angleStep * (current.traveled + along) + 1e-9;
+                    if (miss <= radius && captured[receiver].insert(packet.reflections).second) {
+                        ++counters.captures;
+                    }
+                }
+            }
+
+            // Split the packet by hit wall into reflected and transmitted children.
+            std::map<std::size_t, std::vector<std::size_t>> byWall;
+            for (std::size_t ray = 0; ray < count; ++ray) {
+                if (hits[ray].Valid()) {
+                    byWall[hits[ray].wallIndex].push_back(ray);
+                }
+            }
+            for (const auto &[wall, members] : byWall) {
+                const bool reflect = packet.reflections.size() < settings_.maxReflections;
+                const bool transmit = packet.transmissions < settings_.maxTransmissions;
+                Packet reflected;
+                Packet transmitted;
+                for (const std::size_t ray : members) {
+                    const Ray &current = packet.rays[ray];
+                    const math::Vec2d point = current.origin + current.direction * hits[ray].t;
+                    const double traveled = current.traveled + hits[ray].t;
+                    const math::Vec2d &normal = index_.Wall(wall).normal;
+                    const double cosine = current.direction.dot(normal);
+                    const double incidence = std::acos(std::min(1.0, std::abs(cosine)));
+                    if (reflect) {
+                        const double amplitude =
+                            current.amplitude *
+                            Magnitude(InteractionType::Reflection, wall, incidence);
+                        if (keep(amplitude, traveled)) {
+                            reflected.rays.push_back(
+                                Ray{point, current.direction - normal * (2.0 * cosine), traveled,
+                                    amplitude});
+                        }
+                    }
+                    if (transmit) {
+                        const double amplitude =
+                            current.amplitude *
+                            Magnitude(InteractionType::Transmission, wall, incidence);
+                        if (keep(amplitude, traveled)) {
+                            transmitted.rays.push_back(
+                                Ray{point, current.direction, traveled, amplitude});
+                        }
+                    }
+                }
+                if (!reflected.rays.empty()) {
+                    reflected.reflections = packet.reflections;
+                    reflected.reflections.push_back(wall);
+                    reflected.transmissions = packet.transmissions;
+                    reflected.lastWall = wall;
+                    stack.push_back(std::move(reflected));
+                }
+                if (!transmitted.rays.empty()) {
+                    transmitted.reflections = packet.reflections;
+                    transmitted.transmissions = packet.transmissions + 1;
+                    transmitted.lastWall = wall;
+                    stack.push_back(std::move(transmitted));
+                }
+            }
+        }
+
+        // Rebuild exact geometry for every distinct reflection sequence.
+        std::vector<std::vector<PropagationPath>> paths(receivers.size());
+        std::vector<math::Vec2d> images;
+        for (std::size_t receiver = 0; receiver < receivers.size(); ++receiver) {
+            for (const std::vector<std::size_t> &sequence : captured[receiver]) {
+                images.assign(1, origin);
+                for (const std::size_t wall : sequence) {
+                    images.push_back(index_.Wall(wall).Mirror(images.back()));
+                }
+                if (auto path = TraceReflectionPath(index_, transmitter, receivers[receiver],
+                                                    sequence, images, settings_)) {
+                    paths[receiver].push_back(std::move(*path));
+                }
+            }
+        }
+        if (statistics != nullptr) {
+            *statistics = counters;
+        }
+        return paths;
+    }
+
+private:
+    struct Ray {
+        math::Vec2d origin;
+        /** Unit direction in plan view. */
+        math::Vec2d direction;
+        /** Unfolded plan-view distance from the transmitter to origin in meters. */
+        double traveled{0.0};
+        /** Product of interaction coefficient magnitudes so far. */
+        double amplitude{1.0};
+    };
+
+    struct Packet {
+        std::vector<Ray>         rays;
+        std::vector<std::size_t> reflections;
+        std::size_t              transmissions{0};
+        std::size_t              lastWall{WallIndex::kNoWall};
+    };
+
+    void TestWall(const Packet &packet, std::size_t wall, std::vector<WallHit> &hits,
+                  RayLaunchStatistics &counters) const
+    {
+        const WallSegment &segment = index_.Wall(wall);
+        for (std::size_t ray = 0; ray < packet.rays.size(); ++ray) {
+            const Ray &current = packet.rays[ray];
+            const double reach = settings_.maxPathLengthMeters - current.traveled;
+            const auto hit = IntersectWall(current.origin, current.direction, segment, 1e-9,
+                                           std::min(reach, hits[ray].t));
+            if (hit && hit->t < hits[ray].t) {
+                hits[ray] = *hit;
+                hits[ray].wallIndex = wall;
+            }
+        }
+        counters.wallTests += packet.rays.size();
+    }
+
+    double Magnitude(InteractionType type, std::size_t wall, double incidence) const
+    {
+        if (evaluator_ == nullptr) {
+            return 1.0;
+        }
+        return evaluator_->InteractionMagnitude(PathInteraction{type, wall, incidence});
+    }
+
+    const WallIndex     &index_;
+    PropagationSettings  settings_;
+    const PathEvaluator *evaluator_;
+};
+
+} // namespace rfmodel::engine
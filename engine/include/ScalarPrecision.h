@@ -0,0 +1,64 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Floating-point precision used by the propagation and heatmap kernels.
+ *
+ * Single precision doubles the SIMD lane count and halves memory traffic; see
+ * docs/PrecisionModes.md for the measured accuracy relative to double precision.
+ */
+enum class ScalarPrecision {
+    Single,
+    Double,
+};
+
+/**
+ * @brief Type tag handed to the functor passed to DispatchPrecision().
+ */
+template <typename Scalar>
+struct ScalarTag {
+    using type = Scalar;
+};
+
+/**
+ * @brief Invokes a generic functor with the scalar type matching the runtime precision.
+ *
+ * The functor receives ScalarTag<float> or ScalarTag<double>; both instantiations must
+ * return the same type.
+ */
+template <typename Function>
+decltype(auto) DispatchPrecision(ScalarPrecision precision, Function &&function)
+{
+    if (precision == ScalarPrecision::Single) {
+        return function(ScalarTag<float>{});
+    }
+    return function(ScalarTag<double>{});
+}
+
+/**
+ * @brief Returns the configuration keyword for the given precision.
+ */
+inline std::string ToString(ScalarPrecision precision)
+{
+    return precision == ScalarPrecision::Single ? "single" : "double";
+}
+
+/**
+ * @brief Parses "single"/"float" or "double" into a precision, returning nullopt otherwise.
+ */
+inline std::optional<ScalarPrecision> ParseScalarPrecision(const std::string &keyword)
+{
+    if (keyword == "single" || keyword == "float") {
+        return ScalarPrecision::Single;
+    }
+    if (keyword == "double") {
+        return ScalarPrecision::Double;
+    }
+    return std::nullopt;
+}
+
+} // namespace rfmodel::engine
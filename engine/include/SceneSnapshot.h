@@ -0,0 +1,436 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Axis-aligned rectangle in scene meters used to reason about spatial influence.
+ */
+struct SceneBounds {
+    double minX{0.0};
+    double minY{0.0};
+    double maxX{0.0};
+    double maxY{0.0};
+
+    /**
+     * @brief Returns bounds covering the entire scene plane.
+     */
+    static SceneBounds Everywhere()
+    {
+        constexpr double kInfinity = std::numeric_limits<double>::infinity();
+        return SceneBounds{-kInfinity, -kInfinity, kInfinity, kInfinity};
+    }
+
+    /**
+     * @brief Returns bounds grown by the given margin in meters on every side.
+     */
+    [[nodiscard]] SceneBounds Expanded(double marginMeters) const
+    {
+        return SceneBounds{minX - marginMeters, minY - marginMeters, maxX + marginMeters,
+                           maxY + marginMeters};
+    }
+
+    /**
+     * @brief Returns true when the two rectangles overlap, including touching edges.
+     */
+    [[nodiscard]] bool Intersects(const SceneBounds &other) const
+    {
+        return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY &&
+               other.minY <= maxY;
+    }
+
+    /**
+     * @brief Returns true when the point lies inside or on the rectangle.
+     */
+    [[nodiscard]] bool Contains(double x, double y) const
+    {
+        return x >= minX && x <= maxX && y >= minY && y <= maxY;
+    }
+};
+
+/**
+ * @brief Immutable description of one scene object as stored in a snapshot.
+ *
+ * Fields hold the object's serialized configuration keyed by field name, matching what
+ * ISimulationObject::ApplyConfiguration() consumes. Bounds describe where the object sits
+ * so cached results can tell whether a change can affect them.
+ */
+struct SceneObjectState {
+    std::string                        id;
+    std::string                        type;
+    std::map<std::string, std::string> fields;
+    SceneBounds                        bounds;
+};
+
+using SceneObjectStatePtr = std::shared_ptr<const SceneObjectState>;
+
+/**
+ * @brief Object-level difference between two snapshots.
+ *
+ * A null before pointer marks an added object and a null after pointer a removed one.
+ */
+struct SceneObjectChange {
+    std::string         id;
+    SceneObjectStatePtr before;
+    SceneObjectStatePtr after;
+};
+
+/**
+ * @brief Copy-on-write view of a scene's objects that can be branched cheaply.
+ *
+ * A snapshot is a chain of immutable layers plus a private overlay holding its own edits.
+ * Branch() freezes the overlay into a shared layer and hands back a new snapshot on top of
+ * it, so branching and editing cost is proportional to the number of changed objects, not
+ * the scene size. Object states are shared between branches until replaced, and pointer
+ * identity of a state doubles as its version. Lookups walk the layer chain; chains deeper
+ * than kMaxLayerDepth are flattened automatically.
+ *
+ * Frozen layers are immutable and may be read from any thread. Copying a snapshot shares its
+ * layers and duplicates only its pending edits without touching the source, so a const
+ * snapshot may be copied from several threads at once. Branch() freezes the source's edits
+ * first; a single snapshot instance must not be edited or branched concurrently.
+ */
+class SceneSnapshot {
+public:
+    static constexpr std::size_t kMaxLayerDepth = 32;
+
+    SceneSnapshot() : overlay_(std::make_shared<Layer>()) {}
+
+    SceneSnapshot(const SceneSnapshot &other)
+        : base_(other.base_), overlay_(std::make_shared<Layer>())
+    {
+        overlay_->entries = other.overlay_->entries;
+    }
+
+    SceneSnapshot &operator=(const SceneSnapshot &other)
+    {
+        if (this != &other) {
+            SceneSnapshot copy(other);
+            base_ = std::move(copy.base_);
+            overlay_ = std::move(copy.overlay_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Takes over the source's layers; the source is left as an empty snapshot.
+     */
+    SceneSnapshot(SceneSnapshot &&other)
+        : base_(std::move(other.base_)),
+          overlay_(std::exchange(other.overlay_, std::make_shared<Layer>()))
+    {
+    }
+
+    SceneSnapshot &operator=(SceneSnapshot &&other)
+    {
+        if (this != &other) {
+            std::shared_ptr<Layer> empty = std::make_shared<Layer>();
+            base_ = std::move(other.base_);
+            overlay_ = std::exchange(other.overlay_, std::move(empty));
+        }
+        return *this;
+    }
+
+    ~SceneSnapshot() = default;
+
+    /**
+     * @brief Returns an independent snapshot sharing all current object states.
+     */
+    [[nodiscard]] SceneSnapshot Branch() const
+    {
+        Freeze();
+        SceneSnapshot branch(base_);
+        return branch;
+    }
+
+    /**
+     * @brief Returns the object with the given identifier, or nullptr when absent.
+     */
+    [[nodiscard]] SceneObjectStatePtr Find(const std::string &objectId) const
+    {
+        const auto own = overlay_->entries.find(objectId);
+        if (own != overlay_->entries.end()) {
+            return own->second;
+        }
+        for (const Layer *layer = base_.get(); layer != nullptr; layer = layer->parent.get()) {
+            const auto found = layer->entries.find(objectId);
+            if (found != layer->entries.end()) {
+                return found->second;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Inserts or replaces an object state.
+     */
+    void SetObject(SceneObjectState state)
+    {
+        std::string id = state.id;
+        overlay_->entries[std::move(id)] =
+            std::make_shared<const SceneObjectState>(std::move(state));
+    }
+
+    /**
+     * @brief Replaces a single configuration field of an existing object.
+     *
+     * @return False when the object does not exist.
+     */
+    bool SetField(const std::string &objectId, const std::string &field, const std::string &value)
+    {
+        const SceneObjectStatePtr current = Find(objectId);
+        if (!current) {
+            return false;
+        }
+        SceneObjectState updated = *current;
+        updated.fields[field] = value;
+        SetObject(std::move(updated));
+        return true;
+    }
+
+    /**
+     * @brief Removes an object, returning true when it existed.
+     */
+    bool RemoveObject(const std::string &objectId)
+    {
+        if (!Find(objectId)) {
+            return false;
+        }
+        overlay_->entries[objectId] = nullptr;
+        return true;
+    }
+
+    /**
+     * @brief Visits every live object once.
+     */
+    void ForEachObject(const std::function<void(const SceneObjectStatePtr &)> &visit) const
+    {
+        std::unordered_set<std::string> seen;
+        const auto visitLayer = [&](const Layer &layer) {
+            for (const auto &[id, state] : layer.entries) {
+                if (seen.insert(id).second && state) {
+                    visit(state);
+                }
+            }
+        };
+        visitLayer(*overlay_);
+        for (const Layer *layer = base_.get(); layer != nullptr; layer = layer->parent.get()) {
+            visitLayer(*layer);
+        }
+    }
+
+    /**
+     * @brief Returns all live objects ordered by identifier.
+     */
+    [[nodiscard]] std::vector<SceneObjectStatePtr> Objects() const
+    {
+        std::vector<SceneObjectStatePtr> objects;
+        ForEachObject([&objects](const SceneObjectStatePtr &state) { objects.push_back(state); });
+        std::sort(objects.begin(), objects.end(),
+                  [](const SceneObjectStatePtr &a, const SceneObjectStatePtr &b) {
+                      return a->id < b->id;
+                  });
+        return objects;
+    }
+
+    /**
+     * @brief Returns the number of live objects.
+     */
+    [[nodiscard]] std::size_t ObjectCount() const
+    {
+        std::size_t count = 0;
+        ForEachObject([&count](const SceneObjectStatePtr &) { ++count; });
+        return count;
+    }
+
+    /**
+     * @brief Lists objects that differ between two snapshots, ordered by identifier.
+     *
+     * Only layers above the snapshots' closest shared layer are inspected, so comparing two
+     * branches of a large scene costs time proportional to their edits.
+     */
+    [[nodiscard]] static std::vector<SceneObjectChange> Diff(const SceneSnapshot &from,
+                                                             const SceneSnapshot &to)
+    {
+        std::unordered_set<const Layer *> fromChain;
+        for (const Layer *layer = from.base_.get(); layer != nullptr;
+             layer = layer->parent.get()) {
+            fromChain.insert(layer);
+        }
+        const Layer *common = to.base_.get();
+        while (common != nullptr && fromChain.count(common) == 0) {
+            common = common->parent.get();
+        }
+
+        std::unordered_set<std::string> candidates;
+        const auto collect = [&](const SceneSnapshot &snapshot) {
+            for (const auto &[id, state] : snapshot.overlay_->entries) {
+                candidates.insert(id);
+            }
+            for (const Layer *layer = snapshot.base_.get(); layer != common;
+                 layer = layer->parent.get()) {
+                for (const auto &[id, state] : layer->entries) {
+                    candidates.insert(id);
+                }
+            }
+        };
+        collect(from);
+        collect(to);
+
+        std::vector<SceneObjectChange> changes;
+        for (const std::string &id : candidates) {
+            SceneObjectStatePtr before = from.Find(id);
+            SceneObjectStatePtr after = to.Find(id);
+            if (before != after) {
+                changes.push_back(SceneObjectChange{id, std::move(before), std::move(after)});
+            }
+        }
+        std::sort(changes.begin(), changes.end(),
+                  [](const SceneObjectChange &a, const SceneObjectChange &b) {
+                      return a.id < b.id;
+                  });
+        return changes;
+    }
+
+    /**
+     * @brief Collapses the layer chain into a single layer; costs time linear in scene size.
+     */
+    void Flatten() { FlattenLayers(); }
+
+    /**
+     * @brief Returns the number of frozen layers beneath this snapshot's own edits.
+     */
+    [[nodiscard]] std::size_t LayerDepth() const { return base_ ? base_->depth : 0; }
+
+private:
+    struct Layer {
+        std::unordered_map<std::string, SceneObjectStatePtr> entries;
+        std::shared_ptr<const Layer>                         parent;
+        std::size_t                                          depth{1};
+    };
+
+    explicit SceneSnapshot(std::shared_ptr<const Layer> base)
+        : base_(std::move(base)), overlay_(std::make_shared<Layer>())
+    {
+    }
+
+    // Moves pending edits into a shared immutable layer. Observable contents do not change,
+    // which is why this is callable on const snapshots.
+    void Freeze() const
+    {
+        if (overlay_->entries.empty()) {
+            return;
+        }
+        overlay_->parent = base_;
+        overlay_->depth = base_ ? base_->depth + 1 : 1;
+        base_ = std::move(overlay_);
+        overlay_ = std::make_shared<Layer>();
+        if (base_->depth > kMaxLayerDepth) {
+            FlattenLayers();
+        }
+    }
+
+    void FlattenLayers() const
+    {
+        auto flattened = std::make_shared<Layer>();
+        ForEachObject([&flattened](const SceneObjectStatePtr &state) {
+            flattened->entries.emplace(state->id, state);
+        });
+        base_ = std::move(flattened);
+        overlay_ = std::make_shared<Layer>();
+    }
+
+    mutable std::shared_ptr<const Layer> base_;
+    mutable std::shared_ptr<Layer>       overlay_;
+};
+
+/**
+ * @brief Caches derived results (paths, heatmap tiles) so branches can share them.
+ *
+ * Each entry remembers the snapshot it was computed from and the scene region whose
+ * contents can influence it. A lookup from another snapshot reuses the entry when none of
+ * the objects that differ between the two snapshots overlap that region, before or after
+ * the change. Checking validity costs time proportional to the edits between snapshots.
+ */
+template <typename Value>
+class SnapshotResultCache {
+public:
+    using ValuePtr = std::shared_ptr<const Value>;
+
+    /**
+     * @brief Records a result computed from the snapshot for the given influence region.
+     */
+    void Store(const std::string &key, const SceneSnapshot &snapshot, const SceneBounds &region,
+               ValuePtr value)
+    {
+        auto &entries = entries_[key];
+        entries.push_back(Entry{snapshot.Branch(), region, std::move(value)});
+        if (entries.size() > maxEntriesPerKey_) {
+            entries.erase(entries.begin());
+        }
+    }
+
+    /**
+     * @brief Returns a result still valid for the snapshot, or nullptr when none exists.
+     */
+    [[nodiscard]] ValuePtr Find(const std::string &key, const SceneSnapshot &snapshot) const
+    {
+        const auto found = entries_.find(key);
+        if (found == entries_.end()) {
+            return nullptr;
+        }
+        for (auto entry = found->second.rbegin(); entry != found->second.rend(); ++entry) {
+            if (IsUnaffected(*entry, snapshot)) {
+                return entry->value;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Limits how many snapshot variants are kept per key (oldest evicted first).
+     */
+    void SetMaxEntriesPerKey(std::size_t count)
+    {
+        maxEntriesPerKey_ = std::max<std::size_t>(count, 1);
+    }
+
+    /**
+     * @brief Drops all cached results.
+     */
+    void Clear() { entries_.clear(); }
+
+private:
+    struct Entry {
+        SceneSnapshot snapshot;
+        SceneBounds   region;
+        ValuePtr      value;
+    };
+
+    static bool IsUnaffected(const Entry &entry, const SceneSnapshot &snapshot)
+    {
+        for (const SceneObjectChange &change : SceneSnapshot::Diff(entry.snapshot, snapshot)) {
+            if ((change.before && change.before->bounds.Intersects(entry.region)) ||
+                (change.after && change.after->bounds.Intersects(entry.region))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::size_t                                         maxEntriesPerKey_{4};
+    std::unordered_map<std::string, std::vector<Entry>> entries_;
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,323 @@
+#pragma once
+
+#include "IRunConfig.h"
+#include "IScene.h"
+#include "ISimulationObject.h"
+#include "ISimulationSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Min-priority queue of future event times keyed by integer handles.
+ *
+ * Each handle holds at most one pending event. Rescheduling bumps the handle's generation
+ * instead of searching the heap; stale entries are discarded lazily when they reach the top.
+ */
+class EventQueue {
+public:
+    using Handle = std::size_t;
+
+    /**
+     * @brief Allocates a new handle with no pending event.
+     */
+    Handle Register()
+    {
+        generations_.push_back(0);
+        pending_.emplace_back();
+        return generations_.size() - 1;
+    }
+
+    [[nodiscard]] std::size_t HandleCount() const { return generations_.size(); }
+
+    /**
+     * @brief Replaces the pending event of the handle with one at the given time.
+     */
+    void Schedule(Handle handle, double timeSeconds)
+    {
+        ++generations_[handle];
+        pending_[handle] = timeSeconds;
+        heap_.push(Entry{timeSeconds, handle, generations_[handle]});
+    }
+
+    /**
+     * @brief Drops the pending event of the handle, if any.
+     */
+    void Cancel(Handle handle)
+    {
+        ++generations_[handle];
+        pending_[handle].reset();
+    }
+
+    /**
+     * @brief Returns the pending event time of the handle.
+     */
+    [[nodiscard]] std::optional<double> Pending(Handle handle) const { return pending_[handle]; }
+
+    /**
+     * @brief Returns the earliest pending event time, or nullopt when nothing is scheduled.
+     */
+    [[nodiscard]] std::optional<double> NextTime()
+    {
+        DiscardStale();
+        if (heap_.empty()) {
+            return std::nullopt;
+        }
+        return heap_.top().time;
+    }
+
+    /**
+     * @brief Removes every event due at or before the given time and appends its handle.
+     */
+    void PopDue(double timeSeconds, std::vector<Handle> &due)
+    {
+        for (DiscardStale(); !heap_.empty() && heap_.top().time <= timeSeconds; DiscardStale()) {
+            const Handle handle = heap_.top().handle;
+            heap_.pop();
+            pending_[handle].reset();
+            due.push_back(handle);
+        }
+    }
+
+    /**
+     * @brief Drops all handles and events.
+     */
+    void Clear()
+    {
+        heap_ = {};
+        generations_.clear();
+        pending_.clear();
+    }
+
+private:
+    struct Entry {
+        double        time;
+        Handle        handle;
+        std::uint64_t generation;
+
+        bool operator>(const Entry &other) const
+        {
+            return time != other.time ? time > other.time : handle > other.handle;
+        }
+    };
+
+    void DiscardStale()
+    {
+        while (!heap_.empty() && heap_.top().generation != generations_[heap_.top().handle]) {
+            heap_.pop();
+        }
+    }
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;
+    std::vector<std::uint64_t>                                          generations_;
+    std::vector<std::optional<double>>                                  pending_;
+};
+
+/**
+ * @brief Counters describing the work done by a SimulationStepper run.
+ */
+struct SteppingStatistics {
+    std::size_t steps{0};
+    std::size_t objectSteps{0};
+    std::size_t systemSteps{0};
+    double      endTimeSeconds{0.0};
+};
+
+/**
+ * @brief Advances a scene's objects and systems according to an IRunConfig.
+ *
+ * In SteppingMode::FixedStep every object and system is stepped at TimeStep() until
+ * TotalDuration() or MaxIterations() is reached. In SteppingMode::EventDriven the stepper
+ * jumps straight to the earliest time declared through NextEventTime() and steps only the
+ * objects whose event is due, passing each the full time since it was last stepped; systems
+ * run on every such step and at their own events. Idle stretches therefore cost nothing,
+ * while objects that keep requesting short intervals (fast fading) still get fine steps.
+ * Events closer than MinTimeStep() to the previous step are coalesced into the next one.
+ * An object or system that, right after being stepped, reports a next event that is not
+ * later than the current time is treated as idle instead of being stepped again at the
+ * same instant.
+ *
+ * Objects are stepped directly rather than through IScene::Step(). Call Rebuild() after
+ * adding or removing scene objects.
+ */
+class SimulationStepper {
+public:
+    SimulationStepper(IScene &scene, std::vector<ISimulationSystem *> systems)
+        : scene_(scene), systems_(std::move(systems))
+    {
+        Rebuild();
+    }
+
+    [[nodiscard]] double CurrentTime() const { return now_; }
+
+    /**
+     * @brief Re-reads the scene's objects and re-queries every next event time.
+     */
+    void Rebuild()
+    {
+        objects_ = scene_.GetObjects();
+        queue_.Clear();
+        objectLastStep_.assign(objects_.size(), now_);
+        systemLastStep_.assign(systems_.size(), now_);
+        for (std::size_t index = 0; index < objects_.size() + systems_.size(); ++index) {
+            queue_.Register();
+            Requery(index);
+        }
+    }
+
+    /**
+     * @brief Re-queries the next event of one object, e.g. after it was reconfigured.
+     */
+    void Reschedule(const ISimulationObject &object)
+    {
+        for (std::size_t index = 0; index < objects_.size(); ++index) {
+            if (objects_[index] == &object) {
+                Requery(index);
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Runs for the configured duration starting at the current time.
+     */
+    SteppingStatistics Run(const IRunConfig &config)
+    {
+        const double endTime = now_ + config.TotalDuration().count();
+        return config.Stepping() == SteppingMode::EventDriven ? RunEventDriven(config, endTime)
+                                                              : RunFixedStep(config, endTime);
+    }
+
+    /**
+     * @brief Brings every object that is behind the current time up to date.
+     *
+     * Event-driven runs leave idle objects at their last event; call this before reading
+     * object state that depends on elapsed time.
+     */
+    std::size_t Synchronize()
+    {
+        std::size_t stepped = 0;
+        for (std::size_t index = 0; index < objects_.size(); ++index) {
+            if (objectLastStep_[index] < now_) {
+                StepObject(index);
+                ++stepped;
+            }
+        }
+        return stepped;
+    }
+
+private:
+    SteppingStatistics RunFixedStep(const IRunConfig &config, double endTime)
+    {
+        SteppingStatistics statistics;
+        const double timeStep = config.TimeStep().count();
+        if (timeStep > 0.0) {
+            const std::size_t start = static_cast<std::size_t>(std::llround(now_ / timeStep));
+            while (statistics.steps < config.MaxIterations() && now_ < endTime) {
+                now_ = std::min(endTime,
+                                static_cast<double>(start + statistics.steps + 1) * timeStep);
+                for (std::size_t index = 0; index < objects_.size(); ++index) {
+                    StepObject(index);
+                }
+                statistics.objectSteps += objects_.size();
+                statistics.systemSteps += StepSystems(false);
+                ++statistics.steps;
+            }
+        }
+        statistics.endTimeSeconds = now_;
+        return statistics;
+    }
+
+    SteppingStatistics RunEventDriven(const IRunConfig &config, double endTime)
+    {
+        SteppingStatistics statistics;
+        const double minStep = std::max(0.0, config.MinTimeStep().count());
+        std::vector<EventQueue::Handle> due;
+
+        bool drained = false;
+        while (true) {
+            const std::optional<double> next = queue_.NextTime();
+            const double time = next ? std::max(*next, now_ + minStep) : endTime;
+            if (!next || time > endTime) {
+                drained = true;
+                break;
+            }
+            if (statistics.steps >= config.MaxIterations()) {
+                break;
+            }
+            now_ = time;
+            due.clear();
+            queue_.PopDue(time, due);
+
+            for (const EventQueue::Handle handle : due) {
+                if (handle < objects_.size()) {
+                    StepObject(handle);
+                    Requery(handle, true);
+                    ++statistics.objectSteps;
+                }
+            }
+            statistics.systemSteps += StepSystems(true);
+            ++statistics.steps;
+        }
+
+        // Idle time up to the end of the run is not simulated; objects catch up at their
+        // next event or through Synchronize(). A run cut short by MaxIterations() stops at
+        // its last event so the events still due fire on time in the next run.
+        if (drained) {
+            now_ = std::max(now_, endTime);
+        }
+        statistics.endTimeSeconds = now_;
+        return statistics;
+    }
+
+    void StepObject(std::size_t index)
+    {
+        objects_[index]->Step(now_ - objectLastStep_[index]);
+        objectLastStep_[index] = now_;
+    }
+
+    std::size_t StepSystems(bool requery)
+    {
+        for (std::size_t index = 0; index < systems_.size(); ++index) {
+            systems_[index]->Step(scene_, now_ - systemLastStep_[index]);
+            systemLastStep_[index] = now_;
+            if (requery) {
+                Requery(objects_.size() + index, true);
+            }
+        }
+        return systems_.size();
+    }
+
+    // Right after a step, an event at or before now would reschedule the same instant
+    // forever when MinTimeStep() is zero, so it is dropped.
+    void Requery(std::size_t handle, bool stepped = false)
+    {
+        const std::optional<double> next =
+            handle < objects_.size() ? objects_[handle]->NextEventTime(now_)
+                                     : systems_[handle - objects_.size()]->NextEventTime(now_);
+        if (next && (!stepped || *next > now_)) {
+            queue_.Schedule(handle, *next);
+        } else {
+            queue_.Cancel(handle);
+        }
+    }
+
+    IScene                          &scene_;
+    std::vector<ISimulationSystem *> systems_;
+    std::vector<ISimulationObject *> objects_;
+    std::vector<double>              objectLastStep_;
+    std::vector<double>              systemLastStep_;
+    EventQueue                       queue_;
+    double                           now_{0.0};
+};
+
+} // namespace rfmodel::engine
@@ -0,0 +1,543 @@
+#pragma once
+
+#include "CoverageRaster.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RFMODEL_HAS_PROCESS_SHARDING 1
+#include <cerrno>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#else
+#define RFMODEL_HAS_PROCESS_SHARDING 0
+#endif
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Options for sharding a sweep across local worker processes.
+ */
+struct SweepShardingOptions {
+    /** Number of worker processes; zero evaluates every task in the calling process. */
+    std::size_t workers{2};
+    /** Number of doubles each task produces. */
+    std::size_t valuesPerTask{1};
+    /** Tasks handed to a worker before its earlier results arrive. */
+    std::size_t maxInFlightPerWorker{4};
+    /**
+     * Attempts per task before it is reported as failed. A worker crash or a task that throws
+     * counts against the task being evaluated, not against those queued behind it.
+     */
+    std::size_t maxAttemptsPerTask{3};
+};
+
+/**
+ * @brief Aggregated output of a sharded sweep.
+ */
+struct SweepShardResult {
+    /** Task-major results, valuesPerTask entries per task. */
+    std::vector<double>      values;
+    std::vector<bool>        completed;
+    std::vector<std::size_t> failedTasks;
+    std::size_t              workerRestarts{0};
+    std::vector<std::string> errors;
+
+    [[nodiscard]] bool Ok() const { return failedTasks.empty() && errors.empty(); }
+};
+
+/**
+ * @brief Single-producer single-consumer ring of fixed-size task results.
+ *
+ * The ring lives in caller-provided memory so it can be placed in a MAP_SHARED mapping and
+ * written by a forked worker while the coordinator reads it. Each slot holds the task index
+ * followed by valuesPerTask doubles.
+ */
+class SharedResultRing {
+public:
+    /**
+     * @brief Returns the number of bytes needed for a ring with the given geometry.
+     */
+    static std::size_t RequiredBytes(std::size_t capacity, std::size_t valuesPerTask)
+    {
+        return sizeof(Header) + capacity * SlotBytes(valuesPerTask);
+    }
+
+    /**
+     * @brief Initializes a ring in zeroed memory of at least RequiredBytes().
+     */
+    static SharedResultRing Create(void *memory, std::size_t capacity, std::size_t valuesPerTask)
+    {
+        auto *header = new (memory) Header{};
+        header->capacity = capacity;
+        header->valuesPerTask = valuesPerTask;
+        return SharedResultRing(memory);
+    }
+
+    /**
+     * @brief Attaches to a ring previously initialized with Create().
+     */
+    explicit SharedResultRing(void *memory) : header_(static_cast<Header *>(memory)) {}
+
+    /**
+     * @brief Appends one result; returns false when the ring is full.
+     */
+    bool TryPush(std::uint64_t task, const double *values)
+    {
+        const std::uint64_t head = header_->head.load(std::memory_order_relaxed);
+        if (head - header_->tail.load(std::memory_order_acquire) >= header_->capacity) {
+            return false;
+        }
+        unsigned char *slot = Slot(head);
+        std::memcpy(slot, &task, sizeof(task));
+        std::memcpy(slot + sizeof(task), values, header_->valuesPerTask * sizeof(double));
+        header_->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest result; returns false when the ring is empty.
+     */
+    bool TryPop(std::uint64_t &task, double *values)
+    {
+        const std::uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+        if (tail == header_->head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        const unsigned char *slot = Slot(tail);
+        std::memcpy(&task, slot, sizeof(task));
+        std::memcpy(values, slot + sizeof(task), header_->valuesPerTask * sizeof(double));
+        header_->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] std::size_t Capacity() const { return header_->capacity; }
+    [[nodiscard]] std::size_t ValuesPerTask() const { return header_->valuesPerTask; }
+
+private:
+    struct Header {
+        std::atomic<std::uint64_t> head{0};
+        std::atomic<std::uint64_t> tail{0};
+        std::uint64_t              capacity{0};
+        std::uint64_t              valuesPerTask{0};
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "shared-memory rings require address-free 64-bit atomics");
+
+    static std::size_t SlotBytes(std::size_t valuesPerTask)
+    {
+        return sizeof(std::uint64_t) + valuesPerTask * sizeof(double);
+    }
+
+    unsigned char *Slot(std::uint64_t sequence) const
+    {
+        return reinterpret_cast<unsigned char *>(header_ + 1) +
+               (sequence % header_->capacity) * SlotBytes(header_->valuesPerTask);
+    }
+
+    Header *header_;
+};
+
+/**
+ * @brief Shards independent sweep tasks across forked local worker processes.
+ *
+ * Control traffic uses one Unix stream socket pair per worker: the coordinator writes task
+ * indices, and the worker writes each index back once its result is in the worker's
+ * SharedResultRing, so the coordinator can sleep in poll() instead of spinning. Result
+ * payloads never travel through the socket. Writes never raise SIGPIPE, so a worker dying
+ * mid-exchange shows up as a failed write instead of a signal, without touching the
+ * process-wide signal disposition. Because the control protocol is a plain byte stream, a
+ * network socket can replace the pair for multi-node runs.
+ *
+ * A worker that exits, crashes or lets an exception escape from the task is reaped and
+ * replaced. Tasks run in dispatch order, so only the oldest unfinished task of a lost worker
+ * is charged an attempt; it and the tasks queued behind it are dispatched again, and a task
+ * that reaches maxAttemptsPerTask is reported as failed. A worker always leaves through
+ * _exit(), so it never unwinds into the caller's code or flushes the caller's buffers.
+ *
+ * Workers are created with fork() and inherit the task function, so Run() must be called
+ * before the process starts other threads. On platforms without fork() the tasks run in the
+ * calling process.
+ */
+class SweepCoordinator {
+public:
+    /**
+     * @brief Computes one task's valuesPerTask results into the output buffer.
+     */
+    using TaskFunction = std::function<void(std::size_t task, double *values)>;
+
+    explicit SweepCoordinator(SweepShardingOptions options = {}) : options_(options)
+    {
+        options_.valuesPerTask = std::max<std::size_t>(1, options_.valuesPerTask);
+        options_.maxInFlightPerWorker = std::max<std::size_t>(1, options_.maxInFlightPerWorker);
+        options_.maxAttemptsPerTask = std::max<std::size_t>(1, options_.maxAttemptsPerTask);
+    }
+
+    [[nodiscard]] const SweepShardingOptions &Options() const { return options_; }
+
+    /**
+     * @brief Evaluates tasks [0, taskCount) and gathers their results.
+     */
+    SweepShardResult Run(std::size_t taskCount, const TaskFunction &task) const
+    {
+        SweepShardResult result;
+        result.values.assign(taskCount * options_.valuesPerTask, 0.0);
+        result.completed.assign(taskCount, false);
+        if (taskCount == 0) {
+            return result;
+        }
+#if RFMODEL_HAS_PROCESS_SHARDING
+        if (options_.workers > 0) {
+            RunSharded(taskCount, task, result);
+            return result;
+        }
+#endif
+        for (std::size_t index = 0; index < taskCount; ++index) {
+            task(index, &result.values[index * options_.valuesPerTask]);
+            result.completed[index] = true;
+        }
+        return result;
+    }
+
+private:
+#if RFMODEL_HAS_PROCESS_SHARDING
+    struct Worker {
+        pid_t                    pid{-1};
+        int                      controlFd{-1};
+        void                    *ring{nullptr};
+        std::size_t              ringBytes{0};
+        std::vector<std::size_t> inFlight;
+    };
+
+    static constexpr std::uint64_t kShutdown = ~std::uint64_t{0};
+
+    static bool WriteAll(int fd, const void *data, std::size_t bytes)
+    {
+#if defined(MSG_NOSIGNAL)
+        constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+        // SO_NOSIGPIPE was set on the socket instead.
+        constexpr int kSendFlags = 0;
+#endif
+        const auto *cursor = static_cast<const unsigned char *>(data);
+        while (bytes > 0) {
+            const ssize_t written = ::send(fd, cursor, bytes, kSendFlags);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            cursor += written;
+            bytes -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    static bool ReadAll(int fd, void *data, std::size_t bytes)
+    {
+        auto *cursor = static_cast<unsigned char *>(data);
+        while (bytes > 0) {
+            const ssize_t got = ::read(fd, cursor, bytes);
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            if (got <= 0) {
+                return false;
+            }
+            cursor += got;
+            bytes -= static_cast<std::size_t>(got);
+        }
+        return true;
+    }
+
+    [[noreturn]] void WorkerMain(int controlFd, void *ring, const TaskFunction &task) const
+    {
+        try {
+            SharedResultRing results(ring);
+            std::vector<double> values(options_.valuesPerTask);
+            std::uint64_t index = 0;
+            while (ReadAll(controlFd, &index, sizeof(index)) && index != kShutdown) {
+                std::fill(values.begin(), values.end(), 0.0);
+                task(static_cast<std::size_t>(index), values.data());
+                while (!results.TryPush(index, values.data())) {
+                    ::usleep(100);
+                }
+                if (!WriteAll(controlFd, &index, sizeof(index))) {
+                    break;
+                }
+            }
+        } catch (...) {
+            // Unwinding would continue in the coordinator's code inherited through fork().
+            ::_exit(1);
+        }
+        ::_exit(0);
+    }
+
+    static bool OpenControlSockets(int (&sockets)[2])
+    {
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+            return false;
+        }
+#if !defined(MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+        const int enable = 1;
+        for (const int fd : sockets) {
+            ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+        }
+#endif
+        return true;
+    }
+
+    bool Spawn(Worker &worker, const TaskFunction &task, const std::vector<Worker> &workers,
+               SweepShardResult &result) const
+    {
+        const std::size_t capacity = options_.maxInFlightPerWorker;
+        worker.ringBytes = SharedResultRing::RequiredBytes(capacity, options_.valuesPerTask);
+        worker.ring = ::mmap(nullptr, worker.ringBytes, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (worker.ring == MAP_FAILED) {
+            worker.ring = nullptr;
+            result.errors.push_back("cannot map result ring");
+            return false;
+        }
+        SharedResultRing::Create(worker.ring, capacity, options_.valuesPerTask);
+
+        int sockets[2];
+        if (!OpenControlSockets(sockets)) {
+            result.errors.push_back("cannot create control socket");
+            return false;
+        }
+
+        const pid_t pid = ::fork();
+        if (pid < 0) {
+            ::close(sockets[0]);
+            ::close(sockets[1]);
+            result.errors.push_back("fork failed");
+            return false;
+        }
+        if (pid == 0) {
+            // Drop the coordinator ends of every other worker so their EOFs stay observable.
+            for (const Worker &other : workers) {
+                if (&other != &worker && other.pid > 0) {
+                    ::close(other.controlFd);
+                }
+            }
+            ::close(sockets[0]);
+            WorkerMain(sockets[1], worker.ring, task);
+        }
+        ::close(sockets[1]);
+        worker.pid = pid;
+        worker.controlFd = sockets[0];
+        worker.inFlight.clear();
+        return true;
+    }
+
+    static void Release(Worker &worker)
+    {
+        if (worker.controlFd >= 0) {
+            ::close(worker.controlFd);
+        }
+        if (worker.pid > 0) {
+            int status = 0;
+            while (::waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+            }
+        }
+        if (worker.ring != nullptr) {
+            ::munmap(worker.ring, worker.ringBytes);
+        }
+        worker = Worker{};
+    }
+
+    void Drain(Worker &worker, SweepShardResult &result) const
+    {
+        SharedResultRing ring(worker.ring);
+        std::uint64_t index = 0;
+        std::vector<double> values(options_.valuesPerTask);
+        while (ring.TryPop(index, values.data())) {
+            const auto task = static_cast<std::size_t>(index);
+            std::copy(values.begin(), values.end(),
+                      result.values.begin() +
+                          static_cast<std::ptrdiff_t>(task * options_.valuesPerTask));
+            result.completed[task] = true;
+            worker.inFlight.erase(
+                std::remove(worker.inFlight.begin(), worker.inFlight.end(), task),
+                worker.inFlight.end());
+        }
+    }
+
+    static void Dispatch(Worker &worker, std::deque<std::size_t> &pending,
+                         std::vector<std::size_t> &attempts, std::size_t maxInFlight)
+    {
+        while (!pending.empty() && worker.inFlight.size() < maxInFlight) {
+            const std::uint64_t index = pending.front();
+            if (!WriteAll(worker.controlFd, &index, sizeof(index))) {
+                return;
+            }
+            pending.pop_front();
+            ++attempts[index];
+            worker.inFlight.push_back(static_cast<std::size_t>(index));
+        }
+    }
+
+    void RunSharded(std::size_t taskCount, const TaskFunction &task,
+                    SweepShardResult &result) const
+    {
+        std::deque<std::size_t> pending;
+        for (std::size_t index = 0; index < taskCount; ++index) {
+            pending.push_back(index);
+        }
+        std::vector<std::size_t> attempts(taskCount, 0);
+        std::size_t finished = 0;
+
+        std::vector<Worker> workers(std::min(options_.workers, taskCount));
+        for (Worker &worker : workers) {
+            if (!Spawn(worker, task, workers, result)) {
+                Release(worker);
+            }
+        }
+
+        std::vector<pollfd> descriptors;
+        std::vector<std::uint64_t> acknowledgements(options_.maxInFlightPerWorker);
+        while (finished < taskCount) {
+            descriptors.clear();
+            for (Worker &worker : workers) {
+                if (worker.pid > 0) {
+                    Dispatch(worker, pending, attempts, options_.maxInFlightPerWorker);
+                    descriptors.push_back(pollfd{worker.controlFd, POLLIN, 0});
+                }
+            }
+            if (descriptors.empty()) {
+                result.errors.push_back("no worker processes available");
+                break;
+            }
+            if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                result.errors.push_back("poll failed");
+                break;
+            }
+
+            for (const pollfd &descriptor : descriptors) {
+                if (descriptor.revents == 0) {
+                    continue;
+                }
+                auto worker = std::find_if(workers.begin(), workers.end(), [&](const Worker &w) {
+                    return w.controlFd == descriptor.fd;
+                });
+                const ssize_t got =
+                    ::read(worker->controlFd, acknowledgements.data(),
+                           acknowledgements.size() * sizeof(std::uint64_t));
+                if (got < 0 && errno == EINTR) {
+                    continue;
+                }
+                Drain(*worker, result);
+                if (got > 0) {
+                    continue;
+                }
+
+                // The worker is gone. It died running its oldest unfinished task; the ones
+                // queued behind it never started and get their attempt back.
+                std::vector<std::size_t> lost = worker->inFlight;
+                Release(*worker);
+                for (std::size_t position = lost.size(); position-- > 0;) {
+                    const std::size_t index = lost[position];
+                    if (position > 0) {
+                        --attempts[index];
+                        pending.push_front(index);
+                    } else if (attempts[index] >= options_.maxAttemptsPerTask) {
+                        result.failedTasks.push_back(index);
+                    } else {
+                        pending.push_front(index);
+                    }
+                }
+                if (!pending.empty() && Spawn(*worker, task, workers, result)) {
+                    ++result.workerRestarts;
+                } else if (worker->pid <= 0) {
+                    Release(*worker);
+                }
+            }
+
+            finished = result.failedTasks.size() +
+                       static_cast<std::size_t>(
+                           std::count(result.completed.begin(), result.completed.end(), true));
+        }
+
+        for (Worker &worker : workers) {
+            if (worker.pid > 0) {
+                WriteAll(worker.controlFd, &kShutdown, sizeof(kShutdown));
+                Release(worker);
+            }
+        }
+        std::sort(result.failedTasks.begin(), result.failedTasks.end());
+    }
+#endif
+
+    SweepShardingOptions options_;
+};
+
+/**
+ * @brief Evaluates a coverage raster in square tiles sharded across worker processes.
+ *
+ * Cells of tiles that failed on every attempt are left at zero and listed through the
+ * returned failed tile indices (row-major over the tile grid).
+ *
+ * @param tileCells Tile edge length in cells.
+ * @param evaluate Returns the value of the cell centered at (x, y) in meters.
+ */
+inline CoverageRaster ShardCoverageRaster(const RasterGeometry &geometry, std::size_t tileCells,
+                                          const std::function<double(double, double)> &evaluate,
+                                          SweepShardingOptions options,
+                                          std::vector<std::size_t> *failedTiles = nullptr)
+{
+    tileCells = std::max<std::size_t>(1, tileCells);
+    const std::size_t tileColumns = (geometry.columns + tileCells - 1) / tileCells;
+    const std::size_t tileRows = (geometry.rows + tileCells - 1) / tileCells;
+    options.valuesPerTask = tileCells * tileCells;
+
+    const SweepShardResult shards = SweepCoordinator(options).Run(
+        tileColumns * tileRows, [&](std::size_t tile, double *values) {
+            const std::size_t firstColumn = (tile % tileColumns) * tileCells;
+            const std::size_t firstRow = (tile / tileColumns) * tileCells;
+            for (std::size_t row = 0; row < tileCells; ++row) {
+                for (std::size_t column = 0; column < tileCells; ++column) {
+                    if (firstRow + row < geometry.rows && firstColumn + column < geometry.columns) {
+                        values[row * tileCells + column] =
+                            evaluate(geometry.CellCenterX(firstColumn + column),
+                                     geometry.CellCenterY(firstRow + row));
+                    }
+                }
+            }
+        });
+
+    CoverageRaster raster(geometry);
+    for (std::size_t tile = 0; tile < tileColumns * tileRows; ++tile) {
+        const std::size_t firstColumn = (tile % tileColumns) * tileCells;
+        const std::size_t firstRow = (tile / tileColumns) * tileCells;
+        const double *values = &shards.values[tile * options.valuesPerTask];
+        for (std::size_t row = 0; row < tileCells && firstRow + row < geometry.rows; ++row) {
+            for (std::size_t column = 0;
+                 column < tileCells && firstColumn + column < geometry.columns; ++column) {
+                raster.Set(firstColumn + column, firstRow + row, values[row * tileCells + column]);
+            }
+        }
+    }
+    if (failedTiles != nullptr) {
+        *failedTiles = shards.failedTasks;
+    }
+    return raster;
+}
+
+} // namespace rfmodel::engine
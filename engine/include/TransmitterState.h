@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ITransmitter.h"
+
+#include "rfmodel/math/Constants.h"
+
+#include <array>
+#include <string>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Plain copy of the transmitter properties consumed by propagation kernels.
+ *
+ * Kernels work from this snapshot rather than the virtual ITransmitter accessors so the
+ * data can be laid out contiguously and shared across worker threads.
+ */
+struct TransmitterState {
+    std::string           id;
+    std::array<double, 3> positionMeters{};
+    double                carrierFrequencyHz{2.4e9};
+    double                powerDbm{30.0};
+
+    /**
+     * @brief Returns the carrier wavelength in meters.
+     */
+    [[nodiscard]] double WavelengthMeters() const
+    {
+        return math::kSpeedOfLight / carrierFrequencyHz;
+    }
+};
+
+/**
+ * @brief Captures the current state of a transmitter.
+ */
+inline TransmitterState MakeTransmitterState(const ITransmitter &transmitter)
+{
+    TransmitterState state;
+    state.id = transmitter.Id();
+    state.positionMeters = transmitter.Position();
+    state.carrierFrequencyHz = transmitter.CarrierFrequency();
+    state.powerDbm = transmitter.Power();
+    return state;
+}
+
+} // namespace rfmodel::engine
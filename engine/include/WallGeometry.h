@@ -0,0 +1,519 @@
+#pragma once
+
+#include "FresnelCoefficients.h"
+#include "IWall.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Returns the z component of the cross product of two plan-view vectors.
+ */
+inline double Cross2(const math::Vec2d &a, const math::Vec2d &b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+/**
+ * @brief Plan-view footprint of a vertical wall.
+ *
+ * Walls extend infinitely in height, so all path geometry is solved in the XY plane and
+ * heights are interpolated along the unfolded path afterwards.
+ */
+struct WallSegment {
+    math::Vec2d start;
+    math::Vec2d end;
+    /** Unit normal in plan view. */
+    math::Vec2d normal;
+
+    [[nodiscard]] math::Vec2d Direction() const { return end - start; }
+    [[nodiscard]] double Length() const { return Direction().length(); }
+
+    /**
+     * @brief Returns the point at the given fraction along the wall.
+     */
+    [[nodiscard]] math::Vec2d PointAt(double fraction) const
+    {
+        return start + Direction() * fraction;
+    }
+
+    /**
+     * @brief Returns the signed distance of a point from the wall's supporting line.
+     */
+    [[nodiscard]] double SignedDistance(const math::Vec2d &point) const
+    {
+        return normal.dot(point - start);
+    }
+
+    /**
+     * @brief Returns the distance from a point to the nearest point of the wall.
+     */
+    [[nodiscard]] double Distance(const math::Vec2d &point) const
+    {
+        const math::Vec2d direction = Direction();
+        const double lengthSquared = direction.dot(direction);
+        const double fraction =
+            lengthSquared > 0.0
+                ? std::clamp((point - start).dot(direction) / lengthSquared, 0.0, 1.0)
+                : 0.0;
+        return (point - PointAt(fraction)).length();
+    }
+
+    /**
+     * @brief Mirrors a point across the wall's supporting line.
+     */
+    [[nodiscard]] math::Vec2d Mirror(const math::Vec2d &point) const
+    {
+        return point - normal * (2.0 * SignedDistance(point));
+    }
+};
+
+/**
+ * @brief Builds the plan-view footprint of a wall from its centroid, normal, and length.
+ */
+inline WallSegment MakeWallSegment(const IWall &wall)
+{
+    const auto position = wall.Position();
+    const auto normal3 = wall.Normal();
+    const math::Vec2d normal = math::Vec2d{normal3[0], normal3[1]}.normalized();
+    const math::Vec2d tangent{-normal.y, normal.x};
+    const math::Vec2d center{position[0], position[1]};
+    const double half = 0.5 * wall.Length();
+    return WallSegment{center - tangent * half, center + tangent * half, normal};
+}
+
+/**
+ * @brief Builds a wall footprint between two plan-view endpoints.
+ */
+inline WallSegment MakeWallSegment(const math::Vec2d &start, const math::Vec2d &end)
+{
+    const math::Vec2d direction = (end - start).normalized();
+    return WallSegment{start, end, math::Vec2d{direction.y, -direction.x}};
+}
+
+/**
+ * @brief Parameters of an intersection between a ray or segment and a wall.
+ */
+struct WallHit {
+    /** Parameter along the query, in units of the query direction vector. */
+    double t{std::numeric_limits<double>::infinity()};
+    /** Fraction along the wall from start to end. */
+    double u{0.0};
+    std::size_t wallIndex{std::numeric_limits<std::size_t>::max()};
+
+    [[nodiscard]] bool Valid() const { return std::isfinite(t); }
+};
+
+/**
+ * @brief Intersects origin + t * direction, t in (tMin, tMax], with a wall.
+ */
+inline std::optional<WallHit> IntersectWall(const math::Vec2d &origin,
+                                            const math::Vec2d &direction,
+                                            const WallSegment &wall, double tMin, double tMax)
+{
+    const math::Vec2d edge = wall.Direction();
+    const double denominator = Cross2(direction, edge);
+    if (std::abs(denominator) <= 1e-12) {
+        return std::nullopt;
+    }
+    const math::Vec2d offset = wall.start - origin;
+    const double t = Cross2(offset, edge) / denominator;
+    const double u = Cross2(offset, direction) / denominator;
+    if (t <= tMin || t > tMax || u < 0.0 || u > 1.0) {
+        return std::nullopt;
+    }
+    return WallHit{t, u};
+}
+
+/**
+ * @brief Walls of a scene prepared for path finding.
+ */
+struct PropagationEnvironment {
+    std::vector<WallSegment>  walls;
+    std::vector<WallMaterial> materials;
+
+    /**
+     * @brief Captures the geometry and materials of a set of walls.
+     */
+    static PropagationEnvironment FromWalls(const std::vector<const IWall *> &sceneWalls)
+    {
+        PropagationEnvironment environment;
+        for (const IWall *wall : sceneWalls) {
+            environment.walls.push_back(MakeWallSegment(*wall));
+            environment.materials.push_back(MakeWallMaterial(*wall));
+        }
+        return environment;
+    }
+
+    /**
+     * @brief Appends a wall described directly by its footprint and material.
+     */
+    std::size_t AddWall(const WallSegment &segment, const WallMaterial &material)
+    {
+        walls.push_back(segment);
+        materials.push_back(material);
+        return walls.size() - 1;
+    }
+};
+
+/**
+ * @brief Uniform grid over wall footprints for ray and segment queries.
+ *
+ * Each cell lists the walls whose footprint passes through it. Queries walk the cells along
+ * the ray (2D DDA) and stop at the first cell whose exit lies beyond the nearest hit, so the
+ * cost grows with the walls near the ray rather than with the total wall count.
+ */
+class WallIndex {
+public:
+    WallIndex() = default;
+
+    /**
+     * @param cellSizeMeters Grid pitch; zero picks one from the mean wall length.
+     */
+    explicit WallIndex(const std::vector<WallSegment> &walls, double cellSizeMeters = 0.0)
+        : walls_(&walls)
+    {
+        minX_ = minY_ = std::numeric_limits<double>::infinity();
+        double maxX = -minX_;
+        double maxY = -minY_;
+        double totalLength = 0.0;
+        for (const WallSegment &wall : walls) {
+            for (const math::Vec2d &point : {wall.start, wall.end}) {
+                minX_ = std::min(minX_, point.x);
+                minY_ = std::min(minY_, point.y);
+                maxX = std::max(maxX, point.x);
+                maxY = std::max(maxY, point.y);
+            }
+            totalLength += wall.Length();
+        }
+        if (walls.empty()) {
+            minX_ = minY_ = 0.0;
+            maxX = maxY = 1.0;
+        }
+        if (cellSizeMeters <= 0.0) {
+            cellSizeMeters = walls.empty() ? 1.0 : totalLength / static_cast<double>(walls.size());
+        }
+        cellSize_ = std::max(cellSizeMeters, 1e-3);
+        minX_ -= 1e-6;
+        minY_ -= 1e-6;
+        columns_ = static_cast<std::size_t>((maxX - minX_) / cellSize_) + 1;
+        rows_ = static_cast<std::size_t>((maxY - minY_) / cellSize_) + 1;
+        cells_.assign(columns_ * rows_, {});
+
+        for (std::size_t index = 0; index < walls.size(); ++index) {
+            const WallSegment &wall = walls[index];
+            const math::Vec2d direction = wall.Direction();
+            Traverse(wall.start, direction, 1.0, [&](std::size_t cell, double, double) {
+                cells_[cell].push_back(static_cast<std::uint32_t>(index));
+                return true;
+            });
+        }
+    }
+
+    [[nodiscard]] std::size_t WallCount() const { return walls_ ? walls_->size() : 0; }
+    [[nodiscard]] const WallSegment &Wall(std::size_t index) const { return (*walls_)[index]; }
+    [[nodiscard]] double CellSize() const { return cellSize_; }
+    [[nodiscard]] std::size_t Columns() const { return columns_; }
+    [[nodiscard]] std::size_t Rows() const { return rows_; }
+    [[nodiscard]] std::size_t CellCount() const { return cells_.size(); }
+
+    /**
+     * @brief Returns the grid cell containing a plan-view point, if it lies inside the grid.
+     */
+    [[nodiscard]] std::optional<std::size_t> CellAt(const math::Vec2d &point) const
+    {
+        const double column = std::floor((point.x - minX_) / cellSize_);
+        const double row = std::floor((point.y - minY_) / cellSize_);
+        if (column < 0.0 || row < 0.0 || column >= static_cast<double>(columns_) ||
+            row >= static_cast<double>(rows_)) {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(row) * columns_ + static_cast<std::size_t>(column);
+    }
+
+    /**
+     * @brief Returns the lower-left corner of a grid cell.
+     */
+    [[nodiscard]] math::Vec2d CellOrigin(std::size_t cell) const
+    {
+        return math::Vec2d{minX_ + static_cast<double>(cell % columns_) * cellSize_,
+                           minY_ + static_cast<double>(cell / columns_) * cellSize_};
+    }
+
+    /**
+     * @brief Returns the walls registered in one cell.
+     */
+    [[nodiscard]] const std::vector<std::uint32_t> &CellWalls(std::size_t cell) const
+    {
+        return cells_[cell];
+    }
+
+    /**
+     * @brief Visits the cells crossed by origin + t * direction for t in [0, tMax].
+     *
+     * The visitor receives (cell, tEnter, tExit) and returns false to stop the walk.
+     */
+    template <typename Visitor>
+    void Traverse(const math::Vec2d &origin, const math::Vec2d &direction, double tMax,
+                  Visitor &&visit) const
+    {
+        if (cells_.empty()) {
+            return;
+        }
+        // Clip the query to the grid bounds.
+        const double maxX = minX_ + static_cast<double>(columns_) * cellSize_;
+        const double maxY = minY_ + static_cast<double>(rows_) * cellSize_;
+        double tEnter = 0.0;
+        double tLeave = tMax;
+        const double lower[2] = {minX_, minY_};
+        const double upper[2] = {maxX, maxY};
+        const double start[2] = {origin.x, origin.y};
+        const double step[2] = {direction.x, direction.y};
+        for (int axis = 0; axis < 2; ++axis) {
+            if (std::abs(step[axis]) < 1e-15) {
+                if (start[axis] < lower[axis] || start[axis] > upper[axis]) {
+                    return;
+                }
+                continue;
+            }
+            double t0 = (lower[axis] - start[axis]) / step[axis];
+            double t1 = (upper[axis] - start[axis]) / step[axis];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            tEnter = std::max(tEnter, t0);
+            tLeave = std::min(tLeave, t1);
+        }
+        if (tEnter > tLeave) {
+            return;
+        }
+
+        const math::Vec2d entry = origin + direction * tEnter;
+        auto column = static_cast<std::ptrdiff_t>(
+            std::clamp((entry.x - minX_) / cellSize_, 0.0, static_cast<double>(columns_ - 1)));
+        auto row = static_cast<std::ptrdiff_t>(
+            std::clamp((entry.y - minY_) / cellSize_, 0.0, static_cast<double>(rows_ - 1)));
+        const std::ptrdiff_t stepColumn = direction.x > 0.0 ? 1 : -1;
+        const std::ptrdiff_t stepRow = direction.y > 0.0 ? 1 : -1;
+        const double inf = std::numeric_limits<double>::infinity();
+        const auto boundary = [&](double base, std::ptrdiff_t index, std::ptrdiff_t stepSign) {
+            return base + static_cast<double>(index + (stepSign > 0 ? 1 : 0)) * cellSize_;
+        };
+        double tNextX = std::abs(direction.x) < 1e-15
+                            ? inf
+                            : (boundary(minX_, column, stepColumn) - origin.x) / direction.x;
+        double tNextY = std::abs(direction.y) < 1e-15
+                            ? inf
+                            : (boundary(minY_, row, stepRow) - origin.y) / direction.y;
+        const double tDeltaX =
+            std::abs(direction.x) < 1e-15 ? inf : cellSize_ / std::abs(direction.x);
+        const double tDeltaY =
+            std::abs(direction.y) < 1e-15 ? inf : cellSize_ / std::abs(direction.y);
+
+        double tCell = tEnter;
+        while (true) {
+            const double tExit = std::min({tNextX, tNextY, tLeave});
+            const std::size_t cell =
+                static_cast<std::size_t>(row) * columns_ + static_cast<std::size_t>(column);
+            if (!visit(cell, tCell, tExit) || tExit >= tLeave) {
+                return;
+            }
+            tCell = tExit;
+            if (tNextX < tNextY) {
+                column += stepColumn;
+                tNextX += tDeltaX;
+            } else {
+                row += stepRow;
+                tNextY += tDeltaY;
+            }
+            if (column < 0 || row < 0 || column >= static_cast<std::ptrdiff_t>(columns_) ||
+                row >= static_cast<std::ptrdiff_t>(rows_)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the nearest wall hit by origin + t * direction for t in (tMin, tMax].
+     *
+     * @param ignoreWall Wall skipped by the query, e.g. the one the ray just left.
+     */
+    [[nodiscard]] WallHit FirstHit(const math::Vec2d &origin, const math::Vec2d &direction,
+                                   double tMin, double tMax,
+                                   std::size_t ignoreWall = kNoWall) const
+    {
+        WallHit best;
+        Traverse(origin, direction, tMax, [&](std::size_t cell, double, double tExit) {
+            for (const std::uint32_t index : cells_[cell]) {
+                if (index == ignoreWall) {
+                    continue;
+                }
+                const auto hit = IntersectWall(origin, direction, Wall(index), tMin, tMax);
+                if (hit && hit->t < best.t) {
+                    best = *hit;
+                    best.wallIndex = index;
+                }
+            }
+            return best.t > tExit;
+        });
+        return best;
+    }
+
+    /**
+     * @brief Lists the walls crossed by the segment from a to b, ordered along the segment.
+     *
+     * Walls equal to ignoreA or ignoreB (typically the walls the segment starts and ends on)
+     * are skipped. Crossings at the same point, such as a wall junction, are ordered by wall
+     * index, so the order does not depend on the sort or on the grid.
+     */
+    [[nodiscard]] std::vector<WallHit> Crossings(const math::Vec2d &a, const math::Vec2d &b,
+                                                 std::size_t ignoreA = kNoWall,
+                                                 std::size_t ignoreB = kNoWall) const
+    {
+        std::vector<WallHit> hits;
+        const math::Vec2d direction = b - a;
+        Traverse(a, direction, 1.0, [&](std::size_t cell, double, double) {
+            for (const std::uint32_t index : cells_[cell]) {
+                if (index == ignoreA || index == ignoreB) {
+                    continue;
+                }
+                if (auto hit = IntersectWall(a, direction, Wall(index), 1e-9, 1.0 - 1e-9)) {
+                    hit->wallIndex = index;
+                    hits.push_back(*hit);
+                }
+            }
+            return true;
+        });
+        std::sort(hits.begin(), hits.end(), [](const WallHit &lhs, const WallHit &rhs) {
+            return lhs.wallIndex != rhs.wallIndex ? lhs.wallIndex < rhs.wallIndex : lhs.t < rhs.t;
+        });
+        hits.erase(std::unique(hits.begin(), hits.end(),
+                               [](const WallHit &lhs, const WallHit &rhs) {
+                                   return lhs.wallIndex == rhs.wallIndex;
+                               }),
+                   hits.end());
+        std::sort(hits.begin(), hits.end(), [](const WallHit &lhs, const WallHit &rhs) {
+            return lhs.t != rhs.t ? lhs.t < rhs.t : lhs.wallIndex < rhs.wallIndex;
+        });
+        return hits;
+    }
+
+    static constexpr std::size_t kNoWall = std::numeric_limits<std::size_t>::max();
+
+private:
+    const std::vector<WallSegment>         *walls_{nullptr};
+    double                                  minX_{0.0};
+    double                                  minY_{0.0};
+    double                                  cellSize_{1.0};
+    std::size_t                             columns_{0};
+    std::size_t                             rows_{0};
+    std::vector<std::vector<std::uint32_t>> cells_;
+};
+
+/**
+ * @brief Collinear walls merged into disjoint intervals along their shared line.
+ *
+ * Used for conservative occlusion tests: a line blocks a convex region from a target when
+ * every segment between them crosses the line inside one interval.
+ */
+struct WallLine {
+    math::Vec2d                           origin;
+    math::Vec2d                           direction;
+    math::Vec2d                           normal;
+    std::vector<std::pair<double, double>> intervals;
+
+    [[nodiscard]] double Offset(const math::Vec2d &point) const
+    {
+        return (point - origin).dot(normal);
+    }
+
+    /** +1 or -1 when all points lie strictly on one side, 0 otherwise. */
+    [[nodiscard]] int Side(const math::Vec2d *points, std::size_t count) const
+    {
+        constexpr double kEpsilon = 1e-9;
+        bool above = true;
+        bool below = true;
+        for (std::size_t index = 0; index < count; ++index) {
+            const double offset = Offset(points[index]);
+            above = above && offset > kEpsilon;
+            below = below && offset < -kEpsilon;
+        }
+        return above ? 1 : (below ? -1 : 0);
+    }
+
+    /** True when every segment from a corner to an end crosses the line inside one interval. */
+    [[nodiscard]] bool Blocks(const math::Vec2d (&corners)[4],
+                              const math::Vec2d (&ends)[2]) const
+    {
+        constexpr double kEpsilon = 1e-9;
+        double lowest = std::numeric_limits<double>::infinity();
+        double highest = -lowest;
+        for (const math::Vec2d &corner : corners) {
+            for (const math::Vec2d &end : ends) {
+                const double from = Offset(corner);
+                const double to = Offset(end);
+                const math::Vec2d crossing = corner + (end - corner) * (from / (from - to));
+                const double along = (crossing - origin).dot(direction);
+                lowest = std::min(lowest, along);
+                highest = std::max(highest, along);
+            }
+        }
+        return std::any_of(intervals.begin(), intervals.end(), [&](const auto &interval) {
+            return interval.first < lowest - kEpsilon && interval.second > highest + kEpsilon;
+        });
+    }
+};
+
+/**
+ * @brief Groups the walls of an index by supporting line; degenerate walls are skipped.
+ */
+inline std::vector<WallLine> CollectWallLines(const WallIndex &index)
+{
+    constexpr double kTolerance = 1e-6;
+    std::vector<WallLine> lines;
+    for (std::size_t wall = 0; wall < index.WallCount(); ++wall) {
+        const WallSegment &segment = index.Wall(wall);
+        if (segment.Length() < kTolerance) {
+            continue;
+        }
+        auto line = std::find_if(lines.begin(), lines.end(), [&](const WallLine &candidate) {
+            return std::abs(candidate.Offset(segment.start)) < kTolerance &&
+                   std::abs(candidate.Offset(segment.end)) < kTolerance;
+        });
+        if (line == lines.end()) {
+            const math::Vec2d direction = segment.Direction().normalized();
+            lines.push_back(WallLine{segment.start, direction,
+                                     math::Vec2d{-direction.y, direction.x}, {}});
+            line = lines.end() - 1;
+        }
+        const double first = (segment.start - line->origin).dot(line->direction);
+        const double second = (segment.end - line->origin).dot(line->direction);
+        line->intervals.emplace_back(std::min(first, second), std::max(first, second));
+    }
+    // Merge touching or overlapping intervals so runs of walls without gaps block as one.
+    for (WallLine &line : lines) {
+        std::sort(line.intervals.begin(), line.intervals.end());
+        std::vector<std::pair<double, double>> merged;
+        for (const auto &interval : line.intervals) {
+            if (!merged.empty() && interval.first <= merged.back().second) {
+                merged.back().second = std::max(merged.back().second, interval.second);
+            } else {
+                merged.push_back(interval);
+            }
+        }
+        line.intervals = std::move(merged);
+    }
+    return lines;
+}
+
+} // namespace rfmodel::engine
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "WallGeometry.h"
+
+#include "rfmodel/math/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Affine map from plan-view meters to device pixels.
+ *
+ * Uses the same element layout as QTransform: x' = m11 x + m21 y + dx and
+ * y' = m12 x + m22 y + dy.
+ */
+struct ScreenTransform {
+    double m11{1.0};
+    double m12{0.0};
+    double m21{0.0};
+    double m22{1.0};
+    double dx{0.0};
+    double dy{0.0};
+
+    [[nodiscard]] math::Vec2d Map(const math::Vec2d &point) const
+    {
+        return math::Vec2d{m11 * point.x + m21 * point.y + dx, m12 * point.x + m22 * point.y + dy};
+    }
+};
+
+/**
+ * @brief Integer device pixel.
+ */
+struct PixelPoint {
+    int x{0};
+    int y{0};
+
+    [[nodiscard]] bool operator==(const PixelPoint &other) const
+    {
+        return x == other.x && y == other.y;
+    }
+
+    [[nodiscard]] bool operator!=(const PixelPoint &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Axis-aligned rectangle in device pixels, left <= right and top <= bottom.
+ */
+struct PixelBounds {
+    double left{0.0};
+    double top{0.0};
+    double right{0.0};
+    double bottom{0.0};
+};
+
+/**
+ * @brief Clips a segment to a rectangle (Liang-Barsky); returns false when nothing is left.
+ */
+inline bool ClipSegment(math::Vec2d &start, math::Vec2d &end, const PixelBounds &bounds)
+{
+    const double dx = end.x - start.x;
+    const double dy = end.y - start.y;
+    double enter = 0.0;
+    double exit = 1.0;
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {start.x - bounds.left, bounds.right - start.x, start.y - bounds.top,
+                         bounds.bottom - start.y};
+    for (int side = 0; side < 4; ++side) {
+        if (p[side] == 0.0) {
+            if (q[side] < 0.0) {
+                return false;
+            }
+            continue;
+        }
+        const double t = q[side] / p[side];
+        if (p[side] < 0.0) {
+            enter = std::max(enter, t);
+        } else {
+            exit = std::min(exit, t);
+        }
+        if (enter > exit) {
+            return false;
+        }
+    }
+    const math::Vec2d origin = start;
+    const math::Vec2d direction{dx, dy};
+    start = origin + direction * enter;
+    end = origin + direction * exit;
+    return true;
+}
+
+/**
+ * @brief Packs a snapped segment into a key that is the same for either direction.
+ *
+ * Coordinates are kept to 16 bits, which covers any clipped segment of a layer up to
+ * 65535 device pixels wide.
+ */
+inline std::uint64_t SnappedSegmentKey(PixelPoint a, PixelPoint b)
+{
+    if (std::make_pair(b.x, b.y) < std::make_pair(a.x, a.y)) {
+        std::swap(a, b);
+    }
+    const auto field = [](int value) { return static_cast<std::uint64_t>(value & 0xFFFF); };
+    return field(a.x) << 48U | field(a.y) << 32U | field(b.x) << 16U | field(b.y);
+}
+
+/**
+ * @brief Lines and points left after snapping walls to device pixels.
+ */
+struct SnappedWalls {
+    std::vector<std::pair<PixelPoint, PixelPoint>> lines;
+    /** Walls that collapsed into a single pixel. */
+    std::vector<PixelPoint> points;
+    /** Walls dropped because their snapped form had already been emitted. */
+    std::size_t duplicates{0};
+};
+
+/**
+ * @brief Maps walls to a width x height pixel layer, clips them, snaps their endpoints to
+ * pixels, and drops walls whose snapped form was already emitted.
+ *
+ * A zoomed-out floorplan therefore costs about one primitive per occupied pixel span
+ * instead of one per wall. The clip rectangle reaches one pixel past the layer so that
+ * round caps at the border are still drawn. Emitted keys live in a flat open-addressing
+ * table, which keeps 100k walls well inside a frame (see bench/WallLayerBench.cpp).
+ */
+inline SnappedWalls SnapWallsToPixels(const std::vector<WallSegment> &walls,
+                                      const ScreenTransform &transform, int width, int height)
+{
+    SnappedWalls result;
+    const PixelBounds bounds{-1.0, -1.0, static_cast<double>(width) + 1.0,
+                             static_cast<double>(height) + 1.0};
+    const auto snap = [](const math::Vec2d &point) {
+        return PixelPoint{static_cast<int>(std::lround(point.x)),
+                          static_cast<int>(std::lround(point.y))};
+    };
+    // Linear probing over a power-of-two table at most half full; zero marks a free slot,
+    // so the (0, 0)-(0, 0) key is tracked separately.
+    std::size_t capacity = 16;
+    while (capacity < 2 * walls.size()) {
+        capacity *= 2;
+    }
+    std::vector<std::uint64_t> emitted(capacity, 0);
+    bool emittedZero = false;
+    const auto insert = [&](std::uint64_t key) {
+        if (key == 0) {
+            return !std::exchange(emittedZero, true);
+        }
+        std::size_t slot = (key * 0x9e3779b97f4a7c15ULL >> 20U) & (capacity - 1);
+        while (emitted[slot] != 0) {
+            if (emitted[slot] == key) {
+                return false;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+        emitted[slot] = key;
+        return true;
+    };
+    for (const WallSegment &wall : walls) {
+        math::Vec2d start = transform.Map(wall.start);
+        math::Vec2d end = transform.Map(wall.end);
+        if (!ClipSegment(start, end, bounds)) {
+            continue;
+        }
+        const PixelPoint a = snap(start);
+        const PixelPoint b = snap(end);
+        if (!insert(SnappedSegmentKey(a, b))) {
+            ++result.duplicates;
+            continue;
+        }
+        if (a == b) {
+            result.points.push_back(a);
+        } else {
+            result.lines.emplace_back(a, b);
+        }
+    }
+    return result;
+}
+
+} // namespace rfmodel::engine
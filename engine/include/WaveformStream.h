@@ -0,0 +1,397 @@
+#pragma once
+
+#include "IChannel.h"
+#include "IReceiver.h"
+#include "ITransmitter.h"
+#include "PropagationPath.h"
+#include "WorkerPool.h"
+
+#include "rfmodel/math/Complex.h"
+#include "rfmodel/math/Constants.h"
+#include "rfmodel/math/Fft.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief One discrete arrival of a channel impulse response.
+ */
+struct ChannelTap {
+    double        delaySeconds{0.0};
+    /** Complex baseband amplitude; |gain|^2 is the linear power gain. */
+    math::Complex gain;
+
+    bool operator==(const ChannelTap &other) const
+    {
+        return delaySeconds == other.delaySeconds && gain == other.gain;
+    }
+};
+
+using ImpulseResponse = std::vector<ChannelTap>;
+
+/**
+ * @brief Produces a link's impulse response at the given simulation time in seconds.
+ */
+using ImpulseResponseSource = std::function<ImpulseResponse(double)>;
+
+/**
+ * @brief Converts traced propagation paths into impulse response taps.
+ */
+inline ImpulseResponse MakeImpulseResponse(const std::vector<PropagationPath> &paths)
+{
+    ImpulseResponse response;
+    response.reserve(paths.size());
+    for (const PropagationPath &path : paths) {
+        response.push_back({path.DelaySeconds(), path.gain});
+    }
+    return response;
+}
+
+/**
+ * @brief Samples a channel model as a single-tap response.
+ *
+ * The delay comes from PropagationDelay() and the amplitude from PathLoss() and
+ * FadingPower(), which are queried again for every block so time-varying fading is followed.
+ * The channel and endpoints must outlive the returned source.
+ */
+inline ImpulseResponseSource MakeChannelResponseSource(const IChannel &channel,
+                                                       const ITransmitter &transmitter,
+                                                       const IReceiver &receiver)
+{
+    return [&channel, &transmitter, &receiver](double) {
+        const double loss = channel.PathLoss(transmitter, receiver);
+        const double fading = std::max(0.0, channel.FadingPower(transmitter, receiver));
+        const double amplitude = std::pow(10.0, -loss / 20.0) * std::sqrt(fading);
+        return ImpulseResponse{{channel.PropagationDelay(transmitter, receiver),
+                                math::Complex{amplitude, 0.0}}};
+    };
+}
+
+/**
+ * @brief Tuning for WaveformStream.
+ */
+struct WaveformOptions {
+    double      sampleRateHz{20e6};
+    /** Samples per source per Process() call. */
+    std::size_t blockSize{4096};
+    /** Longest delay kept in the filters; later taps are dropped and counted. */
+    double      maxDelaySeconds{5e-6};
+    /** Worker threads including the caller; zero uses the hardware concurrency. */
+    std::size_t workers{0};
+};
+
+/**
+ * @brief Counters accumulated by WaveformStream::Process().
+ */
+struct WaveformStatistics {
+    std::size_t blocks{0};
+    std::size_t linkBlocks{0};
+    std::size_t responseUpdates{0};
+    std::size_t droppedTaps{0};
+};
+
+/**
+ * @brief Thread-safe free list of equally sized sample buffers.
+ */
+class ComplexBufferPool {
+public:
+    /**
+     * @brief Returns a buffer of the given size, reusing a released one when available.
+     */
+    [[nodiscard]] std::vector<math::Complex> Acquire(std::size_t size)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty()) {
+                std::vector<math::Complex> buffer = std::move(free_.back());
+                free_.pop_back();
+                buffer.resize(size);
+                return buffer;
+            }
+        }
+        ++allocations_;
+        return std::vector<math::Complex>(size);
+    }
+
+    void Release(std::vector<math::Complex> &&buffer)
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(std::move(buffer));
+    }
+
+    /**
+     * @brief Returns how many buffers were allocated rather than reused.
+     */
+    [[nodiscard]] std::size_t Allocations() const { return allocations_; }
+
+private:
+    std::mutex                              mutex_;
+    std::vector<std::vector<math::Complex>> free_;
+    std::atomic<std::size_t>                allocations_{0};
+};
+
+/**
+ * @brief Streams baseband samples through time-varying multipath channels.
+ *
+ * Sources are transmit sample streams; links connect a source to a receiver through an
+ * impulse response source. Each Process() call consumes one block per source and produces
+ * one block per link using FFT overlap-save. Blocks are cut into segments sized for a
+ * transform of about four filter lengths, which keeps the working set in cache; every source
+ * segment is transformed once and shared by its links, and each link multiplies by its
+ * cached filter spectrum. Responses are sampled once per block at the block start time, so
+ * the channel is piecewise constant over a block; a link whose taps did not change reuses
+ * its spectrum. Fractional delays use a windowed sinc interpolator. Links run in parallel on
+ * a WorkerPool and draw their scratch buffers from a ComplexBufferPool. Once the output
+ * blocks have been sized, the only per-block allocations are the ImpulseResponse vectors
+ * returned by the links' response sources.
+ *
+ * Cost grows with sample rate times link count. On one worker a stream keeps up with real
+ * time up to about 36 links at 1 MHz or 6 links at 5 MHz; at 20 MHz and 36 links it reaches
+ * about 0.08x and needs more workers or fewer links (see bench/WaveformBench.cpp).
+ */
+class WaveformStream {
+public:
+    explicit WaveformStream(WaveformOptions options = {})
+        : options_(options), pool_(options.workers)
+    {
+        options_.blockSize = std::max<std::size_t>(1, options_.blockSize);
+        options_.maxDelaySeconds = std::max(0.0, options_.maxDelaySeconds);
+        const auto delaySamples =
+            static_cast<std::size_t>(std::ceil(options_.maxDelaySeconds * options_.sampleRateHz));
+        filterLength_ = delaySamples + kInterpolatorTaps;
+        const std::size_t whole = math::nextPowerOfTwo(options_.blockSize + filterLength_ - 1);
+        plan_ = math::FftPlan(std::min(whole, math::nextPowerOfTwo(4 * filterLength_)));
+        hop_ = plan_.size() - filterLength_ + 1;
+        segments_ = (options_.blockSize + hop_ - 1) / hop_;
+    }
+
+    WaveformStream(const WaveformStream &) = delete;
+    WaveformStream &operator=(const WaveformStream &) = delete;
+
+    /**
+     * @brief Registers a transmit sample stream and returns its index.
+     */
+    std::size_t AddSource()
+    {
+        Source source;
+        source.history.assign(plan_.size(), math::Complex{});
+        source.spectra.assign(segments_ * plan_.size(), math::Complex{});
+        sources_.push_back(std::move(source));
+        return sources_.size() - 1;
+    }
+
+    /**
+     * @brief Connects a source through a channel response and returns the link index.
+     *
+     * Returns the current link count without adding anything when the source is unknown.
+     */
+    std::size_t AddLink(std::size_t source, ImpulseResponseSource response)
+    {
+        if (source >= sources_.size()) {
+            return links_.size();
+        }
+        Link link;
+        link.source = source;
+        link.response = std::move(response);
+        link.spectrum.assign(plan_.size(), math::Complex{});
+        links_.push_back(std::move(link));
+        return links_.size() - 1;
+    }
+
+    /**
+     * @brief Processes one block for every source and writes one block per link.
+     *
+     * sourceBlocks must hold SourceCount() blocks of Options().blockSize samples; linkBlocks is
+     * resized to LinkCount() blocks. Returns false and fills error on mismatched input.
+     */
+    bool Process(const std::vector<std::vector<math::Complex>> &sourceBlocks,
+                 std::vector<std::vector<math::Complex>> &linkBlocks,
+                 std::string *error = nullptr)
+    {
+        const std::size_t block = options_.blockSize;
+        if (sourceBlocks.size() != sources_.size()) {
+            if (error != nullptr) {
+                *error = "expected " + std::to_string(sources_.size()) + " source blocks";
+            }
+            return false;
+        }
+        for (const std::vector<math::Complex> &samples : sourceBlocks) {
+            if (samples.size() != block) {
+                if (error != nullptr) {
+                    *error = "source blocks must hold " + std::to_string(block) + " samples";
+                }
+                return false;
+            }
+        }
+
+        const double time = TimeSeconds();
+        for (Link &link : links_) {
+            ImpulseResponse taps = link.response ? link.response(time) : ImpulseResponse{};
+            if (!link.valid || taps != link.taps) {
+                link.taps = std::move(taps);
+                link.dirty = true;
+                link.valid = true;
+                ++statistics_.responseUpdates;
+            }
+        }
+
+        const std::size_t size = plan_.size();
+        pool_.ParallelFor(sources_.size(), [&](std::size_t index) {
+            Source &source = sources_[index];
+            for (std::size_t segment = 0; segment < segments_; ++segment) {
+                const std::size_t first = segment * hop_;
+                const auto count = static_cast<std::ptrdiff_t>(std::min(hop_, block - first));
+                std::move(source.history.begin() + count, source.history.end(),
+                          source.history.begin());
+                const auto samples =
+                    sourceBlocks[index].begin() + static_cast<std::ptrdiff_t>(first);
+                std::copy(samples, samples + count, source.history.end() - count);
+                math::Complex *spectrum = source.spectra.data() + segment * size;
+                std::copy(source.history.begin(), source.history.end(), spectrum);
+                plan_.forward(spectrum);
+            }
+        });
+
+        linkBlocks.resize(links_.size());
+        pool_.ParallelFor(links_.size(), [&](std::size_t index) {
+            Link &link = links_[index];
+            link.dropped = 0;
+            if (link.dirty) {
+                link.dropped = BuildSpectrum(link);
+                link.dirty = false;
+            }
+            std::vector<math::Complex> &output = linkBlocks[index];
+            output.resize(block);
+            std::vector<math::Complex> scratch = buffers_.Acquire(size);
+            for (std::size_t segment = 0; segment < segments_; ++segment) {
+                const math::Complex *input = sources_[link.source].spectra.data() + segment * size;
+                for (std::size_t bin = 0; bin < size; ++bin) {
+                    scratch[bin] = input[bin] * link.spectrum[bin];
+                }
+                plan_.inverse(scratch.data());
+                const std::size_t first = segment * hop_;
+                const auto count = static_cast<std::ptrdiff_t>(std::min(hop_, block - first));
+                std::copy(scratch.end() - count, scratch.end(),
+                          output.begin() + static_cast<std::ptrdiff_t>(first));
+            }
+            buffers_.Release(std::move(scratch));
+        });
+
+        for (const Link &link : links_) {
+            statistics_.droppedTaps += link.dropped;
+        }
+        ++statistics_.blocks;
+        statistics_.linkBlocks += links_.size();
+        return true;
+    }
+
+    /**
+     * @brief Clears sample history and time while keeping sources and links.
+     */
+    void Reset()
+    {
+        for (Source &source : sources_) {
+            std::fill(source.history.begin(), source.history.end(), math::Complex{});
+        }
+        for (Link &link : links_) {
+            link.valid = false;
+        }
+        statistics_ = {};
+    }
+
+    /**
+     * @brief Returns the simulation time of the next block's first sample.
+     */
+    [[nodiscard]] double TimeSeconds() const
+    {
+        return static_cast<double>(statistics_.blocks * options_.blockSize) /
+               options_.sampleRateHz;
+    }
+
+    [[nodiscard]] const WaveformOptions &Options() const { return options_; }
+    [[nodiscard]] const WaveformStatistics &Statistics() const { return statistics_; }
+    [[nodiscard]] std::size_t SourceCount() const { return sources_.size(); }
+    [[nodiscard]] std::size_t LinkCount() const { return links_.size(); }
+    [[nodiscard]] std::size_t FilterLength() const { return filterLength_; }
+    [[nodiscard]] std::size_t TransformSize() const { return plan_.size(); }
+    [[nodiscard]] const ComplexBufferPool &Buffers() const { return buffers_; }
+
+private:
+    /** Length of the windowed sinc used for fractional delays; taps sit at delay - 3 .. + 4. */
+    static constexpr std::size_t kInterpolatorTaps = 8;
+
+    struct Source {
+        std::vector<math::Complex> history;
+        /** One transform per segment of the current block. */
+        std::vector<math::Complex> spectra;
+    };
+
+    struct Link {
+        std::size_t                source{0};
+        ImpulseResponseSource      response;
+        ImpulseResponse            taps;
+        std::vector<math::Complex> spectrum;
+        /** Taps dropped when the spectrum was rebuilt during the current block. */
+        std::size_t                dropped{0};
+        bool                       valid{false};
+        bool                       dirty{false};
+    };
+
+    /**
+     * @brief Rebuilds a link's filter spectrum from its taps; returns how many were dropped.
+     */
+    std::size_t BuildSpectrum(Link &link)
+    {
+        constexpr auto kHalf = static_cast<std::ptrdiff_t>(kInterpolatorTaps / 2);
+        std::fill(link.spectrum.begin(), link.spectrum.end(), math::Complex{});
+        std::size_t dropped = 0;
+        for (const ChannelTap &tap : link.taps) {
+            const double delay = tap.delaySeconds * options_.sampleRateHz;
+            const auto base = static_cast<std::ptrdiff_t>(std::floor(delay));
+            if (delay < 0.0 || base + kHalf >= static_cast<std::ptrdiff_t>(filterLength_)) {
+                ++dropped;
+                continue;
+            }
+            const double fraction = delay - static_cast<double>(base);
+            if (fraction == 0.0) {
+                link.spectrum[static_cast<std::size_t>(base)] += tap.gain;
+                continue;
+            }
+            for (std::ptrdiff_t offset = 1 - kHalf; offset <= kHalf; ++offset) {
+                const std::ptrdiff_t sample = base + offset;
+                if (sample < 0) {
+                    continue;
+                }
+                const double x = static_cast<double>(offset) - fraction;
+                const double sinc = std::sin(math::kPi * x) / (math::kPi * x);
+                const double window =
+                    0.5 + 0.5 * std::cos(math::kPi * x / static_cast<double>(kHalf));
+                link.spectrum[static_cast<std::size_t>(sample)] += tap.gain * (sinc * window);
+            }
+        }
+        plan_.forward(link.spectrum.data());
+        return dropped;
+    }
+
+    WaveformOptions     options_;
+    WorkerPool          pool_;
+    math::FftPlan       plan_;
+    std::size_t         filterLength_{0};
+    std::size_t         hop_{0};
+    std::size_t         segments_{0};
+    std::vector<Source> sources_;
+    std::vector<Link>   links_;
+    ComplexBufferPool   buffers_;
+    WaveformStatistics  statistics_;
+};
+
+} // namespace rfmodel::engine
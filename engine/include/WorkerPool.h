@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rfmodel::engine {
+
+/**
+ * @brief Persistent worker threads for fork-join loops inside one process.
+ *
+ * Threads are started once and parked between calls, so ParallelFor() is cheap enough to
+ * run per processing block. The calling thread takes part in the work. One ParallelFor()
+ * may run at a time; calls from several threads are serialized. Tasks are passed by
+ * reference rather than wrapped in a std::function, so a call does not allocate.
+ */
+class WorkerPool {
+public:
+    /**
+     * @param workers Total threads including the caller; zero uses the hardware concurrency.
+     */
+    explicit WorkerPool(std::size_t workers = 0)
+    {
+        if (workers == 0) {
+            workers = std::max(1U, std::thread::hardware_concurrency());
+        }
+        for (std::size_t index = 1; index < workers; ++index) {
+            threads_.emplace_back([this] { WorkLoop(); });
+        }
+    }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    ~WorkerPool()
+    {
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Returns the number of threads that run tasks, including the caller.
+     */
+    [[nodiscard]] std::size_t Size() const { return threads_.size() + 1; }
+
+    /**
+     * @brief Runs task(index) for every index in [0, count) and waits for all of them.
+     *
+     * If a task throws, indices not yet started are skipped, and the first exception is
+     * rethrown once every thread has left the task.
+     */
+    template <typename Task>
+    void ParallelFor(std::size_t count, const Task &task)
+    {
+        if (count == 0) {
+            return;
+        }
+        if (threads_.empty() || count == 1) {
+            for (std::size_t index = 0; index < count; ++index) {
+                task(index);
+            }
+            return;
+        }
+        Run(count, &task, [](const void *context, std::size_t index) {
+            (*static_cast<const Task *>(context))(index);
+        });
+    }
+
+private:
+    using Invoke = void (*)(const void *, std::size_t);
+
+    void Run(std::size_t count, const void *context, Invoke invoke)
+    {
+        const std::lock_guard<std::mutex> serial(callMutex_);
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            context_ = context;
+            invoke_ = invoke;
+            count_ = count;
+            next_.store(0);
+            active_ = threads_.size();
+            ++generation_;
+        }
+        wake_.notify_all();
+        RunTasks(context, invoke, count);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return active_ == 0; });
+            context_ = nullptr;
+            invoke_ = nullptr;
+            error = std::move(error_);
+            error_ = nullptr;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void RunTasks(const void *context, Invoke invoke, std::size_t count)
+    {
+        for (std::size_t index = next_.fetch_add(1); index < count; index = next_.fetch_add(1)) {
+            try {
+                invoke(context, index);
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_) {
+                    error_ = std::current_exception();
+                }
+                next_.store(count);
+            }
+        }
+    }
+
+    void WorkLoop()
+    {
+        std::size_t seen = 0;
+        while (true) {
+            const void *context = nullptr;
+            Invoke invoke = nullptr;
+            std::size_t count = 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) {
+                    return;
+                }
+                seen = generation_;
+                context = context_;
+                invoke = invoke_;
+                count = count_;
+            }
+            RunTasks(context, invoke, count);
+            {
+                const std::lock_guard<std::mutex> lock(mutex_);
+                --active_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread>                   threads_;
+    std::mutex                                 callMutex_;
+    std::mutex                                 mutex_;
+    std::condition_variable                    wake_;
+    std::condition_variable                    done_;
+    const void                                *context_{nullptr};
+    Invoke                                     invoke_{nullptr};
+    std::size_t                                count_{0};
+    std::atomic<std::size_t>                   next_{0};
+    std::size_t                                active_{0};
+    std::size_t                                generation_{0};
+    bool                                       stopping_{false};
+    std::exception_ptr                         error_;
+};
+
+} // namespace rfmodel::engine
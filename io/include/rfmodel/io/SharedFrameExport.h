@@ -0,0 +1,554 @@
+#pragma once
+
+#include "CoverageRaster.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define RFMODEL_HAS_SHARED_FRAMES 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define RFMODEL_HAS_SHARED_FRAMES 0
+#endif
+
+namespace rfmodel::io {
+
+/**
+ * @brief Element type of a shared frame.
+ */
+enum class FrameDataType : std::uint32_t {
+    Float32 = 1,
+    Float64 = 2,
+};
+
+/**
+ * @brief What a shared frame contains.
+ */
+enum class FrameKind : std::uint32_t {
+    /** Coverage raster, rows along +Y and columns along +X, in the units named by the header. */
+    CoverageRaster = 1,
+    /** Link matrix with one row per transmitter and one column per receiver. */
+    LinkMatrix = 2,
+};
+
+inline std::size_t FrameDataTypeSize(FrameDataType type)
+{
+    return type == FrameDataType::Float32 ? sizeof(float) : sizeof(double);
+}
+
+/**
+ * @brief Self-describing header at the start of every shared frame region.
+ *
+ * The layout is fixed (256 bytes, little-endian, natural alignment) so consumers in other
+ * languages can map the region directly. Two frame buffers follow the header at
+ * bufferOffset[0] and bufferOffset[1]; activeBuffer names the one holding the latest
+ * complete frame.
+ *
+ * sequence is a seqlock counter: it is odd while the writer fills the inactive buffer and
+ * even once the buffers have been flipped, so n = sequence / 2 is the number of published
+ * frames. Frames alternate between the buffers, and frame n always lives in buffer n % 2,
+ * so readers derive both the frame number and its buffer from the same sequence load
+ * rather than from activeBuffer. A reader that read frame s1 / 2 and sees s2 afterwards
+ * read a consistent frame iff (s1 & ~1) <= s2 < (s1 | 1) + 2, i.e. the writer has not yet
+ * started refilling the buffer being read. Because of the double buffer, readers never wait
+ * for a writer.
+ *
+ * Units follow docs/UnitsAndConventions.md: coverage rasters are in dBm, link matrices in
+ * dB of path loss, and raster geometry in meters.
+ */
+struct SharedFrameHeader {
+    static constexpr char          kMagic[8] = {'R', 'F', 'M', 'F', 'R', 'A', 'M', 'E'};
+    static constexpr std::uint32_t kVersion = 1;
+
+    char                       magic[8];
+    std::uint32_t              version;
+    std::uint32_t              headerBytes;
+    FrameKind                  kind;
+    FrameDataType              dataType;
+    std::uint64_t              rows;
+    std::uint64_t              columns;
+    std::uint64_t              frameBytes;
+    std::uint64_t              bufferOffset[2];
+    double                     originX;
+    double                     originY;
+    double                     cellSizeMeters;
+    char                       units[16];
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint32_t> activeBuffer;
+    std::uint32_t              reserved0;
+    unsigned char              reserved[136];
+};
+
+static_assert(sizeof(SharedFrameHeader) == 256, "shared frame header layout changed");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared frames require address-free 64-bit atomics");
+
+/**
+ * @brief Shape and metadata of a shared frame region.
+ */
+struct SharedFrameLayout {
+    FrameKind     kind{FrameKind::CoverageRaster};
+    FrameDataType dataType{FrameDataType::Float32};
+    std::size_t   rows{0};
+    std::size_t   columns{0};
+    /** Raster placement; ignored for link matrices. */
+    engine::RasterGeometry geometry;
+    std::string            units{"dBm"};
+
+    /**
+     * @brief Describes a coverage raster of the given geometry and precision.
+     */
+    static SharedFrameLayout Raster(const engine::RasterGeometry &geometry,
+                                    FrameDataType dataType = FrameDataType::Float32)
+    {
+        SharedFrameLayout layout;
+        layout.kind = FrameKind::CoverageRaster;
+        layout.dataType = dataType;
+        layout.rows = geometry.rows;
+        layout.columns = geometry.columns;
+        layout.geometry = geometry;
+        return layout;
+    }
+
+    /**
+     * @brief Describes a transmitter-by-receiver link-loss matrix in dB.
+     */
+    static SharedFrameLayout Links(std::size_t transmitters, std::size_t receivers,
+                                   FrameDataType dataType = FrameDataType::Float32)
+    {
+        SharedFrameLayout layout;
+        layout.kind = FrameKind::LinkMatrix;
+        layout.dataType = dataType;
+        layout.rows = transmitters;
+        layout.columns = receivers;
+        layout.units = "dB";
+        return layout;
+    }
+
+    [[nodiscard]] std::size_t FrameBytes() const
+    {
+        return rows * columns * FrameDataTypeSize(dataType);
+    }
+};
+
+/**
+ * @brief Read-only view of one consistent frame inside a mapped region.
+ */
+struct SharedFrameView {
+    const void   *data{nullptr};
+    std::uint64_t frameNumber{0};
+    std::size_t   rows{0};
+    std::size_t   columns{0};
+    FrameDataType dataType{FrameDataType::Float32};
+
+    /**
+     * @brief Returns one element converted to double.
+     */
+    [[nodiscard]] double At(std::size_t column, std::size_t row) const
+    {
+        const std::size_t index = row * columns + column;
+        return dataType == FrameDataType::Float32
+                   ? static_cast<double>(static_cast<const float *>(data)[index])
+                   : static_cast<const double *>(data)[index];
+    }
+};
+
+namespace detail {
+
+constexpr std::size_t kFrameBufferAlignment = 64;
+
+inline std::size_t AlignFrameOffset(std::size_t offset)
+{
+    return (offset + kFrameBufferAlignment - 1) / kFrameBufferAlignment * kFrameBufferAlignment;
+}
+
+} // namespace detail
+
+/**
+ * @brief Publishes frames into a memory-mapped file for zero-copy consumers.
+ *
+ * The path may name a regular file or a POSIX shared-memory object under /dev/shm. The
+ * region is created on construction and is never truncated, only grown, so readers that
+ * still map it from an earlier writer keep valid pages. A writer reopening a region with the
+ * same layout continues its frame count, and mapped readers carry on seamlessly; with a
+ * different layout the header is reinitialised and those readers' Read() fails until they
+ * reopen. Writers either Publish() a complete buffer or fill BeginFrame() in place and
+ * CommitFrame(). Only one writer may use a region at a time.
+ */
+class SharedFrameWriter {
+public:
+    SharedFrameWriter(const std::string &path, const SharedFrameLayout &layout)
+    {
+#if RFMODEL_HAS_SHARED_FRAMES
+        frameBytes_ = layout.FrameBytes();
+        const std::size_t first = detail::AlignFrameOffset(sizeof(SharedFrameHeader));
+        const std::size_t second = detail::AlignFrameOffset(first + frameBytes_);
+        mappedBytes_ = second + frameBytes_;
+
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            error_ = "cannot create shared frame region '" + path + "'";
+            return;
+        }
+        struct stat status{};
+        if (::fstat(fd, &status) != 0) {
+            ::close(fd);
+            error_ = "cannot inspect shared frame region '" + path + "'";
+            return;
+        }
+        const auto existingBytes = static_cast<std::size_t>(status.st_size);
+        if (existingBytes < mappedBytes_ &&
+            ::ftruncate(fd, static_cast<off_t>(mappedBytes_)) != 0) {
+            ::close(fd);
+            error_ = "cannot size shared frame region '" + path + "'";
+            return;
+        }
+        void *memory = ::mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            error_ = "cannot map shared frame region '" + path + "'";
+            return;
+        }
+        base_ = static_cast<unsigned char *>(memory);
+
+        auto *existing = reinterpret_cast<SharedFrameHeader *>(base_);
+        const bool valid =
+            existingBytes >= sizeof(SharedFrameHeader) &&
+            std::memcmp(existing->magic, SharedFrameHeader::kMagic, sizeof(existing->magic)) == 0 &&
+            existing->version == SharedFrameHeader::kVersion;
+        if (valid && existing->kind == layout.kind && existing->dataType == layout.dataType &&
+            existing->rows == layout.rows && existing->columns == layout.columns &&
+            existing->frameBytes == frameBytes_ && existing->bufferOffset[0] == first &&
+            existing->bufferOffset[1] == second) {
+            // Resume the frame count; a frame the previous writer left half-written is dropped.
+            header_ = existing;
+            const std::uint64_t sequence =
+                header_->sequence.load(std::memory_order_acquire) & ~std::uint64_t{1};
+            header_->activeBuffer.store(static_cast<std::uint32_t>(sequence / 2 % 2),
+                                        std::memory_order_relaxed);
+            header_->sequence.store(sequence, std::memory_order_release);
+        } else {
+            if (valid) {
+                // Stop mapped readers from accepting frames before the layout changes.
+                existing->sequence.store(0, std::memory_order_release);
+            }
+            header_ = new (base_) SharedFrameHeader{};
+            std::memcpy(header_->magic, SharedFrameHeader::kMagic, sizeof(header_->magic));
+            header_->version = SharedFrameHeader::kVersion;
+            header_->headerBytes = sizeof(SharedFrameHeader);
+            header_->kind = layout.kind;
+            header_->dataType = layout.dataType;
+            header_->rows = layout.rows;
+            header_->columns = layout.columns;
+            header_->frameBytes = frameBytes_;
+            header_->bufferOffset[0] = first;
+            header_->bufferOffset[1] = second;
+            header_->sequence.store(0, std::memory_order_release);
+        }
+        header_->originX = layout.geometry.originX;
+        header_->originY = layout.geometry.originY;
+        header_->cellSizeMeters = layout.geometry.cellSizeMeters;
+        std::memset(header_->units, 0, sizeof(header_->units));
+        std::strncpy(header_->units, layout.units.c_str(), sizeof(header_->units) - 1);
+#else
+        static_cast<void>(path);
+        static_cast<void>(layout);
+        error_ = "shared frame export is not supported on this platform";
+#endif
+    }
+
+    SharedFrameWriter(const SharedFrameWriter &) = delete;
+    SharedFrameWriter &operator=(const SharedFrameWriter &) = delete;
+
+    ~SharedFrameWriter()
+    {
+#if RFMODEL_HAS_SHARED_FRAMES
+        if (base_ != nullptr) {
+            ::munmap(base_, mappedBytes_);
+        }
+#endif
+    }
+
+    [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+    [[nodiscard]] const std::string &Error() const { return error_; }
+
+    /**
+     * @brief Returns the number of frames published so far.
+     */
+    [[nodiscard]] std::uint64_t FrameCount() const
+    {
+        return header_ ? header_->sequence.load(std::memory_order_relaxed) / 2 : 0;
+    }
+
+    /**
+     * @brief Starts a frame and returns the inactive buffer for in-place writing.
+     *
+     * Readers keep seeing the previous frame until CommitFrame() is called.
+     */
+    void *BeginFrame()
+    {
+        if (!header_) {
+            return nullptr;
+        }
+        const std::uint64_t sequence = header_->sequence.load(std::memory_order_relaxed);
+        header_->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        const std::uint32_t inactive =
+            1U - header_->activeBuffer.load(std::memory_order_relaxed);
+        return base_ + header_->bufferOffset[inactive];
+    }
+
+    /**
+     * @brief Publishes the frame written since BeginFrame().
+     */
+    void CommitFrame()
+    {
+        if (!header_) {
+            return;
+        }
+        const std::uint32_t inactive =
+            1U - header_->activeBuffer.load(std::memory_order_relaxed);
+        header_->activeBuffer.store(inactive, std::memory_order_release);
+        header_->sequence.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Publishes a complete frame of FrameBytes() bytes.
+     */
+    bool Publish(const void *data, std::size_t bytes)
+    {
+        if (!header_ || bytes != frameBytes_) {
+            return false;
+        }
+        std::memcpy(BeginFrame(), data, bytes);
+        CommitFrame();
+        return true;
+    }
+
+    /**
+     * @brief Publishes a raster or matrix, converting to the region's element type.
+     */
+    template <typename Scalar>
+    bool Publish(const std::vector<Scalar> &values)
+    {
+        static_assert(std::is_floating_point<Scalar>::value, "frames hold floating-point data");
+        if (!header_ || values.size() * FrameDataTypeSize(header_->dataType) != frameBytes_) {
+            return false;
+        }
+        void *buffer = BeginFrame();
+        if (header_->dataType == FrameDataType::Float32) {
+            auto *out = static_cast<float *>(buffer);
+            for (std::size_t index = 0; index < values.size(); ++index) {
+                out[index] = static_cast<float>(values[index]);
+            }
+        } else {
+            auto *out = static_cast<double *>(buffer);
+            for (std::size_t index = 0; index < values.size(); ++index) {
+                out[index] = static_cast<double>(values[index]);
+            }
+        }
+        CommitFrame();
+        return true;
+    }
+
+    template <typename Scalar>
+    bool Publish(const engine::BasicCoverageRaster<Scalar> &raster)
+    {
+        return Publish(raster.Values());
+    }
+
+private:
+    unsigned char     *base_{nullptr};
+    SharedFrameHeader *header_{nullptr};
+    std::size_t        mappedBytes_{0};
+    std::size_t        frameBytes_{0};
+    std::string        error_;
+};
+
+/**
+ * @brief Maps a shared frame region read-only and hands out consistent frames in place.
+ */
+class SharedFrameReader {
+public:
+    explicit SharedFrameReader(const std::string &path)
+    {
+#if RFMODEL_HAS_SHARED_FRAMES
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error_ = "cannot open shared frame region '" + path + "'";
+            return;
+        }
+        struct stat status{};
+        if (::fstat(fd, &status) != 0 ||
+            static_cast<std::size_t>(status.st_size) < sizeof(SharedFrameHeader)) {
+            ::close(fd);
+            error_ = "shared frame region '" + path + "' is too small";
+            return;
+        }
+        mappedBytes_ = static_cast<std::size_t>(status.st_size);
+        void *memory = ::mmap(nullptr, mappedBytes_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            error_ = "cannot map shared frame region '" + path + "'";
+            return;
+        }
+        base_ = static_cast<const unsigned char *>(memory);
+
+        const auto *header = reinterpret_cast<const SharedFrameHeader *>(base_);
+        if (std::memcmp(header->magic, SharedFrameHeader::kMagic, sizeof(header->magic)) != 0 ||
+            header->version != SharedFrameHeader::kVersion) {
+            error_ = "'" + path + "' is not a shared frame region";
+            return;
+        }
+        if (header->bufferOffset[1] + header->frameBytes > mappedBytes_) {
+            error_ = "shared frame region '" + path + "' is truncated";
+            return;
+        }
+        header_ = header;
+        layout_ = CurrentLayout();
+#else
+        static_cast<void>(path);
+        error_ = "shared frame export is not supported on this platform";
+#endif
+    }
+
+    SharedFrameReader(const SharedFrameReader &) = delete;
+    SharedFrameReader &operator=(const SharedFrameReader &) = delete;
+
+    ~SharedFrameReader()
+    {
+#if RFMODEL_HAS_SHARED_FRAMES
+        if (base_ != nullptr) {
+            ::munmap(const_cast<unsigned char *>(base_), mappedBytes_);
+        }
+#endif
+    }
+
+    [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+    [[nodiscard]] const std::string &Error() const { return error_; }
+    [[nodiscard]] const SharedFrameHeader &Header() const { return *header_; }
+
+    /**
+     * @brief Returns the raster placement recorded by the writer.
+     */
+    [[nodiscard]] engine::RasterGeometry Geometry() const
+    {
+        engine::RasterGeometry geometry;
+        geometry.originX = header_->originX;
+        geometry.originY = header_->originY;
+        geometry.cellSizeMeters = header_->cellSizeMeters;
+        geometry.columns = static_cast<std::size_t>(header_->columns);
+        geometry.rows = static_cast<std::size_t>(header_->rows);
+        return geometry;
+    }
+
+    /**
+     * @brief Returns the number of frames published so far.
+     */
+    [[nodiscard]] std::uint64_t FrameCount() const
+    {
+        return header_ ? header_->sequence.load(std::memory_order_acquire) / 2 : 0;
+    }
+
+    /**
+     * @brief Calls visit with the latest complete frame, read in place.
+     *
+     * The view is only valid during the call. If the writer overtook the reader while
+     * visit ran, the visit is repeated on the newer frame, up to maxAttempts times; the
+     * return value is true when the last visit saw a consistent frame. Visitors should
+     * therefore be idempotent (aggregate into fresh state each time). Returns false without
+     * visiting when a restarted writer changed the region's layout; reopen the reader then.
+     */
+    template <typename Visitor>
+    bool Read(Visitor &&visit, std::size_t maxAttempts = 16) const
+    {
+        if (!header_) {
+            return false;
+        }
+        for (std::size_t attempt = 0; attempt < maxAttempts; ++attempt) {
+            const std::uint64_t before = header_->sequence.load(std::memory_order_acquire);
+            if (before < 2 || !(CurrentLayout() == layout_)) {
+                return false;
+            }
+            const std::uint64_t frame = before / 2;
+            SharedFrameView view;
+            view.data = base_ + layout_.bufferOffset[frame % 2];
+            view.frameNumber = frame;
+            view.rows = static_cast<std::size_t>(layout_.rows);
+            view.columns = static_cast<std::size_t>(layout_.columns);
+            view.dataType = layout_.dataType;
+            visit(static_cast<const SharedFrameView &>(view));
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const std::uint64_t after = header_->sequence.load(std::memory_order_relaxed);
+            if (after >= (before & ~std::uint64_t{1}) && after < (before | 1U) + 2) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Copies the latest complete frame as doubles; returns its frame number or 0.
+     */
+    std::uint64_t CopyLatest(std::vector<double> &values) const
+    {
+        std::uint64_t frame = 0;
+        const bool ok = Read([&](const SharedFrameView &view) {
+            values.resize(view.rows * view.columns);
+            for (std::size_t row = 0; row < view.rows; ++row) {
+                for (std::size_t column = 0; column < view.columns; ++column) {
+                    values[row * view.columns + column] = view.At(column, row);
+                }
+            }
+            frame = view.frameNumber;
+        });
+        return ok ? frame : 0;
+    }
+
+private:
+    struct Layout {
+        FrameDataType dataType{FrameDataType::Float32};
+        std::uint64_t rows{0};
+        std::uint64_t columns{0};
+        std::uint64_t frameBytes{0};
+        std::uint64_t bufferOffset[2]{0, 0};
+
+        bool operator==(const Layout &other) const
+        {
+            return dataType == other.dataType && rows == other.rows && columns == other.columns &&
+                   frameBytes == other.frameBytes && bufferOffset[0] == other.bufferOffset[0] &&
+                   bufferOffset[1] == other.bufferOffset[1];
+        }
+    };
+
+    [[nodiscard]] Layout CurrentLayout() const
+    {
+        Layout layout;
+        layout.dataType = header_->dataType;
+        layout.rows = header_->rows;
+        layout.columns = header_->columns;
+        layout.frameBytes = header_->frameBytes;
+        layout.bufferOffset[0] = header_->bufferOffset[0];
+        layout.bufferOffset[1] = header_->bufferOffset[1];
+        return layout;
+    }
+
+    const unsigned char     *base_{nullptr};
+    const SharedFrameHeader *header_{nullptr};
+    Layout                   layout_;
+    std::size_t              mappedBytes_{0};
+    std::string              error_;
+};
+
+} // namespace rfmodel::io
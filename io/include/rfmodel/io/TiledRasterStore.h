@@ -0,0 +1,537 @@
+#pragma once
+
+#include "CoverageKernel.h"
+#include "CoverageRaster.h"
+#include "ScalarPrecision.h"
+#include "TransmitterState.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::io {
+
+/**
+ * @brief Fills a raster with the samples of one tile, at the cell size of the tile's level.
+ *
+ * The raster has to be sized for the given geometry, e.g. by assigning
+ * engine::CoverageRasterf(geometry). Generators may be called from several threads at once
+ * for different tiles.
+ */
+using TileGenerator =
+    std::function<void(const engine::RasterGeometry &, engine::CoverageRasterf &)>;
+
+/**
+ * @brief Generates tiles with the free-space coverage kernel, in dBm.
+ */
+inline TileGenerator MakeCoverageTileGenerator(
+    engine::ScalarPrecision precision,
+    const std::vector<engine::TransmitterState> &transmitters, double receiverHeightMeters = 0.0)
+{
+    return engine::DispatchPrecision(precision, [&](auto tag) -> TileGenerator {
+        using Scalar = typename decltype(tag)::type;
+        auto kernel = std::make_shared<const engine::CoverageKernel<Scalar>>(
+            transmitters, receiverHeightMeters);
+        return [kernel](const engine::RasterGeometry &geometry, engine::CoverageRasterf &tile) {
+            engine::BasicCoverageRaster<Scalar> power;
+            kernel->Evaluate(geometry, power);
+            tile = engine::CoverageRasterf(geometry);
+            std::transform(power.Values().begin(), power.Values().end(),
+                           tile.Values().begin(),
+                           [](Scalar value) { return static_cast<float>(value); });
+        };
+    });
+}
+
+/**
+ * @brief Tuning for TiledRasterStore.
+ */
+struct TiledRasterOptions {
+    /** Tile edge length in cells, rounded up to an even number. */
+    std::size_t tileSize{256};
+    /** Tiles kept in memory across all pyramid levels. */
+    std::size_t maxCachedTiles{64};
+    /** Scratch file for evicted tiles; empty drops them and recomputes on the next miss. */
+    std::string spillPath;
+    /**
+     * Average coarse tiles from the four tiles below instead of generating them at their
+     * own cell size. Smooths detail finer than a coarse cell, but the first access to a
+     * level-k tile then costs up to 4^k generated base tiles.
+     */
+    bool averageCoarseLevels{false};
+};
+
+/**
+ * @brief Cache counters reported by TiledRasterStore.
+ */
+struct TiledRasterStatistics {
+    std::size_t hits{0};
+    std::size_t misses{0};
+    /** Tiles produced by the generator, at any level. */
+    std::size_t generated{0};
+    /** Pyramid tiles averaged from the level below (TiledRasterOptions::averageCoarseLevels). */
+    std::size_t reduced{0};
+    std::size_t evicted{0};
+    std::size_t spilled{0};
+    std::size_t reloaded{0};
+};
+
+/**
+ * @brief Out-of-core coverage raster split into square tiles with a resolution pyramid.
+ *
+ * Level 0 holds the full-resolution raster; every further level halves the resolution
+ * until the whole raster fits in one tile. Tiles are computed on demand by a TileGenerator
+ * at their level's cell size, so every tile costs one generator call and zoomed-out views
+ * never touch the generator at full resolution. With averageCoarseLevels, coarser tiles are
+ * instead averaged from the finite samples of the four tiles below them; the top tile of a
+ * 4096 x 4096 raster in 256-cell tiles then costs 256 generator calls on first access.
+ *
+ * At most maxCachedTiles tiles stay in memory, evicted least recently used first. With a
+ * spill path, evicted tiles are written once to fixed slots of a scratch file (removed when
+ * the store is destroyed) and read back on the next miss instead of being recomputed, so
+ * memory stays bounded no matter how large the site while panning over visited areas stays
+ * cheap. Tiles are returned as shared pointers and stay valid after eviction; memory held
+ * that way counts on top of the bound.
+ *
+ * Samples outside the raster are NaN. The cache is guarded by an internal mutex, but tiles
+ * are generated and averaged outside it, so the heatmap pipeline and the UI may read
+ * different tiles concurrently. A thread asking for a tile that another thread is producing
+ * waits for that tile instead of producing it again.
+ */
+class TiledRasterStore {
+public:
+    using Tile = std::vector<float>;
+
+    TiledRasterStore(const engine::RasterGeometry &geometry, TileGenerator generator,
+                     TiledRasterOptions options = {})
+        : geometry_(geometry), generator_(std::move(generator)), options_(std::move(options))
+    {
+        options_.tileSize = std::max<std::size_t>(2, options_.tileSize + options_.tileSize % 2);
+        options_.maxCachedTiles = std::max<std::size_t>(1, options_.maxCachedTiles);
+        std::size_t columns = std::max<std::size_t>(1, geometry_.columns);
+        std::size_t rows = std::max<std::size_t>(1, geometry_.rows);
+        levels_.push_back({columns, rows});
+        while (columns > options_.tileSize || rows > options_.tileSize) {
+            columns = (columns + 1) / 2;
+            rows = (rows + 1) / 2;
+            levels_.push_back({columns, rows});
+        }
+        if (!options_.spillPath.empty()) {
+            spill_.open(options_.spillPath,
+                        std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+            if (!spill_) {
+                error_ = "cannot create tile spill file '" + options_.spillPath + "'";
+            }
+        }
+    }
+
+    TiledRasterStore(const TiledRasterStore &) = delete;
+    TiledRasterStore &operator=(const TiledRasterStore &) = delete;
+
+    ~TiledRasterStore()
+    {
+        if (spill_.is_open()) {
+            spill_.close();
+            std::remove(options_.spillPath.c_str());
+        }
+    }
+
+    /**
+     * @brief Returns false when the spill file could not be created; see Error().
+     */
+    [[nodiscard]] bool IsOpen() const { return error_.empty(); }
+    [[nodiscard]] const std::string &Error() const { return error_; }
+
+    [[nodiscard]] const engine::RasterGeometry &Geometry() const { return geometry_; }
+    [[nodiscard]] const TiledRasterOptions &Options() const { return options_; }
+    [[nodiscard]] std::size_t LevelCount() const { return levels_.size(); }
+
+    /**
+     * @brief Returns the raster geometry of a pyramid level.
+     */
+    [[nodiscard]] engine::RasterGeometry LevelGeometry(std::size_t level) const
+    {
+        engine::RasterGeometry result = geometry_;
+        result.cellSizeMeters = geometry_.cellSizeMeters * static_cast<double>(1ULL << level);
+        result.columns = levels_[level].columns;
+        result.rows = levels_[level].rows;
+        return result;
+    }
+
+    [[nodiscard]] std::size_t TileColumns(std::size_t level) const
+    {
+        return (levels_[level].columns + options_.tileSize - 1) / options_.tileSize;
+    }
+
+    [[nodiscard]] std::size_t TileRows(std::size_t level) const
+    {
+        return (levels_[level].rows + options_.tileSize - 1) / options_.tileSize;
+    }
+
+    /**
+     * @brief Returns the coarsest level whose cells are no larger than the given size, for
+     *        views showing that many meters per pixel.
+     */
+    [[nodiscard]] std::size_t LevelForCellSize(double metersPerCell) const
+    {
+        std::size_t level = 0;
+        while (level + 1 < levels_.size() &&
+               geometry_.cellSizeMeters * static_cast<double>(2ULL << level) <= metersPerCell) {
+            ++level;
+        }
+        return level;
+    }
+
+    /**
+     * @brief Returns a tile as tileSize x tileSize row-major samples, or nullptr when the
+     *        tile lies outside the level.
+     */
+    [[nodiscard]] std::shared_ptr<const Tile> GetTile(std::size_t level, std::size_t column,
+                                                      std::size_t row)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return Fetch(lock, level, column, row);
+    }
+
+    /**
+     * @brief Returns the sample of one cell of a level, NaN outside the raster.
+     */
+    [[nodiscard]] float Sample(std::size_t level, std::size_t column, std::size_t row)
+    {
+        const std::size_t size = options_.tileSize;
+        std::unique_lock<std::mutex> lock(mutex_);
+        const std::shared_ptr<const Tile> tile = Fetch(lock, level, column / size, row / size);
+        if (!tile) {
+            return std::numeric_limits<float>::quiet_NaN();
+        }
+        return (*tile)[(row % size) * size + column % size];
+    }
+
+    /**
+     * @brief Copies a window of a level into a raster, for example the visible part of a
+     *        pan-and-zoom view. Cells outside the level are NaN.
+     */
+    [[nodiscard]] engine::CoverageRasterf ReadRegion(std::size_t level, std::size_t firstColumn,
+                                                     std::size_t firstRow, std::size_t columns,
+                                                     std::size_t rows)
+    {
+        engine::RasterGeometry window = LevelGeometry(level);
+        window.originX += static_cast<double>(firstColumn) * window.cellSizeMeters;
+        window.originY += static_cast<double>(firstRow) * window.cellSizeMeters;
+        window.columns = columns;
+        window.rows = rows;
+        engine::CoverageRasterf region(window, std::numeric_limits<float>::quiet_NaN());
+        if (columns == 0 || rows == 0) {
+            return region;
+        }
+
+        const std::size_t size = options_.tileSize;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (std::size_t tileRow = firstRow / size; tileRow <= (firstRow + rows - 1) / size;
+             ++tileRow) {
+            for (std::size_t tileColumn = firstColumn / size;
+                 tileColumn <= (firstColumn + columns - 1) / size; ++tileColumn) {
+                const std::shared_ptr<const Tile> tile = Fetch(lock, level, tileColumn, tileRow);
+                if (!tile) {
+                    continue;
+                }
+                const std::size_t rowBegin = std::max(firstRow, tileRow * size);
+                const std::size_t rowEnd = std::min(firstRow + rows, (tileRow + 1) * size);
+                const std::size_t columnBegin = std::max(firstColumn, tileColumn * size);
+                const std::size_t columnEnd =
+                    std::min(firstColumn + columns, (tileColumn + 1) * size);
+                for (std::size_t cellRow = rowBegin; cellRow < rowEnd; ++cellRow) {
+                    const float *source = tile->data() + (cellRow - tileRow * size) * size +
+                                          (columnBegin - tileColumn * size);
+                    std::copy(source, source + (columnEnd - columnBegin),
+                              region.Values().begin() +
+                                  static_cast<std::ptrdiff_t>((cellRow - firstRow) * columns +
+                                                              (columnBegin - firstColumn)));
+                }
+            }
+        }
+        return region;
+    }
+
+    /**
+     * @brief Drops every cached and spilled tile, e.g. after the scene changed.
+     *
+     * Tiles being produced while this runs are returned to their callers but not cached.
+     */
+    void Invalidate()
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        cache_.clear();
+        recency_.clear();
+        slots_.clear();
+        nextSlot_ = 0;
+        ++epoch_;
+    }
+
+    /**
+     * @brief Returns the number of tiles currently held in memory.
+     */
+    [[nodiscard]] std::size_t CachedTiles() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return cache_.size();
+    }
+
+    [[nodiscard]] TiledRasterStatistics Statistics() const
+    {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return statistics_;
+    }
+
+private:
+    struct LevelSize {
+        std::size_t columns;
+        std::size_t rows;
+    };
+
+    struct TileKey {
+        std::size_t level;
+        std::size_t column;
+        std::size_t row;
+
+        bool operator==(const TileKey &other) const
+        {
+            return level == other.level && column == other.column && row == other.row;
+        }
+    };
+
+    struct TileKeyHash {
+        std::size_t operator()(const TileKey &key) const
+        {
+            std::size_t hash = std::hash<std::size_t>{}(key.level);
+            hash = hash * 1000003U ^ std::hash<std::size_t>{}(key.column);
+            return hash * 1000003U ^ std::hash<std::size_t>{}(key.row);
+        }
+    };
+
+    struct CacheEntry {
+        std::shared_ptr<const Tile>  tile;
+        std::list<TileKey>::iterator recency;
+    };
+
+    /**
+     * @brief Returns a cached tile or produces it; lock is released while producing.
+     */
+    std::shared_ptr<const Tile> Fetch(std::unique_lock<std::mutex> &lock, std::size_t level,
+                                      std::size_t column, std::size_t row)
+    {
+        if (level >= levels_.size() || column >= TileColumns(level) || row >= TileRows(level)) {
+            return nullptr;
+        }
+        const TileKey key{level, column, row};
+        while (true) {
+            if (const auto found = cache_.find(key); found != cache_.end()) {
+                ++statistics_.hits;
+                recency_.splice(recency_.begin(), recency_, found->second.recency);
+                return found->second.tile;
+            }
+            if (pending_.find(key) == pending_.end()) {
+                break;
+            }
+            produced_.wait(lock);
+        }
+        ++statistics_.misses;
+
+        std::shared_ptr<const Tile> tile = Reload(key);
+        if (!tile) {
+            pending_.insert(key);
+            const std::size_t epoch = epoch_;
+            try {
+                tile = Produce(lock, key);
+            } catch (...) {
+                pending_.erase(key);
+                produced_.notify_all();
+                throw;
+            }
+            pending_.erase(key);
+            produced_.notify_all();
+            if (epoch != epoch_) {
+                return tile;
+            }
+        }
+        while (cache_.size() >= options_.maxCachedTiles) {
+            Evict();
+        }
+        recency_.push_front(key);
+        cache_.emplace(key, CacheEntry{tile, recency_.begin()});
+        return tile;
+    }
+
+    /**
+     * @brief Generates or averages a tile; entered and left with lock held.
+     */
+    std::shared_ptr<const Tile> Produce(std::unique_lock<std::mutex> &lock, const TileKey &key)
+    {
+        if (key.level == 0 || !options_.averageCoarseLevels) {
+            ++statistics_.generated;
+            lock.unlock();
+            std::shared_ptr<const Tile> tile;
+            try {
+                tile = Generate(key.level, key.column, key.row);
+            } catch (...) {
+                lock.lock();
+                throw;
+            }
+            lock.lock();
+            return tile;
+        }
+        ++statistics_.reduced;
+        std::shared_ptr<const Tile> children[4];
+        for (std::size_t quadrant = 0; quadrant < 4; ++quadrant) {
+            children[quadrant] = Fetch(lock, key.level - 1, 2 * key.column + quadrant % 2,
+                                       2 * key.row + quadrant / 2);
+        }
+        lock.unlock();
+        std::shared_ptr<const Tile> tile = Reduce(children);
+        lock.lock();
+        return tile;
+    }
+
+    std::shared_ptr<const Tile> Generate(std::size_t level, std::size_t column,
+                                         std::size_t row) const
+    {
+        const std::size_t size = options_.tileSize;
+        const engine::RasterGeometry levelGeometry = LevelGeometry(level);
+        engine::RasterGeometry tileGeometry = levelGeometry;
+        tileGeometry.originX += static_cast<double>(column * size) * levelGeometry.cellSizeMeters;
+        tileGeometry.originY += static_cast<double>(row * size) * levelGeometry.cellSizeMeters;
+        tileGeometry.columns = std::min(size, levelGeometry.columns - column * size);
+        tileGeometry.rows = std::min(size, levelGeometry.rows - row * size);
+
+        engine::CoverageRasterf samples(tileGeometry);
+        if (generator_) {
+            generator_(tileGeometry, samples);
+        }
+        auto tile = std::make_shared<Tile>(size * size, std::numeric_limits<float>::quiet_NaN());
+        if (samples.Values().size() == tileGeometry.CellCount()) {
+            for (std::size_t cellRow = 0; cellRow < tileGeometry.rows; ++cellRow) {
+                const auto source = samples.Values().begin() +
+                                    static_cast<std::ptrdiff_t>(cellRow * tileGeometry.columns);
+                std::copy(source, source + static_cast<std::ptrdiff_t>(tileGeometry.columns),
+                          tile->begin() + static_cast<std::ptrdiff_t>(cellRow * size));
+            }
+        }
+        return tile;
+    }
+
+    /**
+     * @brief Averages four child tiles, ordered row-major, into one tile of the level above.
+     */
+    std::shared_ptr<const Tile> Reduce(const std::shared_ptr<const Tile> (&children)[4]) const
+    {
+        const std::size_t size = options_.tileSize;
+        const std::size_t half = size / 2;
+        auto tile = std::make_shared<Tile>(size * size, std::numeric_limits<float>::quiet_NaN());
+        for (std::size_t quadrant = 0; quadrant < 4; ++quadrant) {
+            const std::size_t dx = quadrant % 2;
+            const std::size_t dy = quadrant / 2;
+            const std::shared_ptr<const Tile> &child = children[quadrant];
+            if (!child) {
+                continue;
+            }
+            for (std::size_t cellRow = 0; cellRow < half; ++cellRow) {
+                for (std::size_t cellColumn = 0; cellColumn < half; ++cellColumn) {
+                    float sum = 0.0F;
+                    int count = 0;
+                    for (std::size_t k = 0; k < 4; ++k) {
+                        const float value =
+                            (*child)[(2 * cellRow + k / 2) * size + 2 * cellColumn + k % 2];
+                        if (std::isfinite(value)) {
+                            sum += value;
+                            ++count;
+                        }
+                    }
+                    if (count > 0) {
+                        (*tile)[(dy * half + cellRow) * size + dx * half + cellColumn] =
+                            sum / static_cast<float>(count);
+                    }
+                }
+            }
+        }
+        return tile;
+    }
+
+    void Evict()
+    {
+        const TileKey key = recency_.back();
+        recency_.pop_back();
+        const auto found = cache_.find(key);
+        ++statistics_.evicted;
+        if (spill_.is_open() && error_.empty() && slots_.find(key) == slots_.end()) {
+            const std::size_t slot = nextSlot_++;
+            spill_.seekp(static_cast<std::streamoff>(slot * TileBytes()));
+            spill_.write(reinterpret_cast<const char *>(found->second.tile->data()),
+                         static_cast<std::streamsize>(TileBytes()));
+            if (spill_) {
+                slots_.emplace(key, slot);
+                ++statistics_.spilled;
+            } else {
+                spill_.clear();
+            }
+        }
+        cache_.erase(found);
+    }
+
+    std::shared_ptr<const Tile> Reload(const TileKey &key)
+    {
+        const auto slot = slots_.find(key);
+        if (slot == slots_.end()) {
+            return nullptr;
+        }
+        auto tile = std::make_shared<Tile>(options_.tileSize * options_.tileSize);
+        spill_.seekg(static_cast<std::streamoff>(slot->second * TileBytes()));
+        spill_.read(reinterpret_cast<char *>(tile->data()),
+                    static_cast<std::streamsize>(TileBytes()));
+        if (!spill_) {
+            spill_.clear();
+            slots_.erase(slot);
+            return nullptr;
+        }
+        ++statistics_.reloaded;
+        return tile;
+    }
+
+    [[nodiscard]] std::size_t TileBytes() const
+    {
+        return options_.tileSize * options_.tileSize * sizeof(float);
+    }
+
+    engine::RasterGeometry                                  geometry_;
+    TileGenerator                                           generator_;
+    TiledRasterOptions                                      options_;
+    std::vector<LevelSize>                                  levels_;
+    mutable std::mutex                                      mutex_;
+    std::condition_variable                                 produced_;
+    /** Tiles some thread is generating or averaging outside the lock. */
+    std::unordered_set<TileKey, TileKeyHash>                pending_;
+    /** Bumped by Invalidate() so tiles started before it are not cached. */
+    std::size_t                                             epoch_{0};
+    std::unordered_map<TileKey, CacheEntry, TileKeyHash>    cache_;
+    std::list<TileKey>                                      recency_;
+    std::unordered_map<TileKey, std::size_t, TileKeyHash>   slots_;
+    std::size_t                                             nextSlot_{0};
+    std::fstream                                            spill_;
+    std::string                                             error_;
+    TiledRasterStatistics                                   statistics_;
+};
+
+} // namespace rfmodel::io
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "PotentiallyVisibleSet.h"
+#include "WallGeometry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::io {
+
+/**
+ * @brief Fixed header of a persisted visibility set file.
+ *
+ * On disk the header takes kVisibilitySetHeaderBytes: the magic followed by each field in
+ * declaration order as a little-endian integer of its size, without padding. The cell
+ * bitsets follow as cellCount x wordsPerSet little-endian 64-bit words, bit w of a cell's set
+ * marking wall w as potentially visible. Files are therefore portable between hosts of
+ * either byte order.
+ */
+struct VisibilitySetHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t transmissionDepth;
+    std::uint64_t fingerprint;
+    std::uint64_t cellCount;
+    std::uint64_t wallCount;
+    std::uint64_t wordsPerSet;
+};
+
+inline constexpr char kVisibilitySetMagic[8] = {'R', 'F', 'M', 'P', 'V', 'S', '\0', '\0'};
+inline constexpr std::uint32_t kVisibilitySetVersion = 1;
+inline constexpr std::size_t kVisibilitySetHeaderBytes = 48;
+
+namespace detail {
+
+inline void StoreLittleEndian(unsigned char *bytes, std::uint64_t value, std::size_t size)
+{
+    for (std::size_t byte = 0; byte < size; ++byte) {
+        bytes[byte] = static_cast<unsigned char>(value >> (8U * byte));
+    }
+}
+
+inline std::uint64_t LoadLittleEndian(const unsigned char *bytes, std::size_t size)
+{
+    std::uint64_t value = 0;
+    for (std::size_t byte = 0; byte < size; ++byte) {
+        value |= static_cast<std::uint64_t>(bytes[byte]) << (8U * byte);
+    }
+    return value;
+}
+
+} // namespace detail
+
+/**
+ * @brief Writes visibility sets next to a scene so later loads can skip the build.
+ *
+ * Returns false and fills error when the file cannot be written.
+ */
+inline bool WriteVisibilitySet(const std::string &path,
+                               const engine::PotentiallyVisibleSet &visibility,
+                               std::string *error = nullptr)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        if (error != nullptr) {
+            *error = "cannot create visibility set file '" + path + "'";
+        }
+        return false;
+    }
+    VisibilitySetHeader header{};
+    std::memcpy(header.magic, kVisibilitySetMagic, sizeof(header.magic));
+    header.version = kVisibilitySetVersion;
+    header.transmissionDepth = static_cast<std::uint32_t>(visibility.TransmissionDepth());
+    header.fingerprint = visibility.Fingerprint();
+    header.cellCount = visibility.CellCount();
+    header.wallCount = visibility.WallCount();
+    header.wordsPerSet = visibility.WordsPerSet();
+
+    unsigned char encoded[kVisibilitySetHeaderBytes];
+    std::memcpy(encoded, header.magic, sizeof(header.magic));
+    detail::StoreLittleEndian(encoded + 8, header.version, 4);
+    detail::StoreLittleEndian(encoded + 12, header.transmissionDepth, 4);
+    detail::StoreLittleEndian(encoded + 16, header.fingerprint, 8);
+    detail::StoreLittleEndian(encoded + 24, header.cellCount, 8);
+    detail::StoreLittleEndian(encoded + 32, header.wallCount, 8);
+    detail::StoreLittleEndian(encoded + 40, header.wordsPerSet, 8);
+    stream.write(reinterpret_cast<const char *>(encoded), sizeof(encoded));
+
+    const std::vector<std::uint64_t> &bits = visibility.CellBits();
+    std::vector<unsigned char> words(bits.size() * 8);
+    for (std::size_t word = 0; word < bits.size(); ++word) {
+        detail::StoreLittleEndian(words.data() + 8 * word, bits[word], 8);
+    }
+    stream.write(reinterpret_cast<const char *>(words.data()),
+                 static_cast<std::streamsize>(words.size()));
+    if (!stream) {
+        if (error != nullptr) {
+            *error = "cannot write visibility set file '" + path + "'";
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Loads visibility sets for the given wall grid.
+ *
+ * Returns nullopt and fills error when the file is missing, malformed, or was built for a
+ * different floorplan or grid; callers then rebuild with PotentiallyVisibleSet::Build().
+ */
+inline std::optional<engine::PotentiallyVisibleSet> ReadVisibilitySet(
+    const std::string &path, const engine::WallIndex &index, std::string *error = nullptr)
+{
+    const auto fail = [error](const std::string &message) {
+        if (error != nullptr) {
+            *error = message;
+        }
+        return std::nullopt;
+    };
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) {
+        return fail("cannot open visibility set file '" + path + "'");
+    }
+    unsigned char encoded[kVisibilitySetHeaderBytes];
+    stream.read(reinterpret_cast<char *>(encoded), sizeof(encoded));
+    VisibilitySetHeader header{};
+    std::memcpy(header.magic, encoded, sizeof(header.magic));
+    header.version = static_cast<std::uint32_t>(detail::LoadLittleEndian(encoded + 8, 4));
+    header.transmissionDepth =
+        static_cast<std::uint32_t>(detail::LoadLittleEndian(encoded + 12, 4));
+    header.fingerprint = detail::LoadLittleEndian(encoded + 16, 8);
+    header.cellCount = detail::LoadLittleEndian(encoded + 24, 8);
+    header.wallCount = detail::LoadLittleEndian(encoded + 32, 8);
+    header.wordsPerSet = detail::LoadLittleEndian(encoded + 40, 8);
+    if (!stream || std::memcmp(header.magic, kVisibilitySetMagic, sizeof(header.magic)) != 0 ||
+        header.version != kVisibilitySetVersion) {
+        return fail("'" + path + "' is not a visibility set file");
+    }
+    if (header.fingerprint != engine::WallIndexFingerprint(index) ||
+        header.cellCount != index.CellCount() || header.wallCount != index.WallCount() ||
+        header.wordsPerSet != (index.WallCount() + 63) / 64) {
+        return fail("visibility set file '" + path + "' was built for a different floorplan");
+    }
+    std::vector<unsigned char> words(header.cellCount * header.wordsPerSet * 8);
+    stream.read(reinterpret_cast<char *>(words.data()),
+                static_cast<std::streamsize>(words.size()));
+    if (!stream) {
+        return fail("visibility set file '" + path + "' is truncated");
+    }
+    std::vector<std::uint64_t> bits(header.cellCount * header.wordsPerSet);
+    for (std::size_t word = 0; word < bits.size(); ++word) {
+        bits[word] = detail::LoadLittleEndian(words.data() + 8 * word, 8);
+    }
+    return engine::PotentiallyVisibleSet(index, header.transmissionDepth, std::move(bits));
+}
+
+} // namespace rfmodel::io
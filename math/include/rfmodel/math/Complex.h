@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <ostream>
@@ -117,6 +118,18 @@ inline Complex operator*(double scalar, const Complex& value) {
     return value * scalar;
 }
 
+// Principal square root, with the branch cut along the negative real axis.
+inline Complex sqrt(const Complex& value) {
+    double mag = value.magnitude();
+    double root_real = std::sqrt(0.5 * (mag + value.real));
+    double root_imag = std::sqrt(0.5 * std::max(mag - value.real, 0.0));
+    return Complex{root_real, std::signbit(value.imag) ? -root_imag : root_imag};
+}
+
+inline Complex exp(const Complex& value) {
+    return Complex::fromPolar(std::exp(value.real), value.imag);
+}
+
 inline std::ostream& operator<<(std::ostream& os, const Complex& value) {
     return os << '(' << value.real << ", " << value.imag << ')';
 }
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cmath>
+
+namespace rfmodel::math {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kTwoPi = 2.0 * kPi;
+constexpr double kHalfPi = 0.5 * kPi;
+
+// Speed of light in vacuum, meters per second.
+constexpr double kSpeedOfLight = 299792458.0;
+
+// Normalizes an angle to [-pi, pi) as required by docs/UnitsAndConventions.md.
+inline double wrapPhase(double phase_radians) {
+    double wrapped = std::remainder(phase_radians, kTwoPi);
+    if (wrapped >= kPi) {
+        wrapped -= kTwoPi;
+    }
+    return wrapped;
+}
+
+}  // namespace rfmodel::math
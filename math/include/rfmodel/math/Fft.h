@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Complex.h"
+#include "Constants.h"
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace rfmodel::math {
+
+inline bool isPowerOfTwo(std::size_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+inline std::size_t nextPowerOfTwo(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Precomputed in-place radix-2 FFT of a fixed power-of-two size. forward() uses the
+// e^{-j 2 pi k n / N} kernel; inverse() includes the 1 / N scaling. A plan is immutable
+// after construction and may be shared between threads.
+class FftPlan {
+public:
+    FftPlan() = default;
+
+    explicit FftPlan(std::size_t size) : size_(nextPowerOfTwo(size)) {
+        reversed_.resize(size_);
+        std::size_t bits = 0;
+        while ((std::size_t{1} << bits) < size_) {
+            ++bits;
+        }
+        for (std::size_t index = 0; index < size_; ++index) {
+            std::size_t reversed = 0;
+            for (std::size_t bit = 0; bit < bits; ++bit) {
+                reversed |= ((index >> bit) & 1U) << (bits - 1 - bit);
+            }
+            reversed_[index] = reversed;
+        }
+        // Twiddles are stored per stage, contiguously, so each butterfly pass reads them in order.
+        twiddles_.reserve(size_ > 0 ? size_ - 1 : 0);
+        for (std::size_t length = 2; length <= size_; length <<= 1) {
+            for (std::size_t offset = 0; offset < length / 2; ++offset) {
+                twiddles_.push_back(Complex::fromPolar(
+                    1.0, -kTwoPi * static_cast<double>(offset) / static_cast<double>(length)));
+            }
+        }
+        inverseTwiddles_.reserve(twiddles_.size());
+        for (const Complex& twiddle : twiddles_) {
+            inverseTwiddles_.push_back(twiddle.conjugate());
+        }
+    }
+
+    std::size_t size() const { return size_; }
+
+    void forward(Complex* data) const { transform(data, false); }
+
+    void inverse(Complex* data) const {
+        transform(data, true);
+        const double scale = 1.0 / static_cast<double>(size_);
+        for (std::size_t index = 0; index < size_; ++index) {
+            data[index] *= scale;
+        }
+    }
+
+private:
+    void transform(Complex* data, bool inverse) const {
+        for (std::size_t index = 0; index < size_; ++index) {
+            if (index < reversed_[index]) {
+                std::swap(data[index], data[reversed_[index]]);
+            }
+        }
+        const Complex* stage = inverse ? inverseTwiddles_.data() : twiddles_.data();
+        for (std::size_t half = 1; half < size_; half <<= 1) {
+            for (std::size_t start = 0; start < size_; start += 2 * half) {
+                Complex* even = data + start;
+                Complex* odd = even + half;
+                for (std::size_t offset = 0; offset < half; ++offset) {
+                    const Complex product = odd[offset] * stage[offset];
+                    odd[offset] = even[offset] - product;
+                    even[offset] += product;
+                }
+            }
+            stage += half;
+        }
+    }
+
+    std::size_t size_{0};
+    std::vector<std::size_t> reversed_;
+    std::vector<Complex> twiddles_;
+    std::vector<Complex> inverseTwiddles_;
+};
+
+}  // namespace rfmodel::math
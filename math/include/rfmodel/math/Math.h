@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Complex.h"
+#include "Constants.h"
 #include "Decibel.h"
 #include "Vec2.h"
 #include "Vec3.h"
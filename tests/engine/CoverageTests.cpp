@@ -0,0 +1,282 @@
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+
+#include "AdaptiveCoverageSampler.h"
+#include "CoverageKernel.h"
+#include "CoverageRaster.h"
+#include "InterferenceField.h"
+#include "QuantizedRaster.h"
+#include "ScalarPrecision.h"
+#include "TransmitterState.h"
+
+#include <random>
+#include <vector>
+
+namespace {
+
+using rfmodel::engine::AdaptiveCoverageOptions;
+using rfmodel::engine::AdaptiveCoverageSampler;
+using rfmodel::engine::CoverageKernel;
+using rfmodel::engine::CoverageRaster;
+using rfmodel::engine::CoverageSample;
+using rfmodel::engine::DecibelQuantizer;
+using rfmodel::engine::InterferenceField;
+using rfmodel::engine::InterferenceOptions;
+using rfmodel::engine::InterferenceSample;
+using rfmodel::engine::QuantizedCoverageRaster;
+using rfmodel::engine::RasterGeometry;
+using rfmodel::engine::ScalarPrecision;
+using rfmodel::engine::TransmitterState;
+
+// Free-space-like falloff with a 20 dB shadow behind a wall at x = 60 m.
+CoverageSample shadowedField(double x, double y) {
+    const double dx = x - 10.0;
+    const double dy = y - 50.0;
+    const double distance = std::sqrt(dx * dx + dy * dy) + 1.0;
+    double power = -30.0 - 20.0 * std::log10(distance);
+    if (x > 60.0) {
+        power -= 20.0;
+    }
+    return CoverageSample{power, 0.0};
+}
+
+void testAdaptiveSamplingMatchesDirectEvaluation() {
+    RasterGeometry geometry;
+    geometry.cellSizeMeters = 0.5;
+    geometry.columns = 200;
+    geometry.rows = 200;
+
+    AdaptiveCoverageOptions options;
+    options.baseCellSizeMeters = 8.0;
+    options.maxDepth = 4;
+    options.powerToleranceDb = 0.5;
+    const AdaptiveCoverageSampler sampler(options);
+
+    const auto result = sampler.Sample(geometry, shadowedField);
+    assert(result.evaluations > 0);
+    assert(result.evaluations * 5 < result.uniformEvaluations);
+
+    double totalError = 0.0;
+    for (std::size_t row = 0; row < geometry.rows; ++row) {
+        for (std::size_t column = 0; column < geometry.columns; ++column) {
+            const double x = geometry.CellCenterX(column);
+            const double y = geometry.CellCenterY(row);
+            const double error = std::abs(result.powerDbm.At(column, row) - shadowedField(x, y).powerDbm);
+            // Only the cells straddling the shadow edge may blend both sides.
+            if (std::abs(x - 60.0) > 0.5) {
+                assert(error < 1.0);
+            }
+            totalError += error;
+        }
+    }
+    assert(totalError / static_cast<double>(geometry.CellCount()) < 0.2);
+}
+
+void testUniformFieldUsesBaseCellsOnly() {
+    RasterGeometry geometry;
+    geometry.cellSizeMeters = 1.0;
+    geometry.columns = 16;
+    geometry.rows = 8;
+
+    AdaptiveCoverageOptions options;
+    options.baseCellSizeMeters = 4.0;
+    const AdaptiveCoverageSampler sampler(options);
+
+    const auto result = sampler.Sample(
+        geometry, [](double, double) { return CoverageSample{-50.0, 1.0}; });
+    assert(result.leafCells == 8);
+    // Corners of the 4x2 base grid plus one center per base cell.
+    assert(result.evaluations == 5 * 3 + 8);
+    assert(std::abs(result.powerDbm.At(3, 5) + 50.0) < 1e-12);
+    assert(std::abs(result.phaseRadians.At(3, 5) - 1.0) < 1e-12);
+}
+
+void testCarrierPhaseDoesNotForceRefinement() {
+    std::vector<TransmitterState> transmitters(1);
+    transmitters[0].positionMeters = {50.0, 50.0, 2.5};
+    transmitters[0].carrierFrequencyHz = 2.4e9;
+
+    RasterGeometry geometry;
+    geometry.cellSizeMeters = 0.5;
+    geometry.columns = 200;
+    geometry.rows = 200;
+
+    // The carrier phase of this field wraps every 12.5 cm, far below the cell size.
+    const auto field =
+        rfmodel::engine::MakeCoverageEvaluator(ScalarPrecision::Double, transmitters);
+    const AdaptiveCoverageSampler sampler;
+    const auto result = sampler.Sample(geometry, field);
+    assert(result.uniformEvaluations == geometry.CellCount());
+    assert(result.evaluations * 4 < result.uniformEvaluations);
+
+    double totalError = 0.0;
+    for (std::size_t row = 0; row < geometry.rows; ++row) {
+        for (std::size_t column = 0; column < geometry.columns; ++column) {
+            const double expected =
+                field(geometry.CellCenterX(column), geometry.CellCenterY(row)).powerDbm;
+            totalError += std::abs(result.powerDbm.At(column, row) - expected);
+        }
+    }
+    assert(totalError / static_cast<double>(geometry.CellCount()) < 0.2);
+}
+
+void testFreeSpaceKernelMatchesFriis() {
+    TransmitterState transmitter;
+    transmitter.positionMeters = {0.0, 0.0, 0.0};
+    transmitter.carrierFrequencyHz = 2.4e9;
+    transmitter.powerDbm = 30.0;
+
+    const CoverageKernel<double> kernel({transmitter});
+    const double distance = 100.0;
+    const double wavelength = transmitter.WavelengthMeters();
+    const double expected =
+        30.0 + 20.0 * std::log10(wavelength / (4.0 * rfmodel::math::kPi * distance));
+    assert(std::abs(kernel.EvaluatePoint(distance, 0.0).powerDbm - expected) < 1e-9);
+}
+
+void testSinglePrecisionTracksDoublePrecision() {
+    std::vector<TransmitterState> transmitters(3);
+    transmitters[0].positionMeters = {5.0, 5.0, 2.0};
+    transmitters[1].positionMeters = {40.0, 10.0, 2.0};
+    transmitters[1].carrierFrequencyHz = 5.8e9;
+    transmitters[2].positionMeters = {20.0, 45.0, 2.0};
+    transmitters[2].powerDbm = 20.0;
+
+    RasterGeometry geometry;
+    geometry.cellSizeMeters = 0.25;
+    geometry.columns = 200;
+    geometry.rows = 200;
+
+    using rfmodel::engine::EvaluateCoveragePowerDbm;
+    const auto single = EvaluateCoveragePowerDbm(ScalarPrecision::Single, transmitters, geometry);
+    const auto reference = EvaluateCoveragePowerDbm(ScalarPrecision::Double, transmitters, geometry);
+
+    double totalError = 0.0;
+    for (std::size_t index = 0; index < geometry.CellCount(); ++index) {
+        totalError += std::abs(single.Values()[index] - reference.Values()[index]);
+    }
+    assert(totalError / static_cast<double>(geometry.CellCount()) < 0.01);
+
+    const auto evaluator =
+        rfmodel::engine::MakeCoverageEvaluator(ScalarPrecision::Single, transmitters);
+    const double probe = evaluator(geometry.CellCenterX(17), geometry.CellCenterY(90)).powerDbm;
+    assert(std::abs(probe - single.At(17, 90)) < 1e-4);
+
+    assert(rfmodel::engine::ParseScalarPrecision("single") == ScalarPrecision::Single);
+    assert(!rfmodel::engine::ParseScalarPrecision("half").has_value());
+}
+
+// A few thousand IoT emitters scattered over 500 m x 500 m with mixed power and bands.
+std::vector<TransmitterState> makeDeployment(std::size_t count) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> position(0.0, 500.0);
+    std::uniform_real_distribution<double> power(0.0, 20.0);
+    std::vector<TransmitterState> transmitters(count);
+    for (std::size_t index = 0; index < count; ++index) {
+        transmitters[index].positionMeters = {position(generator), position(generator), 3.0};
+        transmitters[index].powerDbm = power(generator);
+        transmitters[index].carrierFrequencyHz = index % 3 == 0 ? 868e6 : 2.4e9;
+    }
+    return transmitters;
+}
+
+void testAggregatedInterferenceStaysWithinBound() {
+    const std::vector<TransmitterState> transmitters = makeDeployment(3000);
+    const InterferenceField field(transmitters, 1.5);
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> position(-50.0, 550.0);
+    for (int probe = 0; probe < 20; ++probe) {
+        const double x = position(generator);
+        const double y = position(generator);
+        double exact = 0.0;
+        for (std::size_t index = 0; index < transmitters.size(); ++index) {
+            exact += field.ExactPower(index, x, y);
+        }
+        const InterferenceSample sample = field.Evaluate(x, y);
+        assert(std::abs(sample.powerMilliwatts - exact) <=
+               sample.errorBoundMilliwatts + 1e-12 * exact);
+        assert(std::abs(sample.PowerDbm() - 10.0 * std::log10(exact)) < 0.25);
+        assert(InterferenceField::RelativeErrorDb(sample) < 1.0);
+        assert(sample.clusters > 0);
+        assert(sample.exactTransmitters + sample.clusters < transmitters.size() / 10);
+    }
+
+    // A zero opening angle sums every transmitter exactly.
+    const InterferenceField exactField(transmitters, 1.5, InterferenceOptions{0.0, 8});
+    const InterferenceSample exact = exactField.Evaluate(250.0, 250.0);
+    assert(exact.clusters == 0 && exact.errorBoundMilliwatts == 0.0);
+    assert(exact.exactTransmitters == transmitters.size());
+}
+
+void testStrongestServerMatchesExhaustiveSearch() {
+    const std::vector<TransmitterState> transmitters = makeDeployment(500);
+    const InterferenceField field(transmitters, 1.5);
+    for (const double x : {12.0, 130.0, 260.0, 499.0}) {
+        for (const double y : {3.0, 250.0, 480.0}) {
+            std::size_t best = 0;
+            for (std::size_t index = 1; index < transmitters.size(); ++index) {
+                if (field.ExactPower(index, x, y) > field.ExactPower(best, x, y)) {
+                    best = index;
+                }
+            }
+            const auto [server, power] = field.Strongest(x, y);
+            assert(server == best);
+            assert(power == field.ExactPower(best, x, y));
+        }
+    }
+
+    RasterGeometry geometry;
+    geometry.cellSizeMeters = 25.0;
+    geometry.columns = 20;
+    geometry.rows = 20;
+    rfmodel::engine::CoverageRaster sinr;
+    field.EvaluateSinrDb(geometry, -100.0, sinr);
+    for (const double value : sinr.Values()) {
+        assert(std::isfinite(value) && value < 60.0);
+    }
+}
+
+void testQuantizedRasterKeepsHundredthDecibel() {
+    TransmitterState transmitter;
+    transmitter.positionMeters = {12.0, 7.0, 3.0};
+    transmitter.powerDbm = 23.0;
+    RasterGeometry geometry;
+    geometry.cellSizeMeters = 0.25;
+    geometry.columns = 120;
+    geometry.rows = 80;
+    CoverageRaster power = rfmodel::engine::EvaluateCoveragePowerDbm(
+        ScalarPrecision::Double, {transmitter}, geometry, 1.5);
+    power.Set(0, 0, std::nan(""));
+    power.Set(1, 0, -1000.0);
+
+    const QuantizedCoverageRaster quantized = QuantizedCoverageRaster::FromRaster(power);
+    assert(quantized.MemoryBytes() * 4 == power.Values().size() * sizeof(double));
+    assert(std::isnan(quantized.At(0, 0)));
+    assert(quantized.At(1, 0) == quantized.Quantizer().minimumDb);
+    power.Set(1, 0, quantized.Quantizer().minimumDb);
+    assert(rfmodel::engine::MaxQuantizationErrorDb(power, quantized) <=
+           quantized.Quantizer().ResolutionDb() + 1e-9);
+
+    const auto decoded = quantized.ToRaster<float>();
+    assert(std::abs(decoded.At(60, 40) - power.At(60, 40)) < 0.006);
+
+    const DecibelQuantizer quantizer;
+    assert(quantizer.Encode(quantizer.MaximumDb() + 5.0) == DecibelQuantizer::kNoData - 1);
+    assert(quantizer.Encode(-87.654) == 21235);
+    assert(std::abs(quantizer.Decode(quantizer.Encode(-87.654)) + 87.654) <= 0.005);
+}
+
+}  // namespace
+
+int main() {
+    testAdaptiveSamplingMatchesDirectEvaluation();
+    testUniformFieldUsesBaseCellsOnly();
+    testCarrierPhaseDoesNotForceRefinement();
+    testFreeSpaceKernelMatchesFriis();
+    testSinglePrecisionTracksDoublePrecision();
+    testAggregatedInterferenceStaysWithinBound();
+    testStrongestServerMatchesExhaustiveSearch();
+    testQuantizedRasterKeepsHundredthDecibel();
+    return 0;
+}
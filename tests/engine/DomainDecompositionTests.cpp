@@ -0,0 +1,261 @@
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "DomainDecomposition.h"
+#include "IReceiver.h"
+#include "ISimulationObject.h"
+#include "ImageMethodSolver.h"
+#include "MaterialCoefficientCache.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "WallGeometry.h"
+#include "WorkerPool.h"
+
+namespace {
+
+using rfmodel::engine::DomainDecomposition;
+using rfmodel::engine::DomainDecompositionOptions;
+using rfmodel::engine::ImageMethodSolver;
+using rfmodel::engine::MakeWallSegment;
+using rfmodel::engine::MaterialCoefficientCache;
+using rfmodel::engine::PathEvaluator;
+using rfmodel::engine::PropagationEnvironment;
+using rfmodel::engine::PropagationPath;
+using rfmodel::engine::PropagationSettings;
+using rfmodel::engine::WallHit;
+using rfmodel::engine::WallIndex;
+using rfmodel::engine::WallMaterial;
+using rfmodel::engine::WorkerPool;
+using rfmodel::math::Vec2d;
+using rfmodel::math::Vec3d;
+
+const WallMaterial kDrywall{2.73, 0.0085 * std::pow(2.4, 0.9395), 0.1};
+
+// A grid of 6 m x 5 m rooms, each with a 1 m door gap in its south and west walls.
+PropagationEnvironment makeCampus(int columns, int rows) {
+    PropagationEnvironment environment;
+    const auto add = [&](double x0, double y0, double x1, double y1) {
+        environment.AddWall(MakeWallSegment(Vec2d{x0, y0}, Vec2d{x1, y1}), kDrywall);
+    };
+    for (int row = 0; row <= rows; ++row) {
+        for (int column = 0; column < columns; ++column) {
+            const double x = 6.0 * column;
+            const double y = 5.0 * row;
+            add(x, y, x + 2.5, y);
+            add(x + 3.5, y, x + 6.0, y);
+        }
+    }
+    for (int column = 0; column <= columns; ++column) {
+        for (int row = 0; row < rows; ++row) {
+            const double x = 6.0 * column;
+            const double y = 5.0 * row;
+            add(x, y, x, y + 2.0);
+            add(x, y + 3.0, x, y + 5.0);
+        }
+    }
+    return environment;
+}
+
+bool sameHit(const WallHit &lhs, const WallHit &rhs) {
+    return lhs.wallIndex == rhs.wallIndex && lhs.t == rhs.t && lhs.u == rhs.u;
+}
+
+bool samePath(const PropagationPath &lhs, const PropagationPath &rhs) {
+    if (lhs.lengthMeters != rhs.lengthMeters || lhs.gain.real != rhs.gain.real ||
+        lhs.gain.imag != rhs.gain.imag || lhs.vertices.size() != rhs.vertices.size() ||
+        lhs.interactions.size() != rhs.interactions.size()) {
+        return false;
+    }
+    for (std::size_t k = 0; k < lhs.interactions.size(); ++k) {
+        if (lhs.interactions[k].type != rhs.interactions[k].type ||
+            lhs.interactions[k].wallIndex != rhs.interactions[k].wallIndex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testQueriesMatchMonolithicIndex() {
+    const PropagationEnvironment environment = makeCampus(12, 8);
+    const WallIndex whole(environment.walls);
+    WorkerPool pool(3);
+    DomainDecompositionOptions options;
+    options.regions = 7;
+    const DomainDecomposition domains(environment.walls, pool, options);
+    assert(domains.RegionCount() == 7);
+    for (std::size_t region = 0; region < domains.RegionCount(); ++region) {
+        assert(domains.RegionWallCount(region) < environment.walls.size() / 3);
+    }
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<double> x(-5.0, 77.0);
+    std::uniform_real_distribution<double> y(-5.0, 45.0);
+    for (int query = 0; query < 3000; ++query) {
+        const Vec2d a{x(random), y(random)};
+        // Include axis-aligned segments along the walls and through door gaps.
+        const Vec2d b = query % 5 == 0 ? Vec2d{a.x, y(random)} : Vec2d{x(random), y(random)};
+        const std::size_t ignore = query % 3 == 0 ? random() % environment.walls.size()
+                                                  : WallIndex::kNoWall;
+        const auto expected = whole.Crossings(a, b, ignore);
+        const auto actual = domains.Crossings(a, b, ignore);
+        assert(expected.size() == actual.size());
+        for (std::size_t hit = 0; hit < expected.size(); ++hit) {
+            assert(sameHit(expected[hit], actual[hit]));
+        }
+        const WallHit first = whole.FirstHit(a, b - a, 1e-9, 1.0, ignore);
+        const WallHit split = domains.FirstHit(a, b - a, 1e-9, 1.0, ignore);
+        assert(first.Valid() == split.Valid());
+        assert(!first.Valid() || sameHit(first, split));
+    }
+
+    // Through a wall junction every wall is crossed at the same point; both order such
+    // crossings by wall index.
+    const Vec2d a{5.0, 4.0};
+    const Vec2d b{7.0, 6.0};
+    const auto expected = whole.Crossings(a, b);
+    const auto actual = domains.Crossings(a, b);
+    assert(expected.size() >= 2 && expected.size() == actual.size());
+    for (std::size_t hit = 0; hit < expected.size(); ++hit) {
+        assert(sameHit(expected[hit], actual[hit]));
+        assert(hit == 0 || expected[hit - 1].t < expected[hit].t ||
+               (expected[hit - 1].t == expected[hit].t &&
+                expected[hit - 1].wallIndex < expected[hit].wallIndex));
+    }
+    assert(expected.front().t == expected.back().t);
+
+    const auto statistics = domains.Statistics();
+    assert(statistics.queries == 6001);
+    assert(statistics.splitQueries > 0 && statistics.splitQueries < statistics.queries);
+}
+
+void testSolveMatchesImageMethod() {
+    const PropagationEnvironment environment = makeCampus(6, 4);
+    const WallIndex whole(environment.walls);
+    WorkerPool pool(4);
+    DomainDecompositionOptions options;
+    options.regions = 4;
+    const DomainDecomposition domains(environment.walls, pool, options);
+
+    PropagationSettings settings;
+    settings.maxReflections = 2;
+    settings.maxTransmissions = 3;
+    MaterialCoefficientCache cache;
+    const PathEvaluator evaluator(environment.materials, 2.4e9, cache);
+    const Vec3d transmitter{9.0, 7.5, 2.5};
+    const std::vector<Vec3d> receivers{
+        {2.0, 2.0, 1.2}, {15.0, 12.0, 1.2}, {31.0, 18.0, 1.2}, {20.5, 3.0, 1.2}, {9.5, 7.0, 1.2}};
+    const auto decomposed = domains.Solve(transmitter, receivers, settings, &evaluator);
+
+    const ImageMethodSolver solver(whole, settings);
+    std::size_t total = 0;
+    for (std::size_t receiver = 0; receiver < receivers.size(); ++receiver) {
+        std::vector<PropagationPath> expected = solver.Solve(transmitter, receivers[receiver]);
+        for (PropagationPath &path : expected) {
+            evaluator.Apply(path);
+        }
+        assert(expected.size() == decomposed[receiver].size());
+        for (std::size_t path = 0; path < expected.size(); ++path) {
+            assert(samePath(expected[path], decomposed[receiver][path]));
+        }
+        total += expected.size();
+    }
+    assert(total > receivers.size());
+    assert(domains.Statistics().splitQueries > 0);
+}
+
+class WalkingReceiver : public rfmodel::engine::ISimulationObject,
+                        public rfmodel::engine::IReceiver {
+public:
+    WalkingReceiver(std::string id, std::array<double, 3> position, std::array<double, 2> velocity)
+        : id_(std::move(id)), position_(position), velocity_(velocity) {}
+
+    [[nodiscard]] std::string Id() const override { return id_; }
+    [[nodiscard]] std::string Type() const override { return "receiver"; }
+    void ApplyConfiguration(const std::string &) override {}
+    void Step(double deltaTimeSeconds) override {
+        position_[0] += velocity_[0] * deltaTimeSeconds;
+        position_[1] += velocity_[1] * deltaTimeSeconds;
+    }
+    void Reset() override {}
+
+    [[nodiscard]] std::array<double, 3> Position() const override { return position_; }
+    void SetPosition(const std::array<double, 3> &positionMeters) override {
+        position_ = positionMeters;
+    }
+    [[nodiscard]] std::array<double, 3> Orientation() const override { return {}; }
+    void SetOrientation(const std::array<double, 3> &) override {}
+    [[nodiscard]] double Sensitivity() const override { return -90.0; }
+    void SetSensitivity(double) override {}
+
+private:
+    std::string           id_;
+    std::array<double, 3> position_;
+    std::array<double, 2> velocity_;
+};
+
+void testObjectsMigrateBetweenRegions() {
+    const PropagationEnvironment environment = makeCampus(8, 6);
+    WorkerPool pool(4);
+    DomainDecompositionOptions options;
+    options.regions = 4;
+    options.haloMeters = 1.5;
+    DomainDecomposition domains(environment.walls, pool, options);
+
+    std::vector<std::unique_ptr<WalkingReceiver>> walkers;
+    std::vector<WalkingReceiver> reference;
+    std::vector<rfmodel::engine::ISimulationObject *> objects;
+    std::mt19937 random(11);
+    std::uniform_real_distribution<double> coordinate(0.0, 30.0);
+    std::uniform_real_distribution<double> speed(-1.5, 1.5);
+    for (int walker = 0; walker < 40; ++walker) {
+        const std::array<double, 3> position{coordinate(random), coordinate(random), 1.2};
+        const std::array<double, 2> velocity{speed(random), speed(random)};
+        walkers.push_back(
+            std::make_unique<WalkingReceiver>("rx" + std::to_string(walker), position, velocity));
+        reference.emplace_back("rx" + std::to_string(walker), position, velocity);
+        objects.push_back(walkers.back().get());
+    }
+    domains.AssignObjects(objects);
+
+    std::size_t migrations = 0;
+    for (int step = 0; step < 100; ++step) {
+        migrations += domains.StepObjects(0.1);
+        for (WalkingReceiver &walker : reference) {
+            walker.Step(0.1);
+        }
+    }
+    assert(migrations > 0 && domains.Statistics().migrations == migrations);
+
+    // Every object is still owned exactly once, by a region whose halo holds it, and has
+    // moved exactly as when stepped alone.
+    std::size_t owned = 0;
+    for (std::size_t region = 0; region < domains.RegionCount(); ++region) {
+        const auto halo = domains.RegionBounds(region).Expanded(options.haloMeters);
+        for (const auto *object : domains.RegionObjects(region)) {
+            const auto position = DomainDecomposition::LocateObject(*object);
+            assert(position && halo.Contains(*position));
+            ++owned;
+        }
+    }
+    assert(owned == walkers.size());
+    for (std::size_t walker = 0; walker < walkers.size(); ++walker) {
+        assert(walkers[walker]->Position() == reference[walker].Position());
+    }
+}
+
+}  // namespace
+
+int main() {
+    testQueriesMatchMonolithicIndex();
+    testSolveMatchesImageMethod();
+    testObjectsMigrateBetweenRegions();
+    return 0;
+}
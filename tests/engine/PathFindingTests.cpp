@@ -0,0 +1,534 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "DiffractionSolver.h"
+#include "ImageMethodSolver.h"
+#include "MaterialCoefficientCache.h"
+#include "PackedWallTable.h"
+#include "PathTracker.h"
+#include "PotentiallyVisibleSet.h"
+#include "PropagationPath.h"
+#include "PropagationSolver.h"
+#include "RayLaunchingSolver.h"
+#include "WallGeometry.h"
+
+namespace {
+
+constexpr double kTolerance = 1e-9;
+
+using rfmodel::engine::DiffractionSolver;
+using rfmodel::engine::DiffractionStatistics;
+using rfmodel::engine::EdgeVisibilityCache;
+using rfmodel::engine::ImageMethodSolver;
+using rfmodel::engine::KnifeEdgeLossDb;
+using rfmodel::engine::KnifeEdgeParameter;
+using rfmodel::engine::LinkBudget;
+using rfmodel::engine::InteractionType;
+using rfmodel::engine::MakeWallSegment;
+using rfmodel::engine::MaterialCoefficientCache;
+using rfmodel::engine::PackedWallTable;
+using rfmodel::engine::PathEvaluator;
+using rfmodel::engine::PathSearchStatistics;
+using rfmodel::engine::PathTracker;
+using rfmodel::engine::PathTrackerOptions;
+using rfmodel::engine::TrackedPath;
+using rfmodel::engine::PotentiallyVisibleSet;
+using rfmodel::engine::PropagationEnvironment;
+using rfmodel::engine::PropagationMethod;
+using rfmodel::engine::PropagationPath;
+using rfmodel::engine::PropagationSettings;
+using rfmodel::engine::PropagationSolver;
+using rfmodel::engine::RayLaunchStatistics;
+using rfmodel::engine::RayLaunchingSolver;
+using rfmodel::engine::WallIndex;
+using rfmodel::engine::WallMaterial;
+using rfmodel::math::Vec2d;
+using rfmodel::math::Vec3d;
+
+const WallMaterial kConcrete{5.31, 0.0326 * std::pow(2.4, 0.8095), 0.2};
+const WallMaterial kDrywall{2.73, 0.0085 * std::pow(2.4, 0.9395), 0.1};
+
+void addWall(PropagationEnvironment &environment, double x0, double y0, double x1, double y1,
+             const WallMaterial &material = kConcrete) {
+    environment.AddWall(MakeWallSegment(Vec2d{x0, y0}, Vec2d{x1, y1}), material);
+}
+
+// Two 10 m x 8 m rooms side by side with a doorway in the shared wall.
+PropagationEnvironment makeTwoRooms() {
+    PropagationEnvironment environment;
+    addWall(environment, 0.0, 0.0, 20.0, 0.0);
+    addWall(environment, 20.0, 0.0, 20.0, 8.0);
+    addWall(environment, 20.0, 8.0, 0.0, 8.0);
+    addWall(environment, 0.0, 8.0, 0.0, 0.0);
+    addWall(environment, 10.0, 0.0, 10.0, 3.0, kDrywall);
+    addWall(environment, 10.0, 4.5, 10.0, 8.0, kDrywall);
+    return environment;
+}
+
+using Signature = std::vector<std::pair<InteractionType, std::size_t>>;
+
+std::vector<Signature> signatures(const std::vector<PropagationPath> &paths) {
+    std::vector<Signature> result;
+    for (const PropagationPath &path : paths) {
+        Signature signature;
+        for (const auto &interaction : path.interactions) {
+            signature.emplace_back(interaction.type, interaction.wallIndex);
+        }
+        result.push_back(signature);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+// Three 10 m x 8 m rooms in a row separated by solid walls.
+PropagationEnvironment makeThreeRooms() {
+    PropagationEnvironment environment;
+    addWall(environment, 0.0, 0.0, 30.0, 0.0);
+    addWall(environment, 30.0, 0.0, 30.0, 8.0);
+    addWall(environment, 30.0, 8.0, 0.0, 8.0);
+    addWall(environment, 0.0, 8.0, 0.0, 0.0);
+    addWall(environment, 10.0, 0.0, 10.0, 8.0);
+    addWall(environment, 20.0, 0.0, 20.0, 8.0);
+    return environment;
+}
+
+void testImageMethodSingleReflection() {
+    PropagationEnvironment environment;
+    addWall(environment, -20.0, 5.0, 20.0, 5.0);
+    const WallIndex index(environment.walls);
+    PropagationSettings settings;
+    settings.maxReflections = 1;
+    const ImageMethodSolver solver(index, settings);
+
+    const auto paths = solver.Solve(Vec3d{0.0, 0.0, 1.5}, Vec3d{10.0, 0.0, 1.5});
+    assert(paths.size() == 2);
+    const auto reflected = std::find_if(paths.begin(), paths.end(), [](const PropagationPath &p) {
+        return !p.interactions.empty();
+    });
+    assert(reflected != paths.end());
+    assert(std::abs(reflected->lengthMeters - std::sqrt(200.0)) < kTolerance);
+    assert(std::abs(reflected->vertices[1].x - 5.0) < kTolerance);
+    assert(std::abs(reflected->vertices[1].y - 5.0) < kTolerance);
+    const double incidence = reflected->interactions[0].incidenceRadians;
+    assert(std::abs(incidence - rfmodel::math::kPi / 4.0) < kTolerance);
+}
+
+void testBlockedPathsBecomeTransmissions() {
+    PropagationEnvironment environment;
+    addWall(environment, 5.0, -10.0, 5.0, 10.0);
+    const WallIndex index(environment.walls);
+    PropagationSettings settings;
+    settings.maxReflections = 0;
+    const Vec3d transmitter{0.0, 0.0, 1.0};
+    const Vec3d receiver{10.0, 0.0, 3.0};
+
+    auto paths = ImageMethodSolver(index, settings).Solve(transmitter, receiver);
+    assert(paths.size() == 1);
+    assert(paths[0].interactions.size() == 1);
+    assert(paths[0].interactions[0].type == InteractionType::Transmission);
+    assert(std::abs(paths[0].lengthMeters - std::sqrt(104.0)) < kTolerance);
+
+    settings.maxTransmissions = 0;
+    paths = ImageMethodSolver(index, settings).Solve(transmitter, receiver);
+    assert(paths.empty());
+}
+
+void testRayLaunchingMatchesImageMethod() {
+    const PropagationEnvironment environment = makeTwoRooms();
+    MaterialCoefficientCache cache;
+    const PathEvaluator evaluator(environment.materials, 2.4e9, cache);
+    PropagationSettings settings;
+    settings.maxReflections = 2;
+    settings.maxTransmissions = 1;
+    settings.raysPerTransmitter = 20000;
+    settings.maxInteractionLossDb = 200.0;
+
+    PropagationSolver solver(environment, settings);
+    const Vec3d transmitter{3.0, 2.5, 1.5};
+    const std::vector<Vec3d> receivers{{7.0, 6.0, 1.5}, {16.0, 5.0, 1.5}, {14.0, 1.0, 1.2}};
+    const auto exact = solver.Solve(transmitter, receivers, &evaluator);
+    solver.SetMethod(PropagationMethod::RayLaunching);
+    const auto launched = solver.Solve(transmitter, receivers, &evaluator);
+
+    for (std::size_t receiver = 0; receiver < receivers.size(); ++receiver) {
+        assert(!exact[receiver].empty());
+        assert(signatures(launched[receiver]) == signatures(exact[receiver]));
+    }
+    // Paths found by both engines carry identical gains.
+    double exactPower = 0.0;
+    double launchedPower = 0.0;
+    for (const auto &path : exact[1]) {
+        exactPower += path.gain.magnitudeSquared();
+    }
+    for (const auto &path : launched[1]) {
+        launchedPower += path.gain.magnitudeSquared();
+    }
+    assert(std::abs(exactPower - launchedPower) <= 1e-12 * exactPower);
+}
+
+void testPacketsShareWallTests() {
+    PropagationEnvironment environment;
+    for (int index = 0; index < 40; ++index) {
+        const double x = 2.0 + 1.5 * index;
+        addWall(environment, x, -1.0 - index % 3, x, 1.0 + index % 2);
+    }
+    const WallIndex index(environment.walls);
+    PropagationSettings settings;
+    settings.maxReflections = 1;
+    settings.maxTransmissions = 0;
+    settings.raysPerTransmitter = 4096;
+
+    RayLaunchStatistics single;
+    RayLaunchStatistics packed;
+    settings.packetSize = 1;
+    const auto a = RayLaunchingSolver(index, settings).Solve(
+        Vec3d{0.0, 0.0, 1.0}, {Vec3d{-3.0, 0.5, 1.0}}, nullptr, &single);
+    settings.packetSize = 16;
+    const auto b = RayLaunchingSolver(index, settings).Solve(
+        Vec3d{0.0, 0.0, 1.0}, {Vec3d{-3.0, 0.5, 1.0}}, nullptr, &packed);
+    assert(signatures(a[0]) == signatures(b[0]));
+    assert(packed.packets < single.packets);
+    assert(packed.raySegments == single.raySegments);
+}
+
+void testBranchAndBoundKeepsAudiblePaths() {
+    const PropagationEnvironment environment = makeTwoRooms();
+    const WallIndex index(environment.walls);
+    MaterialCoefficientCache coefficients;
+    const PathEvaluator evaluator(environment.materials, 2.4e9, coefficients);
+    PropagationSettings settings;
+    settings.maxReflections = 3;
+    const ImageMethodSolver solver(index, settings, &evaluator);
+
+    const Vec3d transmitter{2.0, 2.0, 2.5};
+    const LinkBudget budget{0.0, -80.0, 2.4e9};
+    PathSearchStatistics exhaustive;
+    PathSearchStatistics bounded;
+    const auto fullTree = solver.BuildTree(transmitter, nullptr, &exhaustive);
+    const auto prunedTree = solver.BuildTree(transmitter, &budget, &bounded);
+    for (const Vec3d &receiver : {Vec3d{8.0, 6.0, 1.0}, Vec3d{18.0, 2.0, 1.0}}) {
+        const auto all = solver.Trace(fullTree, receiver, nullptr, &exhaustive);
+        const auto kept = solver.Trace(prunedTree, receiver, &budget, &bounded);
+        std::vector<PropagationPath> audible;
+        for (const PropagationPath &path : all) {
+            const double powerDbm = budget.transmitPowerDbm +
+                                    20.0 * std::log10(evaluator.Evaluate(path).magnitude());
+            if (powerDbm >= budget.sensitivityDbm) {
+                audible.push_back(path);
+            }
+        }
+        assert(!audible.empty());
+        const auto keptSignatures = signatures(kept);
+        for (const Signature &signature : signatures(audible)) {
+            assert(std::find(keptSignatures.begin(), keptSignatures.end(), signature) !=
+                   keptSignatures.end());
+        }
+    }
+    assert(exhaustive.pruned == 0);
+    assert(bounded.pruned > 0);
+    assert(bounded.explored < exhaustive.explored);
+}
+
+void testSlabReflectionBoundCoversInteriorPeak() {
+    // Drywall at 5.8 GHz: |R| is 0.412 at both 0 and 35 degrees but peaks near 25 degrees.
+    const WallMaterial drywall{2.94, 0.0116, 0.1};
+    const double frequencyHz = 5.8e9;
+    const double widest = 35.0 * rfmodel::math::kPi / 180.0;
+    const double specular = 25.0 * rfmodel::math::kPi / 180.0;
+    MaterialCoefficientCache coefficients;
+    const auto table = coefficients.Get(drywall, frequencyHz);
+    const auto te = rfmodel::engine::Polarization::TransverseElectric;
+    const double peak = table->Reflection(specular, te).magnitude();
+    assert(peak > 1.1 * std::max(table->Reflection(0.0, te).magnitude(),
+                                 table->Reflection(widest, te).magnitude()));
+    const double bound = table->MaxReflectionMagnitude(te, 0.0, widest);
+    for (double incidence = 0.0; incidence <= widest; incidence += 1e-3) {
+        assert(table->Reflection(incidence, te).magnitude() <= bound + kTolerance);
+    }
+
+    // The wall spans 0 to 35 degrees of incidence as seen from the transmitter, and the
+    // receiver sits where the specular point has 25 degrees; sensitivity is just below it.
+    const double height = 4.0;
+    PropagationEnvironment environment;
+    addWall(environment, height * std::tan(widest), 0.0, -height * std::tan(widest), 0.0,
+            drywall);
+    const WallIndex index(environment.walls);
+    const PathEvaluator evaluator(environment.materials, frequencyHz, coefficients);
+    PropagationSettings settings;
+    settings.maxReflections = 1;
+    const ImageMethodSolver solver(index, settings, &evaluator);
+    const Vec3d transmitter{0.0, height, 1.0};
+    const Vec3d receiver{2.0 * height * std::tan(specular), height, 1.0};
+
+    double reflectedDbm = 0.0;
+    for (const PropagationPath &path : solver.Solve(transmitter, receiver)) {
+        if (!path.interactions.empty()) {
+            reflectedDbm = 20.0 * std::log10(evaluator.Evaluate(path).magnitude());
+        }
+    }
+    assert(reflectedDbm < 0.0);
+    const LinkBudget budget{0.0, reflectedDbm - 0.2, frequencyHz};
+    PathSearchStatistics statistics;
+    const auto kept = solver.Solve(transmitter, receiver, &budget, &statistics);
+    assert(std::any_of(kept.begin(), kept.end(), [](const PropagationPath &path) {
+        return path.interactions.size() == 1 &&
+               path.interactions[0].type == InteractionType::Reflection;
+    }));
+    assert(statistics.pruned == 0);
+}
+
+}  // namespace
+
+void testVisibilitySetsCullImageTree() {
+    const PropagationEnvironment environment = makeThreeRooms();
+    const WallIndex index(environment.walls, 2.0);
+    const PotentiallyVisibleSet visibility = PotentiallyVisibleSet::Build(index, 0);
+    assert(visibility.CulledFraction() > 0.0);
+    // From the middle of the left room the far partition is hidden behind the near one.
+    assert(!visibility.PointSees(Vec2d{5.0, 4.0}, 5));
+    assert(visibility.PointSees(Vec2d{5.0, 4.0}, 4));
+    assert(visibility.PointSees(Vec2d{5.0, 4.0}, 0));
+    assert(visibility.RegionWalls(Vec2d{3.0, 3.0}, Vec2d{7.0, 5.0}).size() < 6);
+    assert(visibility.RegionWalls(Vec2d{-50.0, -50.0}, Vec2d{50.0, 50.0}).size() == 6);
+
+    PropagationSettings settings;
+    settings.maxReflections = 2;
+    settings.maxTransmissions = 0;
+    const ImageMethodSolver full(index, settings);
+    ImageMethodSolver culled(index, settings);
+    culled.SetVisibility(&visibility);
+    assert(culled.Culling());
+
+    const Vec3d transmitter{5.0, 4.0, 1.5};
+    const auto fullTree = full.BuildTree(transmitter);
+    const auto culledTree = culled.BuildTree(transmitter);
+    assert(culledTree.nodes.size() < fullTree.nodes.size());
+    for (const Vec3d &receiver : {Vec3d{7.0, 5.0, 1.5}, Vec3d{2.0, 1.0, 1.5},
+                                  Vec3d{9.5, 7.5, 1.5}, Vec3d{15.0, 4.0, 1.5}}) {
+        const auto expected = full.Trace(fullTree, receiver);
+        const auto actual = culled.Trace(culledTree, receiver);
+        assert(signatures(actual) == signatures(expected));
+    }
+
+    // Sets built for fewer transmissions than allowed would drop paths, so they are ignored.
+    settings.maxTransmissions = 1;
+    ImageMethodSolver penetrating(index, settings);
+    penetrating.SetVisibility(&visibility);
+    assert(!penetrating.Culling());
+}
+
+void testDiffractionFillsShadow() {
+    // A long wall with its top end at (5, 1) hides the receiver from the transmitter.
+    PropagationEnvironment environment;
+    addWall(environment, 5.0, -10.0, 5.0, 1.0);
+    const WallIndex index(environment.walls, 2.0);
+    const EdgeVisibilityCache cache(index);
+    assert(cache.Edges().size() == 2);
+    const DiffractionSolver solver(cache, PropagationSettings{});
+
+    const Vec3d transmitter{0.0, 0.0, 1.5};
+    const Vec3d receiver{10.0, -3.0, 1.5};
+    DiffractionStatistics statistics;
+    auto paths = solver.Solve(transmitter, receiver, nullptr, &statistics);
+    assert(paths.size() == 2 && statistics.paths == 2);
+    std::sort(paths.begin(), paths.end(), [](const PropagationPath &a, const PropagationPath &b) {
+        return a.lengthMeters < b.lengthMeters;
+    });
+    const PropagationPath &over = paths.front();
+    assert(over.interactions.size() == 1);
+    assert(over.interactions.front().type == InteractionType::Diffraction);
+    assert(std::abs(over.lengthMeters - (std::sqrt(26.0) + std::sqrt(41.0))) < kTolerance);
+    assert(std::abs(over.vertices[1].x - 5.0) < kTolerance);
+    assert(std::abs(over.vertices[1].y - 1.0) < kTolerance);
+
+    // The evaluator applies J(nu) on top of free-space spreading.
+    MaterialCoefficientCache coefficients;
+    const PathEvaluator evaluator(environment.materials, 2.4e9, coefficients);
+    const double wavelength = rfmodel::math::kSpeedOfLight / 2.4e9;
+    const double spreading = wavelength / (4.0 * rfmodel::math::kPi * over.lengthMeters);
+    const double loss =
+        KnifeEdgeLossDb(KnifeEdgeParameter(transmitter, over.vertices[1], receiver, wavelength));
+    assert(loss > 6.0);
+    const double expected = spreading * std::pow(10.0, -loss / 20.0);
+    assert(std::abs(evaluator.Evaluate(over).magnitude() - expected) < 1e-12);
+
+    // In the lit region there is no shadow to diffract into.
+    assert(solver.Solve(transmitter, Vec3d{10.0, 3.0, 1.5}).empty());
+}
+
+void testDiffractionPrunesBelowSensitivity() {
+    PropagationEnvironment environment;
+    addWall(environment, 5.0, -10.0, 5.0, 1.0);
+    const WallIndex index(environment.walls, 2.0);
+    const EdgeVisibilityCache cache(index);
+    const DiffractionSolver solver(cache, PropagationSettings{});
+    const Vec3d transmitter{0.0, 0.0, 1.5};
+    const Vec3d receiver{10.0, -3.0, 1.5};
+
+    // At 0 dBm the best case over the 11.5 m path is about -67.3 dBm and over the 19.8 m
+    // path about -72.0 dBm, including the 6 dB minimum edge loss.
+    DiffractionStatistics statistics;
+    LinkBudget budget{0.0, -70.0, 2.4e9};
+    auto paths = solver.Solve(transmitter, receiver, &budget, &statistics);
+    assert(paths.size() == 1 && statistics.pruned == 1);
+
+    budget.sensitivityDbm = -40.0;
+    paths = solver.Solve(transmitter, receiver, &budget, &statistics);
+    assert(paths.empty() && statistics.pruned == 2 && statistics.occluded == 0);
+
+    PropagationSettings generous;
+    generous.pruningMarginDb = 40.0;
+    const DiffractionSolver marginal(cache, generous);
+    assert(marginal.Solve(transmitter, receiver, &budget).size() == 2);
+}
+
+void testDiffractionSeesThroughNarrowSlit() {
+    // The edge at (0, 0) reaches the receiver only through a 0.13 m slit in the wall at
+    // x = 2, far narrower than the coarser grids. The diffracting edges must not depend on
+    // the cell size.
+    PropagationEnvironment environment;
+    addWall(environment, 0.0, -20.0, 0.0, 0.0);
+    addWall(environment, 2.0, -30.0, 2.0, -0.4);
+    addWall(environment, 2.0, -0.27, 2.0, 30.0);
+    addWall(environment, 20.0, -30.0, 20.0, 30.0);
+    const Vec3d transmitter{-5.0, -2.0, 1.0};
+    const Vec3d receiver{6.0, -1.0, 1.0};
+
+    const auto edges = [&](double cellSize) {
+        const WallIndex index(environment.walls, cellSize);
+        const EdgeVisibilityCache cache(index);
+        const DiffractionSolver solver(cache, PropagationSettings{});
+        std::vector<std::pair<double, double>> positions;
+        for (const PropagationPath &path : solver.Solve(transmitter, receiver)) {
+            positions.emplace_back(path.vertices[1].x, path.vertices[1].y);
+        }
+        std::sort(positions.begin(), positions.end());
+        return positions;
+    };
+    const auto fine = edges(0.25);
+    assert(std::find(fine.begin(), fine.end(), std::make_pair(0.0, 0.0)) != fine.end());
+    for (const double cellSize : {0.5, 1.0, 2.0, 4.0, 8.0}) {
+        assert(edges(cellSize) == fine);
+    }
+}
+
+std::vector<PropagationPath> untracked(const std::vector<TrackedPath> &tracked) {
+    std::vector<PropagationPath> paths;
+    for (const TrackedPath &path : tracked) {
+        paths.push_back(path.path);
+    }
+    return paths;
+}
+
+void testTrackerMatchesFullSearchWhileMoving() {
+    const PropagationEnvironment environment = makeTwoRooms();
+    const WallIndex index(environment.walls);
+    PropagationSettings settings;
+    settings.maxReflections = 2;
+    settings.maxTransmissions = 1;
+    const ImageMethodSolver solver(index, settings);
+    PathTracker tracker(index, settings);
+
+    // The receiver walks through the doorway, then the transmitter moves instead.
+    Vec3d transmitter{4.0, 5.0, 2.5};
+    Vec3d receiver{6.0, 3.5, 1.5};
+    constexpr std::size_t kSteps = 120;
+    for (std::size_t step = 0; step < kSteps; ++step) {
+        if (step < 100) {
+            receiver.x += 0.1;
+            receiver.y += 0.005;
+        } else {
+            transmitter.y -= 0.02;
+        }
+        const auto &tracked = tracker.Update(transmitter, receiver, 0.05);
+        const auto expected = solver.Solve(transmitter, receiver);
+        assert(signatures(untracked(tracked)) == signatures(expected));
+    }
+    assert(tracker.AnchoredAtReceiver());
+    assert(tracker.Statistics().updates == kSteps);
+    assert(tracker.Statistics().fullSearches < kSteps / 3);
+}
+
+void testTrackerDerivesDoppler() {
+    PropagationEnvironment environment;
+    addWall(environment, -50.0, 10.0, 50.0, 10.0);
+    const WallIndex index(environment.walls);
+    PropagationSettings settings;
+    settings.maxReflections = 1;
+    PathTrackerOptions options;
+    options.frequencyHz = 2.4e9;
+    PathTracker tracker(index, settings, nullptr, options);
+
+    // Receiver driving straight away from the transmitter at 20 m/s.
+    const Vec3d transmitter{0.0, 0.0, 1.5};
+    constexpr double kSpeed = 20.0;
+    constexpr double kStep = 0.01;
+    tracker.Update(transmitter, Vec3d{5.0, 0.0, 1.5}, kStep);
+    assert(!tracker.Paths().empty());
+    assert(!tracker.Paths().front().persistent);
+    const auto &tracked = tracker.Update(transmitter, Vec3d{5.0 + kSpeed * kStep, 0.0, 1.5}, kStep);
+    assert(tracked.size() == 2);
+    const double wavelength = rfmodel::math::kSpeedOfLight / options.frequencyHz;
+    for (const TrackedPath &path : tracked) {
+        assert(path.persistent);
+        assert(path.dopplerHz < 0.0);
+        if (path.path.interactions.empty()) {
+            assert(std::abs(path.dopplerHz + kSpeed / wavelength) < 1e-6);
+        } else {
+            assert(path.dopplerHz > -kSpeed / wavelength);
+        }
+    }
+    assert(tracker.Statistics().fullSearches == 1);
+}
+
+void testPackedWallsShareMaterials() {
+    PropagationEnvironment environment = makeTwoRooms();
+    // Move the floorplan far from the origin; packing must stay precise there.
+    for (auto &wall : environment.walls) {
+        wall = MakeWallSegment(wall.start + Vec2d{1500.0, -2200.0},
+                               wall.end + Vec2d{1500.0, -2200.0});
+    }
+    const PackedWallTable table = PackedWallTable::FromEnvironment(environment);
+    assert(table.WallCount() == environment.walls.size());
+    assert(table.MaterialCount() == 2);
+    assert(table.MaxPositionErrorMeters() < 1e-5);
+    assert(table.MemoryBytes() * 2 <
+           environment.walls.size() * (sizeof(environment.walls[0]) + sizeof(kConcrete)));
+    for (std::size_t wall = 0; wall < table.WallCount(); ++wall) {
+        assert(table.Material(wall) == environment.materials[wall]);
+        assert(std::abs(table.Segment(wall).normal.dot(environment.walls[wall].normal) - 1.0) <
+               1e-9);
+    }
+
+    const PropagationEnvironment unpacked = table.ToEnvironment();
+    const WallIndex index(environment.walls);
+    const WallIndex packedIndex(unpacked.walls);
+    PropagationSettings settings;
+    settings.maxReflections = 2;
+    const Vec3d transmitter{1503.0, -2195.0, 2.0};
+    const Vec3d receiver{1516.0, -2197.0, 1.5};
+    const auto exact = ImageMethodSolver(index, settings).Solve(transmitter, receiver);
+    const auto packed = ImageMethodSolver(packedIndex, settings).Solve(transmitter, receiver);
+    assert(signatures(exact) == signatures(packed));
+}
+
+int main() {
+    testImageMethodSingleReflection();
+    testBlockedPathsBecomeTransmissions();
+    testRayLaunchingMatchesImageMethod();
+    testPacketsShareWallTests();
+    testBranchAndBoundKeepsAudiblePaths();
+    testSlabReflectionBoundCoversInteriorPeak();
+    testVisibilitySetsCullImageTree();
+    testDiffractionFillsShadow();
+    testDiffractionPrunesBelowSensitivity();
+    testDiffractionSeesThroughNarrowSlit();
+    testTrackerMatchesFullSearchWhileMoving();
+    testTrackerDerivesDoppler();
+    testPackedWallsShareMaterials();
+    return 0;
+}
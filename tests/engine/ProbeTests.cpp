@@ -0,0 +1,212 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IRfEngine.h"
+#include "MaterialCoefficientCache.h"
+#include "PointProbe.h"
+#include "PropagationPath.h"
+#include "PropagationSettings.h"
+#include "PropagationSolver.h"
+#include "TransmitterState.h"
+#include "WallGeometry.h"
+
+namespace {
+
+using rfmodel::engine::MakeWallSegment;
+using rfmodel::engine::MaterialCoefficientCache;
+using rfmodel::engine::PathEvaluator;
+using rfmodel::engine::PointProbe;
+using rfmodel::engine::PointProbeOptions;
+using rfmodel::engine::ProbeResult;
+using rfmodel::engine::ProbeWorker;
+using rfmodel::engine::PropagationEnvironment;
+using rfmodel::engine::PropagationPath;
+using rfmodel::engine::PropagationSettings;
+using rfmodel::engine::PropagationSolver;
+using rfmodel::engine::TransmitterState;
+using rfmodel::engine::WallMaterial;
+using rfmodel::math::Vec2d;
+using rfmodel::math::Vec3d;
+
+const WallMaterial kConcrete{5.31, 0.0326 * std::pow(2.4, 0.8095), 0.2};
+const WallMaterial kDrywall{2.73, 0.0085 * std::pow(2.4, 0.9395), 0.1};
+
+// Two 10 m x 8 m rooms side by side with a doorway in the shared wall.
+PropagationEnvironment makeTwoRooms() {
+    PropagationEnvironment environment;
+    const auto add = [&](double x0, double y0, double x1, double y1, const WallMaterial &m) {
+        environment.AddWall(MakeWallSegment(Vec2d{x0, y0}, Vec2d{x1, y1}), m);
+    };
+    add(0.0, 0.0, 20.0, 0.0, kConcrete);
+    add(20.0, 0.0, 20.0, 8.0, kConcrete);
+    add(20.0, 8.0, 0.0, 8.0, kConcrete);
+    add(0.0, 8.0, 0.0, 0.0, kConcrete);
+    add(10.0, 0.0, 10.0, 3.0, kDrywall);
+    add(10.0, 4.5, 10.0, 8.0, kDrywall);
+    return environment;
+}
+
+std::vector<TransmitterState> makeTransmitters() {
+    TransmitterState first;
+    first.id = "ap-1";
+    first.positionMeters = {3.0, 5.0, 2.5};
+    first.powerDbm = 20.0;
+    TransmitterState second;
+    second.id = "ap-2";
+    second.positionMeters = {17.0, 2.0, 2.5};
+    second.powerDbm = 14.0;
+    return {first, second};
+}
+
+PropagationSettings makeSettings() {
+    PropagationSettings settings;
+    settings.maxReflections = 2;
+    settings.diffraction = true;
+    return settings;
+}
+
+double milliwatts(double dbm) {
+    return std::pow(10.0, dbm / 10.0);
+}
+
+void testProbeMatchesFullSolve() {
+    const PropagationEnvironment environment = makeTwoRooms();
+    const PropagationSolver solver(environment, makeSettings());
+    MaterialCoefficientCache cache;
+    const PathEvaluator evaluator(environment.materials, 2.4e9, cache);
+    PointProbeOptions options;
+    options.latencyBudgetSeconds = 10.0;
+    options.sensitivityDbm = -300.0;
+    PointProbe probe(solver, evaluator, options);
+    const std::vector<TransmitterState> transmitters = makeTransmitters();
+    assert(probe.SetTransmitters(transmitters) == 2);
+    assert(probe.CachedImageNodes() > 2);
+
+    for (const Vec3d &receiver : {Vec3d{6.0, 2.0, 1.2}, Vec3d{14.0, 6.5, 1.2}}) {
+        const ProbeResult result = probe.Probe(receiver);
+        assert(result.complete && result.completedOrders == 3);
+        assert(result.links.size() == transmitters.size());
+        double total = 0.0;
+        for (std::size_t link = 0; link < transmitters.size(); ++link) {
+            const auto &position = transmitters[link].positionMeters;
+            const std::vector<PropagationPath> paths =
+                solver.Solve(Vec3d{position[0], position[1], position[2]}, {receiver},
+                             &evaluator)[0];
+            double power = 0.0;
+            double delay = 0.0;
+            for (const PropagationPath &path : paths) {
+                const double pathPower =
+                    milliwatts(transmitters[link].powerDbm) * path.gain.magnitudeSquared();
+                power += pathPower;
+                delay += pathPower * path.DelaySeconds();
+            }
+            const auto &metrics = result.links[link];
+            assert(metrics.transmitterId == transmitters[link].id);
+            assert(metrics.pathCount == paths.size());
+            assert(std::abs(metrics.receivedPowerDbm - 10.0 * std::log10(power)) < 1e-9);
+            assert(std::abs(metrics.meanDelaySeconds - delay / power) < 1e-15);
+            assert(metrics.rmsDelaySpreadSeconds > 0.0);
+            assert(metrics.coherentPowerDbm < metrics.receivedPowerDbm + 10.0);
+            total += power;
+        }
+        assert(std::abs(result.totalPowerDbm - 10.0 * std::log10(total)) < 1e-9);
+        assert(result.strongestLink < transmitters.size());
+    }
+
+    // Unchanged transmitters keep their trees; a moved one is rebuilt.
+    std::vector<TransmitterState> moved = transmitters;
+    assert(probe.SetTransmitters(moved) == 0);
+    moved[1].positionMeters[1] = 3.0;
+    assert(probe.SetTransmitters(moved) == 1);
+}
+
+void testProbeStopsAtLatencyBudget() {
+    const PropagationEnvironment environment = makeTwoRooms();
+    const PropagationSolver solver(environment, makeSettings());
+    MaterialCoefficientCache cache;
+    const PathEvaluator evaluator(environment.materials, 2.4e9, cache);
+    PointProbeOptions options;
+    options.latencyBudgetSeconds = 0.0;
+    PointProbe probe(solver, evaluator, options);
+    probe.SetTransmitters(makeTransmitters());
+
+    // Line of sight (order zero) is too short to reach the first clock check.
+    const ProbeResult result = probe.Probe(Vec3d{6.0, 2.0, 1.2});
+    assert(!result.complete);
+    assert(result.completedOrders >= 1 && result.completedOrders < 3);
+    assert(result.links[0].pathCount >= 1);
+    assert(std::isfinite(result.totalPowerDbm));
+}
+
+void testWorkerAnswersLatestRequest() {
+    const PropagationEnvironment environment = makeTwoRooms();
+    const PropagationSolver solver(environment, makeSettings());
+    MaterialCoefficientCache cache;
+    const PathEvaluator evaluator(environment.materials, 2.4e9, cache);
+    PointProbeOptions options;
+    options.latencyBudgetSeconds = 10.0;
+    PointProbe probe(solver, evaluator, options);
+    probe.SetTransmitters(makeTransmitters());
+
+    std::atomic<std::size_t> callbacks{0};
+    ProbeWorker worker(probe, [&](std::uint64_t, const ProbeResult &) { ++callbacks; });
+    std::uint64_t last = 0;
+    Vec3d position{1.0, 1.0, 1.2};
+    for (int step = 0; step < 200; ++step) {
+        position = Vec3d{1.0 + 0.09 * step, 1.0 + 0.02 * step, 1.2};
+        last = worker.Submit(position);
+    }
+    assert(worker.WaitFor(last, 30.0));
+
+    std::uint64_t answered = 0;
+    const auto latest = worker.Latest(&answered);
+    assert(latest && answered == last);
+    const ProbeResult expected = probe.Probe(position);
+    assert(latest->complete && expected.complete);
+    assert(latest->totalPowerDbm == expected.totalPowerDbm);
+
+    const auto statistics = worker.Statistics();
+    assert(statistics.submitted == 200);
+    assert(statistics.evaluated + statistics.superseded == statistics.submitted);
+    assert(callbacks == statistics.evaluated);
+}
+
+// Implements only what IRfEngine requires, like engines that predate probing.
+class MinimalEngine : public rfmodel::engine::IRfEngine {
+public:
+    void LoadConfiguration(const std::string &) override {}
+    void RegisterScene(std::shared_ptr<rfmodel::engine::IScene>) override {}
+    void SetActiveScene(const std::shared_ptr<rfmodel::engine::IScene> &) override {}
+    [[nodiscard]] std::shared_ptr<rfmodel::engine::IScene> GetActiveScene() const override {
+        return nullptr;
+    }
+    [[nodiscard]] std::vector<std::shared_ptr<rfmodel::engine::IScene>> GetRegisteredScenes()
+        const override {
+        return {};
+    }
+    void StepSimulation(double) override {}
+    void Reset() override {}
+};
+
+void testEnginesWithoutProbingReportIncomplete() {
+    const MinimalEngine engine;
+    const ProbeResult result = engine.Probe({1.0, 2.0, 1.5});
+    assert(!result.complete);
+    assert(result.links.empty() && result.strongestLink == ProbeResult::kNoLink);
+}
+
+}  // namespace
+
+int main() {
+    testProbeMatchesFullSolve();
+    testProbeStopsAtLatencyBudget();
+    testWorkerAnswersLatestRequest();
+    testEnginesWithoutProbingReportIncomplete();
+    return 0;
+}
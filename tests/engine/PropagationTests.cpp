@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "AntennaArray.h"
+#include "BeamScanner.h"
+#include "FresnelCoefficients.h"
+#include "MaterialCoefficientCache.h"
+#include "PropagationPath.h"
+
+namespace {
+
+constexpr double kTolerance = 1e-9;
+
+using rfmodel::engine::AntennaArray;
+using rfmodel::engine::BeamScanner;
+using rfmodel::engine::ComputeFresnelCoefficients;
+using rfmodel::engine::ElementResponseBatch;
+using rfmodel::engine::InteractionType;
+using rfmodel::engine::MaterialCoefficientCache;
+using rfmodel::engine::PathEvaluator;
+using rfmodel::engine::Polarization;
+using rfmodel::engine::PropagationPath;
+using rfmodel::engine::WallMaterial;
+using rfmodel::math::Complex;
+using rfmodel::math::Vec3d;
+
+// Concrete at 2.4 GHz per ITU-R P.2040 (eps_r = 5.31, sigma = 0.0326 f^0.8095 S/m).
+const WallMaterial kConcrete{5.31, 0.0326 * std::pow(2.4, 0.8095), 0.2};
+
+void testFresnelLimits() {
+    const WallMaterial lossless{4.0, 0.0, 0.0};
+    const auto normal = ComputeFresnelCoefficients(lossless, 2.4e9, 0.0);
+    // A zero-thickness slab is transparent.
+    assert(normal.reflectionTe.magnitude() < kTolerance);
+    assert(std::abs(normal.transmissionTe.magnitude() - 1.0) < kTolerance);
+
+    // Half-wave slab at normal incidence (d = lambda / (2 sqrt(eps_r))) is also transparent.
+    const WallMaterial halfWave{4.0, 0.0, rfmodel::math::kSpeedOfLight / 2.4e9 / 4.0};
+    const auto resonant = ComputeFresnelCoefficients(halfWave, 2.4e9, 0.0);
+    assert(resonant.reflectionTe.magnitude() < 1e-6);
+
+    const auto quarter = ComputeFresnelCoefficients(halfWave, 1.2e9, 0.0);
+    // Quarter-wave slab: |R| = 2|G| / (1 + G^2) with G = (1 - 2) / (1 + 2).
+    const double gamma = 1.0 / 3.0;
+    const double expected = 2.0 * gamma / (1.0 + gamma * gamma);
+    assert(std::abs(quarter.reflectionTe.magnitude() - expected) < 1e-6);
+
+    // Energy conservation for a lossless slab.
+    const auto oblique = ComputeFresnelCoefficients(halfWave, 3.1e9, 0.7);
+    const double energy =
+        oblique.reflectionTm.magnitudeSquared() + oblique.transmissionTm.magnitudeSquared();
+    assert(std::abs(energy - 1.0) < 1e-9);
+}
+
+void testTableMatchesDirectComputation() {
+    MaterialCoefficientCache cache;
+    const auto table = cache.Get(kConcrete, 2.4e9);
+    double maxError = 0.0;
+    for (double angle = 0.0; angle < 1.5; angle += 0.0123) {
+        const auto direct = ComputeFresnelCoefficients(kConcrete, 2.4e9, angle);
+        const auto interpolated = table->Lookup(angle);
+        const double reflectionError = (direct.reflectionTe - interpolated.reflectionTe).magnitude();
+        const double transmissionError =
+            (direct.transmissionTm - interpolated.transmissionTm).magnitude();
+        maxError = std::max({maxError, reflectionError, transmissionError});
+    }
+    assert(maxError < 1e-3);
+}
+
+void testCacheSharesTablesBetweenIdenticalWalls() {
+    MaterialCoefficientCache cache;
+    const auto first = cache.Get(kConcrete, 2.4e9);
+    const auto second = cache.Get(WallMaterial{kConcrete}, 2.4e9);
+    assert(first == second);
+    const auto otherFrequency = cache.Get(kConcrete, 5.8e9);
+    assert(otherFrequency != first);
+    assert(cache.Size() == 2);
+}
+
+void testPathEvaluatorAppliesCoefficients() {
+    MaterialCoefficientCache cache;
+    const std::vector<WallMaterial> walls = {kConcrete, WallMaterial{2.0, 0.0, 0.1}};
+    const PathEvaluator evaluator(walls, 2.4e9, cache);
+
+    PropagationPath path;
+    path.lengthMeters = 25.0;
+    const Complex lineOfSight = evaluator.Evaluate(path);
+    const double wavelength = rfmodel::math::kSpeedOfLight / 2.4e9;
+    const double spreading = wavelength / (4.0 * rfmodel::math::kPi * 25.0);
+    assert(std::abs(lineOfSight.magnitude() - spreading) < kTolerance);
+
+    path.interactions.push_back({InteractionType::Reflection, 0, 0.4});
+    path.interactions.push_back({InteractionType::Transmission, 1, 0.2});
+    constexpr auto kTe = Polarization::TransverseElectric;
+    const Complex expected = lineOfSight * cache.Get(walls[0], 2.4e9)->Reflection(0.4, kTe) *
+                             cache.Get(walls[1], 2.4e9)->Transmission(0.2, kTe);
+    assert((evaluator.Evaluate(path) - expected).magnitude() < kTolerance);
+}
+
+PropagationPath planeWaveFrom(double azimuth, const Complex &gain) {
+    PropagationPath path;
+    path.vertices = {Vec3d{100.0 * std::cos(azimuth), 100.0 * std::sin(azimuth), 0.0}, Vec3d{}};
+    path.gain = gain;
+    return path;
+}
+
+void testBeamScanFindsAngleOfArrival() {
+    const double wavelength = rfmodel::math::kSpeedOfLight / 2.4e9;
+    const double wavenumber = rfmodel::math::kTwoPi / wavelength;
+    // Broadside faces +Y after a 90 degree yaw, so the array resolves azimuths in (0, pi).
+    const AntennaArray array = AntennaArray::UniformLinear(8, 0.5 * wavelength);
+    const auto offsets = array.WorldOffsets({0.0, 0.0, rfmodel::math::kHalfPi});
+
+    const double arrival = 1.1;
+    const std::vector<PropagationPath> paths = {planeWaveFrom(arrival, Complex{1e-3, 0.0})};
+    const auto responses = rfmodel::engine::ComputeElementResponses(paths, offsets, wavenumber);
+    for (const Complex &response : responses) {
+        assert(std::abs(response.magnitude() - 1e-3) < kTolerance);
+    }
+
+    std::vector<double> azimuths;
+    for (int beam = 1; beam < 180; ++beam) {
+        azimuths.push_back(rfmodel::math::kPi * beam / 180.0);
+    }
+    const BeamScanner<double> scanner(offsets, wavenumber, azimuths);
+    const auto spectrum = scanner.Spectrum(responses);
+    const auto peak = std::max_element(spectrum.begin(), spectrum.end()) - spectrum.begin();
+    assert(std::abs(azimuths[static_cast<std::size_t>(peak)] - arrival) < 0.01);
+    // Unit-norm steering recovers the full array gain on a matched beam.
+    const BeamScanner<double> matched(offsets, wavenumber, {arrival});
+    assert(std::abs(matched.Spectrum(responses)[0] - 8.0 * 1e-6) < 1e-12);
+}
+
+void testBatchedScanMatchesPerPointScan() {
+    const double wavenumber = 50.0;
+    const AntennaArray array = AntennaArray::UniformPlanar(2, 4, 0.06);
+    const auto offsets = array.WorldOffsets({0.0, 0.0, 0.3});
+    const BeamScanner<float> scanner(offsets, wavenumber, BeamScanner<float>::EvenAzimuths(36));
+
+    const std::size_t points = 5;
+    ElementResponseBatch<float> batch(array.ElementCount(), points);
+    std::vector<std::vector<Complex>> perPoint;
+    for (std::size_t point = 0; point < points; ++point) {
+        const std::vector<PropagationPath> paths = {
+            planeWaveFrom(0.4 * static_cast<double>(point), Complex{1.0, 0.5}),
+            planeWaveFrom(-1.0 + 0.2 * static_cast<double>(point), Complex{0.3, -0.2})};
+        perPoint.push_back(rfmodel::engine::ComputeElementResponses(paths, offsets, wavenumber));
+        batch.SetPoint(point, perPoint.back());
+    }
+
+    std::vector<float> beamPower;
+    scanner.Scan(batch, beamPower);
+    for (std::size_t point = 0; point < points; ++point) {
+        const auto spectrum = scanner.Spectrum(perPoint[point]);
+        for (std::size_t beam = 0; beam < scanner.BeamCount(); ++beam) {
+            assert(std::abs(beamPower[beam * points + point] - spectrum[beam]) < 1e-4F);
+        }
+    }
+
+    std::vector<std::size_t> bestBeam;
+    const auto best = BeamScanner<float>::BestBeamPower(beamPower, points, &bestBeam);
+    assert(best.size() == points);
+    assert(best[2] == beamPower[bestBeam[2] * points + 2]);
+}
+
+}  // namespace
+
+int main() {
+    testFresnelLimits();
+    testTableMatchesDirectComputation();
+    testCacheSharesTablesBetweenIdenticalWalls();
+    testPathEvaluatorAppliesCoefficients();
+    testBeamScanFindsAngleOfArrival();
+    testBatchedScanMatchesPerPointScan();
+    return 0;
+}
@@ -0,0 +1,441 @@
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ConfigurationChangeSet.h"
+#include "ConfigurationDocument.h"
+#include "ConfigurationReloader.h"
+#include "IRunConfig.h"
+#include "IScene.h"
+#include "ISimulationObject.h"
+#include "ISimulationSystem.h"
+#include "SceneSnapshot.h"
+#include "SimulationStepper.h"
+
+namespace {
+
+using rfmodel::engine::ConfigurationChangeSet;
+using rfmodel::engine::ConfigurationReloader;
+using rfmodel::engine::ObjectChangeKind;
+using rfmodel::engine::SceneBounds;
+using rfmodel::engine::SceneObjectState;
+using rfmodel::engine::SceneSnapshot;
+using rfmodel::engine::SnapshotResultCache;
+
+SceneObjectState makeWall(const std::string &id, double x, const std::string &material) {
+    SceneObjectState state;
+    state.id = id;
+    state.type = "wall";
+    state.fields["material"] = material;
+    state.bounds = SceneBounds{x, 0.0, x + 0.2, 10.0};
+    return state;
+}
+
+SceneSnapshot makeBuilding() {
+    SceneSnapshot snapshot;
+    for (int index = 0; index < 100; ++index) {
+        snapshot.SetObject(makeWall("wall-" + std::to_string(index), 10.0 * index, "drywall"));
+    }
+    return snapshot;
+}
+
+void testBranchesShareUnchangedObjects() {
+    const SceneSnapshot base = makeBuilding();
+    SceneSnapshot concrete = base.Branch();
+    assert(concrete.SetField("wall-3", "material", "concrete"));
+    SceneSnapshot removed = base.Branch();
+    assert(removed.RemoveObject("wall-7"));
+
+    assert(base.Find("wall-3")->fields.at("material") == "drywall");
+    assert(concrete.Find("wall-3")->fields.at("material") == "concrete");
+    assert(concrete.Find("wall-4") == base.Find("wall-4"));
+    assert(!removed.Find("wall-7"));
+    assert(removed.ObjectCount() == 99);
+    assert(concrete.ObjectCount() == 100);
+
+    const auto changes = SceneSnapshot::Diff(concrete, removed);
+    assert(changes.size() == 2);
+    assert(changes[0].id == "wall-3" && changes[0].before != changes[0].after);
+    assert(changes[1].id == "wall-7" && changes[1].before && !changes[1].after);
+    assert(SceneSnapshot::Diff(base, base.Branch()).empty());
+}
+
+void testCopyLeavesSourceUntouched() {
+    SceneSnapshot edited = makeBuilding().Branch();
+    edited.SetField("wall-1", "material", "glass");
+    const SceneSnapshot &source = edited;
+    const std::size_t depth = source.LayerDepth();
+
+    SceneSnapshot copy = source;
+    assert(source.LayerDepth() == depth && copy.LayerDepth() == depth);
+    assert(copy.Find("wall-1") == source.Find("wall-1"));
+    assert(SceneSnapshot::Diff(source, copy).empty());
+
+    copy.SetField("wall-1", "material", "metal");
+    assert(source.Find("wall-1")->fields.at("material") == "glass");
+    assert(SceneSnapshot::Diff(source, copy).size() == 1);
+}
+
+void testMovedFromSnapshotIsEmpty() {
+    SceneSnapshot source = makeBuilding().Branch();
+    source.SetField("wall-1", "material", "glass");
+
+    SceneSnapshot moved = std::move(source);
+    assert(moved.ObjectCount() == 100);
+    assert(moved.Find("wall-1")->fields.at("material") == "glass");
+    assert(source.ObjectCount() == 0 && !source.Find("wall-1"));
+    const SceneSnapshot copy = source;
+    assert(copy.ObjectCount() == 0);
+    source.SetObject(makeWall("wall-x", 0.0, "metal"));
+    assert(source.ObjectCount() == 1 && moved.ObjectCount() == 100);
+
+    SceneSnapshot assigned;
+    assigned = std::move(moved);
+    assert(assigned.ObjectCount() == 100 && moved.ObjectCount() == 0);
+    assert(moved.RemoveObject("wall-1") == false);
+}
+
+void testDeepBranchChainsAreFlattened() {
+    SceneSnapshot snapshot = makeBuilding();
+    for (int generation = 0; generation < 100; ++generation) {
+        snapshot = snapshot.Branch();
+        snapshot.SetField("wall-0", "generation", std::to_string(generation));
+    }
+    assert(snapshot.LayerDepth() <= SceneSnapshot::kMaxLayerDepth + 1);
+    assert(snapshot.Find("wall-0")->fields.at("generation") == "99");
+    assert(snapshot.ObjectCount() == 100);
+}
+
+void testResultCacheReusesUnaffectedEntries() {
+    const SceneSnapshot base = makeBuilding();
+    SnapshotResultCache<double> cache;
+    cache.Store("tile-near", base, SceneBounds{0.0, 0.0, 50.0, 10.0},
+                std::make_shared<double>(1.0));
+    cache.Store("tile-far", base, SceneBounds{500.0, 0.0, 550.0, 10.0},
+                std::make_shared<double>(2.0));
+
+    SceneSnapshot branch = base.Branch();
+    branch.SetField("wall-2", "material", "concrete");
+
+    assert(!cache.Find("tile-near", branch));
+    assert(*cache.Find("tile-near", base) == 1.0);
+    assert(*cache.Find("tile-far", branch) == 2.0);
+
+    branch.SetObject(makeWall("new-wall", 520.0, "glass"));
+    assert(!cache.Find("tile-far", branch));
+}
+
+class RecordingSystem : public rfmodel::engine::ISimulationSystem {
+public:
+    [[nodiscard]] std::string Name() const override { return "recording"; }
+    void Initialize(rfmodel::engine::IScene &) override {}
+    void Step(rfmodel::engine::IScene &, double) override {}
+    void OnConfigurationReload(const std::string &) override { ++fullReloads; }
+    bool OnConfigurationChanged(const ConfigurationChangeSet &changes) override {
+        received.push_back(changes);
+        return incremental;
+    }
+
+    bool                                incremental{true};
+    int                                 fullReloads{0};
+    std::vector<ConfigurationChangeSet> received;
+};
+
+const char *const kSiteConfiguration = R"(
+# Two rooms separated by a wall.
+[tx-1]
+type = transmitter
+frequency = 2.4e9
+power = 20
+
+[wall-a]
+type = wall
+material = drywall
+bounds = 0 0 10 0.2
+
+[wall-b]
+type = wall
+material = drywall ; interior
+bounds = 10 0 10.2 8
+)";
+
+void testConfigurationParsing() {
+    const auto parsed = rfmodel::engine::ParseSceneConfiguration(kSiteConfiguration);
+    assert(parsed.Ok());
+    assert(parsed.snapshot.ObjectCount() == 3);
+    const auto wall = parsed.snapshot.Find("wall-b");
+    assert(wall->type == "wall");
+    assert(wall->fields.at("material") == "drywall");
+    assert(wall->bounds.minX == 10.0 && wall->bounds.maxY == 8.0);
+
+    const auto broken = rfmodel::engine::ParseSceneConfiguration("[a]\nbounds = 1 2\nvalue\n");
+    assert(broken.errors.size() == 2);
+
+    const auto values = rfmodel::engine::ParseSceneConfiguration(
+        "[ap#2]\ncolor = #ff8800\npath = a;b/c#d # trailing\nlabel = \"x # y\" ; note\n"
+        "  ; indented comment\n");
+    assert(values.Ok());
+    const auto ap = values.snapshot.Find("ap#2");
+    assert(ap && ap->fields.size() == 3);
+    assert(ap->fields.at("color") == "#ff8800");
+    assert(ap->fields.at("path") == "a;b/c#d");
+    assert(ap->fields.at("label") == "\"x # y\"");
+}
+
+void testReloadDeliversFieldLevelChanges() {
+    auto system = std::make_shared<RecordingSystem>();
+    auto fallback = std::make_shared<RecordingSystem>();
+    fallback->incremental = false;
+    ConfigurationReloader reloader;
+    reloader.AddSystem(system);
+    reloader.AddSystem(fallback);
+
+    auto result = reloader.Reload("site.cfg", kSiteConfiguration);
+    assert(result.applied);
+    assert(result.changes.objects.size() == 3);
+    assert(result.changes.objects[0].kind == ObjectChangeKind::Added);
+
+    const auto unchanged = reloader.Reload("site.cfg", kSiteConfiguration);
+    assert(unchanged.applied && unchanged.changes.Empty());
+    assert(system->received.size() == 1);
+
+    std::string edited = kSiteConfiguration;
+    edited.replace(edited.find("drywall ; interior"), 7, "concrete");
+    edited += "[rx-1]\ntype = receiver\nbounds = 3 3 3 3\n";
+    const auto stale = reloader.Live().Find("tx-1");
+    result = reloader.Reload("site.cfg", edited);
+    assert(result.changes.objects.size() == 2);
+
+    const auto *wall = result.changes.Find("wall-b");
+    assert(wall != nullptr && wall->kind == ObjectChangeKind::Modified);
+    assert(wall->fields.size() == 1 && wall->fields[0].field == "material");
+    assert(*wall->fields[0].before == "drywall" && *wall->fields[0].after == "concrete");
+    assert(result.changes.Find("rx-1")->kind == ObjectChangeKind::Added);
+    assert(result.changes.Affects(SceneBounds{9.0, 1.0, 11.0, 2.0}));
+    assert(!result.changes.Affects(SceneBounds{20.0, 20.0, 30.0, 30.0}));
+
+    // Unchanged objects keep sharing their state with the previous live snapshot.
+    assert(reloader.Live().Find("tx-1") == stale);
+    assert(system->received.size() == 2);
+    assert(system->fullReloads == 0);
+    assert(fallback->received.size() == 2 && fallback->fullReloads == 2);
+
+    const auto rejected = reloader.Reload("site.cfg", "[broken\n");
+    assert(!rejected.applied && !rejected.errors.empty());
+    assert(reloader.Live().ObjectCount() == 4);
+}
+
+class ScheduledObject : public rfmodel::engine::ISimulationObject {
+public:
+    ScheduledObject(std::string id, std::vector<double> events)
+        : id_(std::move(id)), events_(std::move(events)) {}
+
+    [[nodiscard]] std::string Id() const override { return id_; }
+    [[nodiscard]] std::string Type() const override { return "test"; }
+    void ApplyConfiguration(const std::string &) override {}
+    void Step(double deltaTimeSeconds) override { deltas.push_back(deltaTimeSeconds); }
+    void Reset() override { deltas.clear(); }
+    [[nodiscard]] std::optional<double> NextEventTime(double now) const override {
+        for (const double event : events_) {
+            if (event > now) {
+                return event;
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::vector<double> deltas;
+
+private:
+    std::string         id_;
+    std::vector<double> events_;
+};
+
+class ListScene : public rfmodel::engine::IScene {
+public:
+    [[nodiscard]] std::string Name() const override { return "list"; }
+    void LoadConfiguration(const std::string &) override {}
+    void AddObject(std::unique_ptr<rfmodel::engine::ISimulationObject> object) override {
+        objects_.push_back(std::move(object));
+    }
+    bool RemoveObject(const std::string &) override { return false; }
+    [[nodiscard]] std::vector<rfmodel::engine::ISimulationObject *> GetObjects() const override {
+        std::vector<rfmodel::engine::ISimulationObject *> objects;
+        for (const auto &object : objects_) {
+            objects.push_back(object.get());
+        }
+        return objects;
+    }
+    void Clear() override { objects_.clear(); }
+    void Step(double) override {}
+
+private:
+    std::vector<std::unique_ptr<rfmodel::engine::ISimulationObject>> objects_;
+};
+
+class FixedRunConfig : public rfmodel::engine::IRunConfig {
+public:
+    [[nodiscard]] std::string Name() const override { return "test"; }
+    [[nodiscard]] Duration TimeStep() const override { return timeStep; }
+    void SetTimeStep(Duration value) override { timeStep = value; }
+    [[nodiscard]] Duration TotalDuration() const override { return totalDuration; }
+    void SetTotalDuration(Duration value) override { totalDuration = value; }
+    [[nodiscard]] std::size_t MaxIterations() const override { return maxIterations; }
+    void SetMaxIterations(std::size_t value) override { maxIterations = value; }
+    [[nodiscard]] rfmodel::engine::SteppingMode Stepping() const override { return mode; }
+    void SetStepping(rfmodel::engine::SteppingMode value) override { mode = value; }
+    [[nodiscard]] Duration MinTimeStep() const override { return minTimeStep; }
+    void SetMinTimeStep(Duration value) override { minTimeStep = value; }
+
+    Duration                      timeStep{1.0};
+    Duration                      totalDuration{86400.0};
+    std::size_t                   maxIterations{1000000};
+    rfmodel::engine::SteppingMode mode{rfmodel::engine::SteppingMode::EventDriven};
+    Duration                      minTimeStep{0.0};
+};
+
+void testEventQueueReschedulesLazily() {
+    rfmodel::engine::EventQueue queue;
+    const auto first = queue.Register();
+    const auto second = queue.Register();
+    queue.Schedule(first, 5.0);
+    queue.Schedule(second, 3.0);
+    queue.Schedule(second, 7.0);
+    assert(*queue.NextTime() == 5.0);
+    queue.Cancel(first);
+    assert(*queue.NextTime() == 7.0);
+
+    std::vector<rfmodel::engine::EventQueue::Handle> due;
+    queue.PopDue(6.0, due);
+    assert(due.empty());
+    queue.PopDue(7.0, due);
+    assert(due.size() == 1 && due[0] == second);
+    assert(!queue.NextTime());
+}
+
+void testEventDrivenSteppingSkipsIdleObjects() {
+    ListScene scene;
+    std::vector<double> fading;
+    for (int index = 1; index <= 200; ++index) {
+        fading.push_back(0.01 * index);
+    }
+    auto waypoints =
+        std::make_unique<ScheduledObject>("walker", std::vector<double>{600.0, 43200.0});
+    auto fast = std::make_unique<ScheduledObject>("fading", fading);
+    auto idle = std::make_unique<ScheduledObject>("wall", std::vector<double>{});
+    auto *walker = waypoints.get();
+    auto *fader = fast.get();
+    auto *wall = idle.get();
+    scene.AddObject(std::move(waypoints));
+    scene.AddObject(std::move(fast));
+    scene.AddObject(std::move(idle));
+
+    FixedRunConfig config;
+    rfmodel::engine::SimulationStepper stepper(scene, {});
+    const auto statistics = stepper.Run(config);
+
+    // A simulated day costs one step per declared event instead of 86400 fixed steps.
+    assert(statistics.steps == 202);
+    assert(statistics.objectSteps == 202);
+    assert(statistics.endTimeSeconds == 86400.0);
+    assert(walker->deltas.size() == 2);
+    assert(walker->deltas[0] == 600.0 && walker->deltas[1] == 42600.0);
+    assert(fader->deltas.size() == 200);
+    assert(std::abs(fader->deltas[57] - 0.01) < 1e-9);
+    assert(wall->deltas.empty());
+
+    assert(stepper.Synchronize() == 3);
+    assert(wall->deltas.size() == 1 && wall->deltas[0] == 86400.0);
+    assert(std::abs(fader->deltas.back() - (86400.0 - 2.0)) < 1e-9);
+}
+
+void testMinTimeStepCoalescesEvents() {
+    ListScene scene;
+    std::vector<double> events;
+    for (int index = 1; index <= 100; ++index) {
+        events.push_back(index / 1024.0);
+    }
+    auto object = std::make_unique<ScheduledObject>("burst", events);
+    auto *burst = object.get();
+    scene.AddObject(std::move(object));
+
+    FixedRunConfig config;
+    config.totalDuration = FixedRunConfig::Duration{1.0};
+    config.minTimeStep = FixedRunConfig::Duration{8.0 / 1024.0};
+    rfmodel::engine::SimulationStepper stepper(scene, {});
+    stepper.Run(config);
+    // 100 events within ~0.1 s collapse onto 8/1024 s steps.
+    assert(burst->deltas.size() == 13);
+
+    FixedRunConfig fixed;
+    fixed.mode = rfmodel::engine::SteppingMode::FixedStep;
+    fixed.totalDuration = FixedRunConfig::Duration{2.0};
+    fixed.timeStep = FixedRunConfig::Duration{0.5};
+    const auto statistics = stepper.Run(fixed);
+    assert(statistics.steps == 4 && statistics.endTimeSeconds == 3.0);
+}
+
+// Always asks to be stepped again at the current time.
+class StuckObject : public ScheduledObject {
+public:
+    StuckObject() : ScheduledObject("stuck", {}) {}
+    [[nodiscard]] std::optional<double> NextEventTime(double now) const override { return now; }
+};
+
+void testNonAdvancingEventsDoNotStall() {
+    ListScene scene;
+    auto object = std::make_unique<StuckObject>();
+    auto *stuck = object.get();
+    scene.AddObject(std::move(object));
+
+    FixedRunConfig config;
+    config.totalDuration = FixedRunConfig::Duration{10.0};
+    rfmodel::engine::SimulationStepper stepper(scene, {});
+    const auto statistics = stepper.Run(config);
+    assert(statistics.steps == 1 && stuck->deltas.size() == 1);
+    assert(statistics.endTimeSeconds == 10.0);
+}
+
+void testIterationLimitKeepsPendingEvents() {
+    ListScene scene;
+    auto object = std::make_unique<ScheduledObject>(
+        "ticker", std::vector<double>{1.0, 2.0, 3.0, 4.0, 5.0});
+    auto *ticker = object.get();
+    scene.AddObject(std::move(object));
+
+    FixedRunConfig config;
+    config.totalDuration = FixedRunConfig::Duration{10.0};
+    config.maxIterations = 2;
+    rfmodel::engine::SimulationStepper stepper(scene, {});
+    auto statistics = stepper.Run(config);
+    // Events at 3, 4 and 5 s are still queued, so the clock stays at the last one handled.
+    assert(statistics.steps == 2 && statistics.endTimeSeconds == 2.0);
+    assert(stepper.CurrentTime() == 2.0);
+
+    config.maxIterations = 1000000;
+    statistics = stepper.Run(config);
+    assert(statistics.steps == 3 && statistics.endTimeSeconds == 12.0);
+    assert(ticker->deltas == std::vector<double>({1.0, 1.0, 1.0, 1.0, 1.0}));
+}
+
+}  // namespace
+
+int main() {
+    testBranchesShareUnchangedObjects();
+    testCopyLeavesSourceUntouched();
+    testMovedFromSnapshotIsEmpty();
+    testDeepBranchChainsAreFlattened();
+    testResultCacheReusesUnaffectedEntries();
+    testConfigurationParsing();
+    testReloadDeliversFieldLevelChanges();
+    testEventQueueReschedulesLazily();
+    testEventDrivenSteppingSkipsIdleObjects();
+    testMinTimeStepCoalescesEvents();
+    testNonAdvancingEventsDoNotStall();
+    testIterationLimitKeepsPendingEvents();
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "CoverageRaster.h"
+#include "SweepCoordinator.h"
+
+namespace {
+
+using rfmodel::engine::RasterGeometry;
+using rfmodel::engine::SharedResultRing;
+using rfmodel::engine::SweepCoordinator;
+using rfmodel::engine::SweepShardingOptions;
+
+void testResultRingWrapsAround() {
+    std::vector<unsigned char> memory(SharedResultRing::RequiredBytes(3, 2));
+    SharedResultRing ring = SharedResultRing::Create(memory.data(), 3, 2);
+    double values[2] = {0.0, 0.0};
+    std::uint64_t task = 0;
+
+    for (std::uint64_t round = 0; round < 4; ++round) {
+        for (std::uint64_t slot = 0; slot < 3; ++slot) {
+            const double payload[2] = {static_cast<double>(round), static_cast<double>(slot)};
+            assert(ring.TryPush(round * 3 + slot, payload));
+        }
+        assert(!ring.TryPush(99, values));
+        for (std::uint64_t slot = 0; slot < 3; ++slot) {
+            assert(ring.TryPop(task, values));
+            assert(task == round * 3 + slot);
+            assert(values[0] == static_cast<double>(round));
+            assert(values[1] == static_cast<double>(slot));
+        }
+        assert(!ring.TryPop(task, values));
+    }
+}
+
+void testShardedSweepMatchesSerial() {
+    SweepShardingOptions options;
+    options.workers = 3;
+    options.valuesPerTask = 2;
+    const auto work = [](std::size_t task, double *values) {
+        values[0] = std::sqrt(static_cast<double>(task));
+        values[1] = static_cast<double>(task * task);
+    };
+
+    const auto sharded = SweepCoordinator(options).Run(500, work);
+    options.workers = 0;
+    const auto serial = SweepCoordinator(options).Run(500, work);
+
+    assert(sharded.Ok() && serial.Ok());
+    assert(sharded.workerRestarts == 0);
+    assert(sharded.values == serial.values);
+}
+
+void testCrashedWorkersAreRestarted() {
+    // Shared between all forked workers so that only the first attempt at task 17 crashes.
+    auto *crashed = static_cast<std::atomic<int> *>(::mmap(
+        nullptr, sizeof(std::atomic<int>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+        -1, 0));
+    assert(crashed != MAP_FAILED);
+    new (crashed) std::atomic<int>(0);
+
+    SweepShardingOptions options;
+    options.workers = 2;
+    options.maxAttemptsPerTask = 2;
+    const auto work = [crashed](std::size_t task, double *values) {
+        if (task == 17 && crashed->exchange(1) == 0) {
+            std::_Exit(3);
+        }
+        if (task == 40) {
+            std::_Exit(4);
+        }
+        values[0] = static_cast<double>(task) + 0.5;
+    };
+    const auto result = SweepCoordinator(options).Run(64, work);
+
+    assert(result.completed[17] && result.values[17] == 17.5);
+    assert(result.failedTasks.size() == 1 && result.failedTasks[0] == 40);
+    assert(!result.completed[40]);
+    assert(result.workerRestarts >= 3);
+    for (std::size_t task = 0; task < 64; ++task) {
+        if (task != 40) {
+            assert(result.completed[task]);
+            assert(result.values[task] == static_cast<double>(task) + 0.5);
+        }
+    }
+    ::munmap(crashed, sizeof(std::atomic<int>));
+}
+
+void testThrowingTaskFailsWithoutEscapingWorker() {
+    // A worker that unwinds out of Run() would reach the handler below and report here.
+    int escaped[2];
+    assert(::pipe(escaped) == 0);
+    assert(::fcntl(escaped[0], F_SETFL, O_NONBLOCK) == 0);
+
+    SweepShardingOptions options;
+    options.workers = 1;
+    options.maxInFlightPerWorker = 4;
+    options.maxAttemptsPerTask = 1;
+    const auto work = [](std::size_t task, double *values) {
+        if (task == 5) {
+            throw std::runtime_error("task failed");
+        }
+        values[0] = static_cast<double>(task);
+    };
+    rfmodel::engine::SweepShardResult result;
+    try {
+        result = SweepCoordinator(options).Run(12, work);
+    } catch (const std::runtime_error &) {
+        const char byte = 1;
+        static_cast<void>(::write(escaped[1], &byte, 1));
+        ::_exit(0);
+    }
+
+    char byte = 0;
+    assert(::read(escaped[0], &byte, 1) < 0);
+    ::close(escaped[0]);
+    ::close(escaped[1]);
+
+    // Tasks queued behind the failing one were not charged its attempt.
+    assert(result.failedTasks.size() == 1 && result.failedTasks[0] == 5);
+    assert(result.workerRestarts == 1);
+    for (std::size_t task = 0; task < 12; ++task) {
+        assert(result.completed[task] == (task != 5));
+    }
+}
+
+void testShardedCoverageTiles() {
+    RasterGeometry geometry;
+    geometry.columns = 37;
+    geometry.rows = 23;
+    geometry.cellSizeMeters = 0.5;
+    SweepShardingOptions options;
+    options.workers = 2;
+
+    std::vector<std::size_t> failed;
+    const auto raster = rfmodel::engine::ShardCoverageRaster(
+        geometry, 8, [](double x, double y) { return x * 100.0 + y; }, options, &failed);
+    assert(failed.empty());
+    for (std::size_t row = 0; row < geometry.rows; ++row) {
+        for (std::size_t column = 0; column < geometry.columns; ++column) {
+            const double expected =
+                geometry.CellCenterX(column) * 100.0 + geometry.CellCenterY(row);
+            assert(raster.At(column, row) == expected);
+        }
+    }
+}
+
+}  // namespace
+
+int main() {
+    testResultRingWrapsAround();
+    testShardedSweepMatchesSerial();
+    testCrashedWorkersAreRestarted();
+    testThrowingTaskFailsWithoutEscapingWorker();
+    testShardedCoverageTiles();
+    return 0;
+}
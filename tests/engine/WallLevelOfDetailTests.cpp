@@ -0,0 +1,117 @@
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "WallGeometry.h"
+#include "WallLevelOfDetail.h"
+
+namespace {
+
+constexpr double kTolerance = 1e-9;
+
+using rfmodel::engine::ClipSegment;
+using rfmodel::engine::MakeWallSegment;
+using rfmodel::engine::PixelBounds;
+using rfmodel::engine::PixelPoint;
+using rfmodel::engine::ScreenTransform;
+using rfmodel::engine::SnappedSegmentKey;
+using rfmodel::engine::SnapWallsToPixels;
+using rfmodel::engine::WallSegment;
+using rfmodel::math::Vec2d;
+
+bool samePoint(const Vec2d &a, const Vec2d &b) {
+    return std::abs(a.x - b.x) < kTolerance && std::abs(a.y - b.y) < kTolerance;
+}
+
+void testClipSegmentKeepsInsidePart() {
+    const PixelBounds bounds{0.0, 0.0, 10.0, 10.0};
+
+    Vec2d start{-5.0, 5.0};
+    Vec2d end{15.0, 5.0};
+    assert(ClipSegment(start, end, bounds));
+    assert(samePoint(start, Vec2d{0.0, 5.0}) && samePoint(end, Vec2d{10.0, 5.0}));
+
+    start = Vec2d{2.0, 3.0};
+    end = Vec2d{4.0, 8.0};
+    assert(ClipSegment(start, end, bounds));
+    assert(samePoint(start, Vec2d{2.0, 3.0}) && samePoint(end, Vec2d{4.0, 8.0}));
+
+    start = Vec2d{-4.0, -1.0};
+    end = Vec2d{6.0, 14.0};
+    assert(ClipSegment(start, end, bounds));
+    assert(std::abs(start.x - (-4.0 + 10.0 * 4.0 / 10.0)) < kTolerance && start.y >= 0.0);
+    assert(std::abs(end.y - 10.0) < kTolerance);
+
+    // Outside to one side, and parallel to an edge outside it.
+    start = Vec2d{-5.0, -5.0};
+    end = Vec2d{-1.0, 20.0};
+    assert(!ClipSegment(start, end, bounds));
+    start = Vec2d{1.0, 12.0};
+    end = Vec2d{9.0, 12.0};
+    assert(!ClipSegment(start, end, bounds));
+}
+
+void testSegmentKeyIgnoresDirection() {
+    const PixelPoint a{3, 7};
+    const PixelPoint b{120, -1};
+    assert(SnappedSegmentKey(a, b) == SnappedSegmentKey(b, a));
+    assert(SnappedSegmentKey(a, b) != SnappedSegmentKey(a, PixelPoint{120, 0}));
+    assert(SnappedSegmentKey(a, a) != SnappedSegmentKey(b, b));
+}
+
+void testZoomedOutWallsCollapse() {
+    // 1000 short walls packed into a 2 m square; at 2 pixels per meter they cover a few
+    // pixels, while the long walls stay distinct and one lies entirely off-screen.
+    std::vector<WallSegment> walls;
+    for (int index = 0; index < 1000; ++index) {
+        const double x = 0.002 * index;
+        walls.push_back(MakeWallSegment(Vec2d{x, 0.0}, Vec2d{x, 0.05}));
+    }
+    walls.push_back(MakeWallSegment(Vec2d{0.0, 10.0}, Vec2d{40.0, 10.0}));
+    walls.push_back(MakeWallSegment(Vec2d{40.0, 10.0}, Vec2d{0.0, 10.0}));
+    walls.push_back(MakeWallSegment(Vec2d{0.0, 20.0}, Vec2d{40.0, 30.0}));
+    walls.push_back(MakeWallSegment(Vec2d{500.0, 500.0}, Vec2d{600.0, 500.0}));
+
+    ScreenTransform transform;
+    transform.m11 = 2.0;
+    transform.m22 = -2.0;
+    transform.dx = 10.0;
+    transform.dy = 90.0;
+    const auto snapped = SnapWallsToPixels(walls, transform, 100, 100);
+
+    // The short walls snap to pixels (10..14, 90); the reversed long wall is a duplicate.
+    assert(snapped.points.size() + snapped.lines.size() <= 8);
+    assert(snapped.duplicates + snapped.points.size() + snapped.lines.size() == walls.size() - 1);
+    bool horizontal = false;
+    for (const auto &[a, b] : snapped.lines) {
+        assert(a.x >= -1 && a.x <= 101 && a.y >= -1 && a.y <= 101);
+        assert(b.x >= -1 && b.x <= 101 && b.y >= -1 && b.y <= 101);
+        horizontal = horizontal || (a.y == 70 && b.y == 70);
+    }
+    assert(horizontal);
+}
+
+void testZoomedInWallsStayDistinct() {
+    std::vector<WallSegment> walls;
+    for (int index = 0; index < 50; ++index) {
+        const double y = 0.5 * index;
+        walls.push_back(MakeWallSegment(Vec2d{0.0, y}, Vec2d{10.0, y}));
+    }
+    ScreenTransform transform;
+    transform.m11 = 20.0;
+    transform.m22 = 20.0;
+    const auto snapped = SnapWallsToPixels(walls, transform, 400, 1000);
+    assert(snapped.lines.size() == walls.size());
+    assert(snapped.points.empty() && snapped.duplicates == 0);
+}
+
+}  // namespace
+
+int main() {
+    testClipSegmentKeepsInsidePart();
+    testSegmentKeyIgnoresDirection();
+    testZoomedOutWallsCollapse();
+    testZoomedInWallsStayDistinct();
+    return 0;
+}
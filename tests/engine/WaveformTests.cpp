@@ -0,0 +1,238 @@
+#include <cassert>
+#include <cmath>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "WaveformStream.h"
+#include "WorkerPool.h"
+
+#include "rfmodel/math/Complex.h"
+#include "rfmodel/math/Constants.h"
+
+namespace {
+
+constexpr double kTolerance = 1e-9;
+
+using rfmodel::engine::ChannelTap;
+using rfmodel::engine::ImpulseResponse;
+using rfmodel::engine::WaveformOptions;
+using rfmodel::engine::WaveformStream;
+using rfmodel::engine::WorkerPool;
+using rfmodel::math::Complex;
+
+using Blocks = std::vector<std::vector<Complex>>;
+
+ImpulseResponse fixedResponse(double, ImpulseResponse taps) {
+    return taps;
+}
+
+Complex sampleAt(std::size_t n) {
+    return Complex{std::cos(0.37 * n) + 0.05 * (n % 7), std::sin(0.11 * n * n)};
+}
+
+void testImpulseIsDelayedAndScaled() {
+    WaveformOptions options;
+    options.sampleRateHz = 1e6;
+    options.blockSize = 64;
+    options.maxDelaySeconds = 20e-6;
+    options.workers = 1;
+    WaveformStream stream(options);
+    const std::size_t source = stream.AddSource();
+    stream.AddLink(source, [](double time) {
+        return fixedResponse(time, {ChannelTap{10e-6, Complex{0.0, 0.5}}});
+    });
+
+    Blocks input(1, std::vector<Complex>(options.blockSize));
+    input[0][0] = Complex{1.0, 0.0};
+    Blocks output;
+    assert(stream.Process(input, output));
+    assert(output.size() == 1 && output[0].size() == options.blockSize);
+    for (std::size_t n = 0; n < options.blockSize; ++n) {
+        const Complex expected = n == 10 ? Complex{0.0, 0.5} : Complex{};
+        assert(std::abs(output[0][n].real - expected.real) < kTolerance);
+        assert(std::abs(output[0][n].imag - expected.imag) < kTolerance);
+    }
+
+    Blocks wrongSize(1, std::vector<Complex>(options.blockSize - 1));
+    std::string error;
+    assert(!stream.Process(wrongSize, output, &error));
+    assert(!error.empty());
+}
+
+void testOverlapSaveMatchesDirectConvolution() {
+    WaveformOptions options;
+    options.sampleRateHz = 1e6;
+    options.blockSize = 500;
+    options.maxDelaySeconds = 40e-6;
+    options.workers = 1;
+    const ImpulseResponse taps{{3e-6, Complex{0.8, 0.1}}, {37e-6, Complex{-0.3, 0.4}}};
+    WaveformStream stream(options);
+    stream.AddLink(stream.AddSource(), [taps](double time) { return fixedResponse(time, taps); });
+    assert(stream.TransformSize() < options.blockSize);
+
+    constexpr std::size_t kBlocks = 4;
+    std::vector<Complex> streamed;
+    Blocks input(1, std::vector<Complex>(options.blockSize));
+    Blocks output;
+    for (std::size_t block = 0; block < kBlocks; ++block) {
+        for (std::size_t n = 0; n < options.blockSize; ++n) {
+            input[0][n] = sampleAt(block * options.blockSize + n);
+        }
+        assert(stream.Process(input, output));
+        streamed.insert(streamed.end(), output[0].begin(), output[0].end());
+    }
+
+    for (std::size_t n = 0; n < streamed.size(); ++n) {
+        Complex expected;
+        for (const ChannelTap &tap : taps) {
+            const auto delay = static_cast<std::size_t>(std::lround(tap.delaySeconds * 1e6));
+            if (n >= delay) {
+                expected += tap.gain * sampleAt(n - delay);
+            }
+        }
+        assert(std::abs(streamed[n].real - expected.real) < 1e-9);
+        assert(std::abs(streamed[n].imag - expected.imag) < 1e-9);
+    }
+    assert(stream.Statistics().blocks == kBlocks);
+    assert(stream.Statistics().responseUpdates == 1);
+}
+
+void testFractionalDelayShiftsPhase() {
+    WaveformOptions options;
+    options.sampleRateHz = 1e6;
+    options.blockSize = 128;
+    options.maxDelaySeconds = 10e-6;
+    options.workers = 1;
+    WaveformStream stream(options);
+    stream.AddLink(stream.AddSource(), [](double time) {
+        return fixedResponse(time, {ChannelTap{4.5e-6, Complex{1.0, 0.0}}});
+    });
+
+    constexpr double kOmega = 0.2;
+    Blocks input(1, std::vector<Complex>(options.blockSize));
+    Blocks output;
+    for (std::size_t block = 0; block < 2; ++block) {
+        for (std::size_t n = 0; n < options.blockSize; ++n) {
+            const double index = static_cast<double>(block * options.blockSize + n);
+            input[0][n] = Complex::fromPolar(1.0, kOmega * index);
+        }
+        assert(stream.Process(input, output));
+    }
+    for (std::size_t n = 0; n < options.blockSize; ++n) {
+        const double index = static_cast<double>(options.blockSize + n);
+        const Complex expected = Complex::fromPolar(1.0, kOmega * (index - 4.5));
+        assert((output[0][n] - expected).magnitude() < 0.02);
+    }
+}
+
+void testResponseChangesTakeEffectPerBlock() {
+    WaveformOptions options;
+    options.sampleRateHz = 1e6;
+    options.blockSize = 16;
+    options.maxDelaySeconds = 0.0;
+    options.workers = 1;
+    WaveformStream stream(options);
+    const double switchTime = 2.0 * options.blockSize / options.sampleRateHz;
+    stream.AddLink(stream.AddSource(), [switchTime](double time) {
+        const double gain = time < switchTime ? 1.0 : 0.25;
+        return ImpulseResponse{{0.0, Complex{gain, 0.0}}};
+    });
+
+    Blocks input(1, std::vector<Complex>(options.blockSize, Complex{1.0, 0.0}));
+    Blocks output;
+    for (std::size_t block = 0; block < 4; ++block) {
+        assert(stream.Process(input, output));
+        const double expected = block < 2 ? 1.0 : 0.25;
+        for (const Complex &sample : output[0]) {
+            assert(std::abs(sample.real - expected) < kTolerance);
+        }
+    }
+    assert(stream.Statistics().responseUpdates == 2);
+    assert(std::abs(stream.TimeSeconds() - 4.0 * options.blockSize / 1e6) < kTolerance);
+}
+
+void testParallelLinksMatchSerial() {
+    constexpr std::size_t kSources = 4;
+    constexpr std::size_t kLinks = 24;
+    WaveformOptions options;
+    options.blockSize = 256;
+    options.sampleRateHz = 20e6;
+    options.maxDelaySeconds = 2e-6;
+
+    Blocks serialOutput;
+    Blocks parallelOutput;
+    std::size_t allocations = 0;
+    for (std::size_t workers : {std::size_t{1}, std::size_t{4}}) {
+        options.workers = workers;
+        WaveformStream stream(options);
+        for (std::size_t source = 0; source < kSources; ++source) {
+            stream.AddSource();
+        }
+        for (std::size_t link = 0; link < kLinks; ++link) {
+            const double delay = 1e-7 * static_cast<double>(link) + 3e-9;
+            stream.AddLink(link % kSources, [delay, link](double time) {
+                const double fade = 1.0 + 0.1 * std::sin(1e5 * time + link);
+                return ImpulseResponse{{delay, Complex{fade, 0.0}},
+                                       {delay * 2.0, Complex{0.0, 0.3 * fade}},
+                                       {1e-3, Complex{1.0, 0.0}}};
+            });
+        }
+        Blocks input(kSources, std::vector<Complex>(options.blockSize));
+        Blocks &output = workers == 1 ? serialOutput : parallelOutput;
+        for (std::size_t block = 0; block < 5; ++block) {
+            for (std::size_t source = 0; source < kSources; ++source) {
+                for (std::size_t n = 0; n < options.blockSize; ++n) {
+                    input[source][n] = sampleAt(block * options.blockSize + n + source * 31);
+                }
+            }
+            assert(stream.Process(input, output));
+        }
+        assert(stream.Statistics().linkBlocks == 5 * kLinks);
+        assert(stream.Statistics().droppedTaps >= 5 * kLinks);
+        allocations = stream.Buffers().Allocations();
+    }
+
+    assert(allocations <= 4);
+    assert(serialOutput.size() == kLinks);
+    for (std::size_t link = 0; link < kLinks; ++link) {
+        for (std::size_t n = 0; n < options.blockSize; ++n) {
+            assert(serialOutput[link][n] == parallelOutput[link][n]);
+        }
+    }
+}
+
+void testWorkerPoolRethrowsTaskExceptions() {
+    WorkerPool pool(4);
+    // Every index throws, so both the caller and the workers hit a failing task.
+    for (int round = 0; round < 20; ++round) {
+        bool caught = false;
+        try {
+            pool.ParallelFor(64, [](std::size_t index) {
+                throw std::runtime_error("task " + std::to_string(index));
+            });
+        } catch (const std::runtime_error &) {
+            caught = true;
+        }
+        assert(caught);
+    }
+
+    // The pool stays usable after a failed call.
+    std::atomic<std::size_t> sum{0};
+    pool.ParallelFor(100, [&sum](std::size_t index) { sum += index; });
+    assert(sum == 4950);
+}
+
+}  // namespace
+
+int main() {
+    testImpulseIsDelayedAndScaled();
+    testOverlapSaveMatchesDirectConvolution();
+    testFractionalDelayShiftsPhase();
+    testResponseChangesTakeEffectPerBlock();
+    testParallelLinksMatchSerial();
+    testWorkerPoolRethrowsTaskExceptions();
+    return 0;
+}
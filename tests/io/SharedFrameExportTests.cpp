@@ -0,0 +1,163 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "CoverageRaster.h"
+#include "rfmodel/io/SharedFrameExport.h"
+
+namespace {
+
+using rfmodel::engine::CoverageRaster;
+using rfmodel::engine::RasterGeometry;
+using rfmodel::io::FrameDataType;
+using rfmodel::io::FrameKind;
+using rfmodel::io::SharedFrameLayout;
+using rfmodel::io::SharedFrameReader;
+using rfmodel::io::SharedFrameView;
+using rfmodel::io::SharedFrameWriter;
+
+std::string regionPath(const std::string &name) {
+    return "/tmp/rfmodel-" + name + "-" + std::to_string(::getpid());
+}
+
+void testRasterRoundTrip() {
+    RasterGeometry geometry;
+    geometry.originX = -5.0;
+    geometry.originY = 2.0;
+    geometry.cellSizeMeters = 0.25;
+    geometry.columns = 7;
+    geometry.rows = 3;
+    CoverageRaster raster(geometry);
+    for (std::size_t row = 0; row < geometry.rows; ++row) {
+        for (std::size_t column = 0; column < geometry.columns; ++column) {
+            raster.Set(column, row, -40.0 - static_cast<double>(row * 10 + column));
+        }
+    }
+
+    const std::string path = regionPath("raster");
+    SharedFrameWriter writer(path, SharedFrameLayout::Raster(geometry, FrameDataType::Float64));
+    assert(writer.IsOpen());
+    SharedFrameReader reader(path);
+    assert(reader.IsOpen());
+    assert(reader.Header().kind == FrameKind::CoverageRaster);
+    assert(std::string(reader.Header().units) == "dBm");
+    assert(reader.Geometry().cellSizeMeters == 0.25 && reader.Geometry().originX == -5.0);
+
+    std::vector<double> values;
+    assert(reader.CopyLatest(values) == 0);
+    assert(writer.Publish(raster));
+    assert(reader.CopyLatest(values) == 1);
+    assert(values == raster.Values());
+
+    const bool consistent = reader.Read([&](const SharedFrameView &view) {
+        assert(view.At(4, 2) == raster.At(4, 2));
+    });
+    assert(consistent);
+    std::remove(path.c_str());
+}
+
+void testLinkMatrixConvertsToFloat() {
+    const std::string path = regionPath("links");
+    SharedFrameWriter writer(path, SharedFrameLayout::Links(2, 3));
+    assert(writer.IsOpen());
+    assert(!writer.Publish(std::vector<double>{1.0, 2.0}));
+    assert(writer.Publish(std::vector<double>{80.5, 91.25, 100.0, 60.0, 72.75, 120.5}));
+
+    SharedFrameReader reader(path);
+    assert(reader.Header().dataType == FrameDataType::Float32);
+    assert(std::string(reader.Header().units) == "dB");
+    std::vector<double> values;
+    assert(reader.CopyLatest(values) == 1);
+    assert(values[1] == 91.25 && values[5] == 120.5);
+    std::remove(path.c_str());
+}
+
+void testReadersNeverSeeTornFrames() {
+    // Every frame is filled with its frame number; a torn read would mix two values.
+    const std::size_t cells = 1 << 14;
+    const std::string path = regionPath("torn");
+    SharedFrameWriter writer(path, SharedFrameLayout::Links(1, cells, FrameDataType::Float64));
+    SharedFrameReader reader(path);
+    assert(writer.IsOpen() && reader.IsOpen());
+
+    std::atomic<bool> done{false};
+    std::thread producer([&]() {
+        for (int frame = 1; frame <= 2000; ++frame) {
+            auto *values = static_cast<double *>(writer.BeginFrame());
+            for (std::size_t cell = 0; cell < cells; ++cell) {
+                values[cell] = static_cast<double>(frame);
+            }
+            writer.CommitFrame();
+        }
+        done = true;
+    });
+
+    std::size_t checked = 0;
+    while (!done || checked == 0) {
+        bool uniform = true;
+        std::uint64_t frame = 0;
+        double first = 0.0;
+        const bool consistent = reader.Read([&](const SharedFrameView &view) {
+            first = view.At(0, 0);
+            uniform = true;
+            frame = view.frameNumber;
+            for (std::size_t cell = 1; cell < view.columns; ++cell) {
+                uniform = uniform && view.At(cell, 0) == first;
+            }
+        });
+        if (consistent && frame > 0) {
+            assert(uniform && first == static_cast<double>(frame));
+            ++checked;
+        }
+    }
+    producer.join();
+    assert(reader.FrameCount() == 2000);
+    std::remove(path.c_str());
+}
+
+void testWriterRestartKeepsReadersMapped() {
+    const std::string path = regionPath("restart");
+    SharedFrameReader *reader = nullptr;
+    {
+        SharedFrameWriter writer(path, SharedFrameLayout::Links(1, 4, FrameDataType::Float64));
+        assert(writer.Publish(std::vector<double>{1.0, 2.0, 3.0, 4.0}));
+        assert(writer.Publish(std::vector<double>{5.0, 6.0, 7.0, 8.0}));
+        static_cast<void>(writer.BeginFrame());  // Abandoned mid-write.
+        reader = new SharedFrameReader(path);
+    }
+
+    // Same layout: the region is reused in place and the frame count continues.
+    std::vector<double> values;
+    {
+        SharedFrameWriter writer(path, SharedFrameLayout::Links(1, 4, FrameDataType::Float64));
+        assert(writer.IsOpen());
+        assert(reader->CopyLatest(values) == 2 && values[0] == 5.0);
+        assert(writer.Publish(std::vector<double>{9.0, 10.0, 11.0, 12.0}));
+        assert(reader->CopyLatest(values) == 3 && values[3] == 12.0);
+    }
+
+    // Smaller layout: the file is not truncated under the reader, which reports the change.
+    SharedFrameWriter writer(path, SharedFrameLayout::Links(1, 2, FrameDataType::Float64));
+    assert(writer.Publish(std::vector<double>{13.0, 14.0}));
+    assert(!reader->Read([](const SharedFrameView &) { assert(false); }));
+    delete reader;
+    SharedFrameReader reopened(path);
+    assert(reopened.CopyLatest(values) == 1 && values == (std::vector<double>{13.0, 14.0}));
+    std::remove(path.c_str());
+}
+
+}  // namespace
+
+int main() {
+    testRasterRoundTrip();
+    testLinkMatrixConvertsToFloat();
+    testReadersNeverSeeTornFrames();
+    testWriterRestartKeepsReadersMapped();
+    return 0;
+}
@@ -0,0 +1,247 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CoverageRaster.h"
+#include "ScalarPrecision.h"
+#include "TransmitterState.h"
+#include "rfmodel/io/TiledRasterStore.h"
+
+namespace {
+
+using rfmodel::engine::CoverageRasterf;
+using rfmodel::engine::RasterGeometry;
+using rfmodel::engine::ScalarPrecision;
+using rfmodel::engine::TransmitterState;
+using rfmodel::io::MakeCoverageTileGenerator;
+using rfmodel::io::TiledRasterOptions;
+using rfmodel::io::TiledRasterStore;
+
+const char *const kSpillPath = "rfmodel-tiled-raster-test.tiles";
+
+// A plane is reproduced exactly by averaging, which makes pyramid levels easy to check.
+double plane(double x, double y) {
+    return -40.0 + 0.5 * x - 0.25 * y;
+}
+
+void fillPlane(const RasterGeometry &geometry, CoverageRasterf &tile) {
+    tile = CoverageRasterf(geometry);
+    for (std::size_t row = 0; row < geometry.rows; ++row) {
+        for (std::size_t column = 0; column < geometry.columns; ++column) {
+            tile.Set(column, row,
+                     static_cast<float>(plane(geometry.CellCenterX(column),
+                                              geometry.CellCenterY(row))));
+        }
+    }
+}
+
+RasterGeometry makeSite() {
+    RasterGeometry geometry;
+    geometry.originX = -20.0;
+    geometry.originY = 5.0;
+    geometry.cellSizeMeters = 0.1;
+    geometry.columns = 1000;
+    geometry.rows = 700;
+    return geometry;
+}
+
+void testBoundedCacheSpillsAndReloads() {
+    const RasterGeometry site = makeSite();
+    TiledRasterOptions options;
+    options.tileSize = 64;
+    options.maxCachedTiles = 8;
+    options.spillPath = kSpillPath;
+    TiledRasterStore store(site, fillPlane, options);
+    assert(store.IsOpen());
+    assert(store.LevelCount() == 5);
+    assert(store.TileColumns(0) == 16 && store.TileRows(0) == 11);
+
+    // Pan across the whole site twice in strips of one tile row.
+    for (std::size_t pass = 0; pass < 2; ++pass) {
+        for (std::size_t firstRow = 0; firstRow < site.rows; firstRow += 64) {
+            const CoverageRasterf strip = store.ReadRegion(0, 0, firstRow, site.columns, 64);
+            assert(store.CachedTiles() <= options.maxCachedTiles);
+            for (std::size_t row = 0; row < 64; ++row) {
+                for (std::size_t column = 0; column < site.columns; column += 97) {
+                    const float value = strip.At(column, row);
+                    if (firstRow + row >= site.rows) {
+                        assert(std::isnan(value));
+                        continue;
+                    }
+                    const double expected = plane(site.CellCenterX(column),
+                                                  site.CellCenterY(firstRow + row));
+                    assert(std::abs(value - expected) < 1e-3);
+                }
+            }
+        }
+    }
+    const auto statistics = store.Statistics();
+    assert(statistics.generated == store.TileColumns(0) * store.TileRows(0));
+    assert(statistics.spilled > 0);
+    assert(statistics.reloaded > 0);
+
+    std::ifstream spill(kSpillPath, std::ios::binary | std::ios::ate);
+    assert(spill && static_cast<std::size_t>(spill.tellg()) >=
+                        statistics.spilled * 64 * 64 * sizeof(float));
+}
+
+void testPyramidAveragesFinerLevels() {
+    const RasterGeometry site = makeSite();
+    TiledRasterOptions options;
+    options.tileSize = 64;
+    options.maxCachedTiles = 4;
+    options.averageCoarseLevels = true;
+    TiledRasterStore store(site, fillPlane, options);
+
+    const std::size_t top = store.LevelCount() - 1;
+    const RasterGeometry coarse = store.LevelGeometry(top);
+    assert(coarse.columns <= 64 && coarse.rows <= 64);
+    assert(std::abs(coarse.cellSizeMeters - 1.6) < 1e-12);
+    assert(store.LevelForCellSize(2.0) == top);
+    assert(store.LevelForCellSize(0.3) == 1);
+    assert(store.LevelForCellSize(0.05) == 0);
+
+    const RasterGeometry level1 = store.LevelGeometry(1);
+    for (std::size_t row = 0; row < level1.rows; row += 41) {
+        for (std::size_t column = 0; column < level1.columns; column += 37) {
+            const double expected = plane(level1.CellCenterX(column), level1.CellCenterY(row));
+            assert(std::abs(store.Sample(1, column, row) - expected) < 1e-3);
+        }
+    }
+    for (std::size_t row = 0; row + 1 < coarse.rows; row += 5) {
+        for (std::size_t column = 0; column + 1 < coarse.columns; column += 5) {
+            const double expected = plane(coarse.CellCenterX(column), coarse.CellCenterY(row));
+            assert(std::abs(store.Sample(top, column, row) - expected) < 1e-3);
+        }
+    }
+    assert(std::isnan(store.Sample(0, site.columns + 5, 0)));
+    assert(store.GetTile(top, 1, 0) == nullptr);
+    assert(store.CachedTiles() <= options.maxCachedTiles);
+}
+
+void testCoarseTilesCostOneGeneratorCall() {
+    const RasterGeometry site = makeSite();
+    TiledRasterOptions options;
+    options.tileSize = 64;
+    double generatedCellSize = 0.0;
+    TiledRasterStore store(
+        site,
+        [&](const RasterGeometry &geometry, CoverageRasterf &tile) {
+            generatedCellSize = geometry.cellSizeMeters;
+            fillPlane(geometry, tile);
+        },
+        options);
+
+    const std::size_t top = store.LevelCount() - 1;
+    assert(store.GetTile(top, 0, 0) != nullptr);
+    assert(store.Statistics().generated == 1 && store.Statistics().reduced == 0);
+    assert(std::abs(generatedCellSize - 1.6) < 1e-12);
+    const RasterGeometry coarse = store.LevelGeometry(top);
+    for (std::size_t row = 0; row < coarse.rows; row += 7) {
+        for (std::size_t column = 0; column < coarse.columns; column += 7) {
+            const double expected = plane(coarse.CellCenterX(column), coarse.CellCenterY(row));
+            assert(std::abs(store.Sample(top, column, row) - expected) < 1e-3);
+        }
+    }
+}
+
+void testTilesAreGeneratedOutsideTheLock() {
+    // The generator of tile (0, 0) waits for another thread to fetch tile (1, 0), which
+    // only finishes in time when generation does not hold the store's lock.
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool otherTileFetched = false;
+    bool sawOtherTile = false;
+    std::atomic<int> firstTileCalls{0};
+    TiledRasterOptions options;
+    options.tileSize = 64;
+    TiledRasterStore store(
+        makeSite(),
+        [&](const RasterGeometry &geometry, CoverageRasterf &tile) {
+            if (geometry.originX == -20.0 && geometry.originY == 5.0 &&
+                geometry.cellSizeMeters == 0.1) {
+                ++firstTileCalls;
+                std::unique_lock<std::mutex> lock(mutex);
+                sawOtherTile = changed.wait_for(lock, std::chrono::seconds(2),
+                                                [&] { return otherTileFetched; });
+            }
+            fillPlane(geometry, tile);
+        },
+        options);
+
+    std::vector<std::thread> sameTile;
+    for (int reader = 0; reader < 3; ++reader) {
+        sameTile.emplace_back([&] { assert(store.GetTile(0, 0, 0) != nullptr); });
+    }
+    std::thread otherTile([&] {
+        while (firstTileCalls == 0) {
+            std::this_thread::yield();
+        }
+        assert(store.GetTile(0, 1, 0) != nullptr);
+        const std::lock_guard<std::mutex> lock(mutex);
+        otherTileFetched = true;
+        changed.notify_all();
+    });
+    otherTile.join();
+    for (std::thread &thread : sameTile) {
+        thread.join();
+    }
+    assert(sawOtherTile);
+    assert(firstTileCalls == 1);
+    assert(store.Statistics().generated == 2);
+}
+
+void testCoverageGeneratorMatchesKernel() {
+    TransmitterState transmitter;
+    transmitter.positionMeters = {10.0, 10.0, 2.0};
+    transmitter.powerDbm = 20.0;
+    const std::vector<TransmitterState> transmitters{transmitter};
+    RasterGeometry site;
+    site.cellSizeMeters = 0.5;
+    site.columns = 90;
+    site.rows = 50;
+    TiledRasterOptions options;
+    options.tileSize = 32;
+    options.maxCachedTiles = 2;
+    TiledRasterStore store(site,
+                           MakeCoverageTileGenerator(ScalarPrecision::Double, transmitters, 1.0),
+                           options);
+    const auto whole =
+        rfmodel::engine::EvaluateCoveragePowerDbm(ScalarPrecision::Double, transmitters, site, 1.0);
+    const CoverageRasterf region = store.ReadRegion(0, 0, 0, site.columns, site.rows);
+    for (std::size_t row = 0; row < site.rows; ++row) {
+        for (std::size_t column = 0; column < site.columns; ++column) {
+            assert(std::abs(region.At(column, row) - whole.At(column, row)) < 1e-3);
+        }
+    }
+}
+
+void testUnwritableSpillPathIsReported() {
+    TiledRasterOptions options;
+    options.spillPath = "/nonexistent-directory/tiles.bin";
+    TiledRasterStore store(makeSite(), fillPlane, options);
+    assert(!store.IsOpen());
+    assert(!store.Error().empty());
+    assert(std::abs(store.Sample(0, 0, 0) - plane(-19.95, 5.05)) < 1e-3);
+}
+
+}  // namespace
+
+int main() {
+    testBoundedCacheSpillsAndReloads();
+    std::remove(kSpillPath);
+    testPyramidAveragesFinerLevels();
+    testCoarseTilesCostOneGeneratorCall();
+    testTilesAreGeneratedOutsideTheLock();
+    testCoverageGeneratorMatchesKernel();
+    testUnwritableSpillPathIsReported();
+    return 0;
+}
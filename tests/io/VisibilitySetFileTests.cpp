@@ -0,0 +1,97 @@
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "PotentiallyVisibleSet.h"
+#include "WallGeometry.h"
+#include "rfmodel/io/VisibilitySetFile.h"
+
+namespace {
+
+using rfmodel::engine::MakeWallSegment;
+using rfmodel::engine::PotentiallyVisibleSet;
+using rfmodel::engine::WallIndex;
+using rfmodel::engine::WallSegment;
+using rfmodel::io::ReadVisibilitySet;
+using rfmodel::io::WriteVisibilitySet;
+using rfmodel::math::Vec2d;
+
+const char *const kPath = "rfmodel-visibility-set-test.pvs";
+
+std::vector<WallSegment> makeCorridor() {
+    return {MakeWallSegment(Vec2d{0.0, 0.0}, Vec2d{12.0, 0.0}),
+            MakeWallSegment(Vec2d{0.0, 4.0}, Vec2d{12.0, 4.0}),
+            MakeWallSegment(Vec2d{4.0, 0.0}, Vec2d{4.0, 4.0}),
+            MakeWallSegment(Vec2d{8.0, 0.0}, Vec2d{8.0, 4.0})};
+}
+
+void testRoundTrip() {
+    const std::vector<WallSegment> walls = makeCorridor();
+    const WallIndex index(walls, 1.0);
+    const PotentiallyVisibleSet built = PotentiallyVisibleSet::Build(index, 0);
+    std::string error;
+    assert(WriteVisibilitySet(kPath, built, &error));
+
+    const auto loaded = ReadVisibilitySet(kPath, index, &error);
+    assert(loaded.has_value());
+    assert(loaded->TransmissionDepth() == 0);
+    assert(loaded->CellBits() == built.CellBits());
+    for (std::size_t from = 0; from < walls.size(); ++from) {
+        for (std::size_t to = 0; to < walls.size(); ++to) {
+            assert(loaded->WallSees(from, to) == built.WallSees(from, to));
+        }
+    }
+}
+
+void testFileIsLittleEndian() {
+    const std::vector<WallSegment> walls = makeCorridor();
+    const WallIndex index(walls, 1.0);
+    const PotentiallyVisibleSet built = PotentiallyVisibleSet::Build(index, 2);
+    assert(WriteVisibilitySet(kPath, built));
+
+    std::ifstream stream(kPath, std::ios::binary);
+    const std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(stream)),
+                                           std::istreambuf_iterator<char>());
+    const std::size_t words = built.CellBits().size();
+    assert(bytes.size() == rfmodel::io::kVisibilitySetHeaderBytes + 8 * words);
+    // Version 1, then transmission depth 2, each as four little-endian bytes.
+    assert(bytes[8] == 1 && bytes[9] == 0 && bytes[10] == 0 && bytes[11] == 0);
+    assert(bytes[12] == 2 && bytes[13] == 0 && bytes[14] == 0 && bytes[15] == 0);
+    assert(bytes[24] == index.CellCount() % 256 && bytes[31] == 0);
+    const std::uint64_t first = built.CellBits().front();
+    for (std::size_t byte = 0; byte < 8; ++byte) {
+        assert(bytes[rfmodel::io::kVisibilitySetHeaderBytes + byte] ==
+               static_cast<unsigned char>(first >> (8 * byte)));
+    }
+}
+
+void testRejectsOtherFloorplan() {
+    const std::vector<WallSegment> walls = makeCorridor();
+    const WallIndex index(walls, 1.0);
+    assert(WriteVisibilitySet(kPath, PotentiallyVisibleSet::Build(index, 1)));
+
+    std::vector<WallSegment> moved = walls;
+    moved[3] = MakeWallSegment(Vec2d{9.0, 0.0}, Vec2d{9.0, 4.0});
+    const WallIndex movedIndex(moved, 1.0);
+    std::string error;
+    assert(!ReadVisibilitySet(kPath, movedIndex, &error).has_value());
+    assert(error.find("different floorplan") != std::string::npos);
+
+    assert(!ReadVisibilitySet("rfmodel-missing.pvs", index, &error).has_value());
+    assert(!error.empty());
+}
+
+}  // namespace
+
+int main() {
+    testRoundTrip();
+    testFileIsLittleEndian();
+    testRejectsOtherFloorplan();
+    std::remove(kPath);
+    return 0;
+}
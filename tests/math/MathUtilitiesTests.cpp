@@ -1,8 +1,11 @@
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 #include "rfmodel/math/Complex.h"
 #include "rfmodel/math/Decibel.h"
+#include "rfmodel/math/Fft.h"
 #include "rfmodel/math/Vec2.h"
 #include "rfmodel/math/Vec3.h"
 
@@ -74,6 +77,18 @@ void testComplex() {
 
     Complex polar = Complex::fromPolar(2.0, std::atan2(1.0, 1.0));
     assert(std::abs(polar.magnitude() - 2.0) < kTolerance);
+
+    Complex root = rfmodel::math::sqrt(Complex{-4.0, 0.0});
+    assert(std::abs(root.real) < kTolerance);
+    assert(std::abs(root.imag - 2.0) < kTolerance);
+
+    Complex squared = rfmodel::math::sqrt(b) * rfmodel::math::sqrt(b);
+    assert(std::abs(squared.real - b.real) < kTolerance);
+    assert(std::abs(squared.imag - b.imag) < kTolerance);
+
+    Complex unit = rfmodel::math::exp(Complex{0.0, std::atan2(1.0, 0.0)});
+    assert(std::abs(unit.real) < kTolerance);
+    assert(std::abs(unit.imag - 1.0) < kTolerance);
 }
 
 void testDecibelConversions() {
@@ -90,6 +105,40 @@ void testDecibelConversions() {
     assert(std::abs(recovered_power - power) < kTolerance);
 }
 
+void testFft() {
+    using namespace rfmodel::math;
+
+    assert(isPowerOfTwo(64));
+    assert(!isPowerOfTwo(48));
+    assert(nextPowerOfTwo(48) == 64);
+    assert(nextPowerOfTwo(1) == 1);
+
+    FftPlan plan(16);
+    assert(plan.size() == 16);
+
+    std::vector<Complex> signal(plan.size());
+    for (std::size_t n = 0; n < signal.size(); ++n) {
+        signal[n] = Complex{std::cos(0.3 * n) + 0.1 * n, std::sin(1.7 * n)};
+    }
+
+    std::vector<Complex> spectrum = signal;
+    plan.forward(spectrum.data());
+    for (std::size_t k = 0; k < signal.size(); ++k) {
+        Complex expected;
+        for (std::size_t n = 0; n < signal.size(); ++n) {
+            expected += signal[n] * Complex::fromPolar(1.0, -kTwoPi * k * n / signal.size());
+        }
+        assert(std::abs(spectrum[k].real - expected.real) < 1e-9);
+        assert(std::abs(spectrum[k].imag - expected.imag) < 1e-9);
+    }
+
+    plan.inverse(spectrum.data());
+    for (std::size_t n = 0; n < signal.size(); ++n) {
+        assert(std::abs(spectrum[n].real - signal[n].real) < kTolerance);
+        assert(std::abs(spectrum[n].imag - signal[n].imag) < kTolerance);
+    }
+}
+
 }  // namespace
 
 int main() {
@@ -97,5 +146,6 @@ int main() {
     testVec3();
     testComplex();
     testDecibelConversions();
+    testFft();
     return 0;
 }